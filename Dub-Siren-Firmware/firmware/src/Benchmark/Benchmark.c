@@ -0,0 +1,818 @@
+/**
+ * @file Benchmark.c
+ * @author Seb Madgwick
+ * @brief On-target DSP benchmarks.
+ *
+ * Each benchmark runs a DSP kernel for a fixed number of samples and prints the
+ * number of CPU cycles per sample.  The core timer increments at half the
+ * system clock frequency.  The per-sample budget at 96 kHz is 2625 cycles.
+ *
+ * The accuracy of fast math approximations is also measured against
+ * double-precision libm.  Q31 arithmetic is checked for bit-exactness against
+ * the C reference implementation.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Benchmark.h"
+
+#ifdef BENCHMARK_ENABLED
+
+#include "Convolution/Convolution.h"
+#include "Dac/Dac.h"
+#include "FastMath/FastMath.h"
+#include "Filters/CascadeFilter.h"
+#include "Filters/CascadeFilterQ31.h"
+#include "FixedPoint/Q31.h"
+#include "Fpu/Fpu.h"
+#include <math.h>
+#include "MathHelpers.h"
+#include "ModulationEffects/ModulationEffects.h"
+#include "Random/Random.h"
+#include "Reverb/Reverb.h"
+#include "Saturation/Saturation.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h> // snprintf
+#include <string.h> // strlen
+#include "Synthesiser/Echo.h"
+#include "Synthesiser/Lfo.h"
+#include "Synthesiser/Vco.h"
+#include "Synthesiser/Waveforms.h"
+#include "Synthesiser/Wavetable.h"
+#include "Uart/Uart1.h"
+#include <xc.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Number of points tested by each accuracy measurement.
+ */
+#define NUMBER_OF_ACCURACY_POINTS (10000)
+
+/**
+ * @brief CPU cycles per sample available to the VCO unison stack.  A quarter
+ * of the per-sample budget, leaving the remainder for the delay, filters and
+ * effects.
+ */
+#define UNISON_CYCLE_BUDGET (2625 / 4)
+
+/**
+ * @brief Defines a kernel that evaluates a math function once per sample for
+ * inputs swept from x0 in increments of dx.
+ */
+#define MATH_KERNEL(kernelName, x0, dx, expression) \
+    static void kernelName(const unsigned int numberOfSamples) { \
+        float x = (x0); \
+        float sum = 0.0f; \
+        unsigned int index; \
+        for (index = 0; index < numberOfSamples; index++) { \
+            sum += (expression); \
+            x += (dx); \
+        } \
+        sink = sum; \
+    }
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static unsigned int Measure(const char* const name, void (*kernel)(const unsigned int numberOfSamples));
+static void Print(const char* const string);
+static void UnprotectedTail(const unsigned int numberOfSamples);
+static void CascadeFilterTail(const unsigned int numberOfSamples);
+static void LfoKernel(const unsigned int numberOfSamples);
+static void VcoKernel(const unsigned int numberOfSamples);
+#ifdef WAVETABLE_ENABLED
+static void WavetableKernel(const unsigned int numberOfSamples);
+#endif
+static void CascadeFilterKernel(const unsigned int numberOfSamples);
+static void CascadeFilterQ31Kernel(const unsigned int numberOfSamples);
+static void DelayMixKernel(const unsigned int numberOfSamples);
+static void DelayMixQ31Kernel(const unsigned int numberOfSamples);
+static void EchoKernel(const unsigned int numberOfSamples);
+static void SoftClipKernel(const unsigned int numberOfSamples);
+#ifdef MODULATION_EFFECTS_ENABLED
+static void ModulationEffectsKernel(const unsigned int numberOfSamples);
+#endif
+#ifdef REVERB_ENABLED
+static void ReverbKernel(const unsigned int numberOfSamples);
+#endif
+#ifdef CONVOLUTION_ENABLED
+static void ConvolutionKernel(const unsigned int numberOfSamples);
+#endif
+static void OversampledSoftClipKernel(const unsigned int numberOfSamples);
+static void LimiterKernel(const unsigned int numberOfSamples);
+static void OutputPerSampleKernel(const unsigned int numberOfSamples);
+static void OutputPerSampleQ31Kernel(const unsigned int numberOfSamples);
+static void OutputBlockKernel(const unsigned int numberOfSamples);
+static void OutputBlockQ31Kernel(const unsigned int numberOfSamples);
+static void FillBuffers();
+static void CheckQ31();
+static void MeasureAccuracy(const char* const name, float (*fastFunction)(const float x), double (*referenceFunction)(double x), const double minimum, const double maximum, const bool relative);
+static float Exp2(const float x);
+static float Log2(const float x);
+static float Sin(const float x);
+static float Tan(const float x);
+static float Tanh(const float x);
+static double ReferenceExp2(double x);
+static double ReferenceLog2(double x);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static volatile float sink; // prevents kernel results being optimised away
+static Lfo lfo;
+static Vco vco;
+static Echo echo;
+static volatile q31 sinkQ31;
+static float floatBuffer[BENCHMARK_NUMBER_OF_SAMPLES];
+static q31 q31Buffer[BENCHMARK_NUMBER_OF_SAMPLES];
+static Random benchmarkRandom = {.state = 1};
+
+//------------------------------------------------------------------------------
+// Kernels
+
+MATH_KERNEL(Exp2Libm, -10.0f, 0.002f, powf(2.0f, x))
+MATH_KERNEL(Exp2Fast, -10.0f, 0.002f, FastMathExp2(x))
+MATH_KERNEL(Log2Libm, 0.01f, 0.01f, logf(x) * (float) (1.0 / M_LN2))
+MATH_KERNEL(Log2Fast, 0.01f, 0.01f, FastMathLog2(x))
+MATH_KERNEL(SinLibm, -3.0f, 0.0006f, sinf(x))
+MATH_KERNEL(SinFast, -3.0f, 0.0006f, FastMathSin(x))
+MATH_KERNEL(TanLibm, 0.0f, 0.00015f, tanf(x))
+MATH_KERNEL(TanFast, 0.0f, 0.00015f, FastMathTan(x))
+MATH_KERNEL(TanhLibm, -5.0f, 0.001f, tanhf(x))
+MATH_KERNEL(TanhFast, -5.0f, 0.001f, FastMathTanh(x))
+MATH_KERNEL(ReciprocalDivision, 0.5f, 0.001f, 1.0f / x)
+MATH_KERNEL(ReciprocalFast, 0.5f, 0.001f, FastMathReciprocal(x))
+MATH_KERNEL(FloorLibm, -50.0f, 0.01f, floorf(x))
+MATH_KERNEL(FloorFast, -50.0f, 0.01f, (float) FastMathFloorToInt(x))
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Runs all benchmarks and prints results.  This function blocks until
+ * all results have been written to the UART write buffer.
+ */
+void BenchmarkRun() {
+    Print("\r\nBENCHMARK (cycles per sample):\r\n");
+
+    // Subnormal handling
+    const bool flushToZero = FpuGetFlushToZero();
+    FpuSetFlushToZero(false);
+    Measure("Unprotected tail, FS off", &UnprotectedTail);
+    Measure("CascadeFilter tail, FS off", &CascadeFilterTail);
+    FpuSetFlushToZero(true);
+    Measure("Unprotected tail, FS on", &UnprotectedTail);
+    Measure("CascadeFilter tail, FS on", &CascadeFilterTail);
+    FpuSetFlushToZero(flushToZero);
+
+    // Fast math
+    Measure("exp2, powf", &Exp2Libm);
+    Measure("exp2, FastMathExp2", &Exp2Fast);
+    Measure("log2, logf", &Log2Libm);
+    Measure("log2, FastMathLog2", &Log2Fast);
+    Measure("sin, sinf", &SinLibm);
+    Measure("sin, FastMathSin", &SinFast);
+    Measure("tan, tanf", &TanLibm);
+    Measure("tan, FastMathTan", &TanFast);
+    Measure("tanh, tanhf", &TanhLibm);
+    Measure("tanh, FastMathTanh", &TanhFast);
+    Measure("reciprocal, division", &ReciprocalDivision);
+    Measure("reciprocal, FastMathReciprocal", &ReciprocalFast);
+    Measure("floor, floorf", &FloorLibm);
+    Measure("floor, FastMathFloorToInt", &FloorFast);
+
+    // LFO waveforms
+    static const char* const lfoWaveformNames[LfoWaveformNumberOfWaveforms] = {
+        "LFO sine",
+        "LFO triangle",
+        "LFO sawtooth",
+        "LFO square",
+        "LFO stepped triangle",
+        "LFO stepped sawtooth",
+        "LFO sample and hold",
+        "LFO smooth random",
+    };
+    LfoInitialise(&lfo, 0);
+    LfoWaveform lfoWaveform;
+    for (lfoWaveform = 0; lfoWaveform < LfoWaveformNumberOfWaveforms; lfoWaveform++) {
+        LfoSetShape(&lfo, lfoWaveform, 0.3f);
+        Measure(lfoWaveformNames[lfoWaveform], &LfoKernel);
+    }
+
+    // VCO 2 modulations, compared to VCO 1 alone
+    static const char* const vcoModulationNames[VcoModulationNumberOfModulations] = {
+        "VCO mix",
+        "VCO FM",
+        "VCO sync",
+        "VCO ring",
+    };
+    VcoInitialise(&vco);
+    Measure("VCO single", &VcoKernel);
+    VcoModulation vcoModulation;
+    for (vcoModulation = 0; vcoModulation < VcoModulationNumberOfModulations; vcoModulation++) {
+        const Vco2Parameters vco2Parameters = {
+            .modulation = vcoModulation,
+            .waveform = VcoWaveformSawtooth,
+            .ratio = 1.51f,
+            .amount = 0.5f,
+        };
+        VcoSetVco2Parameters(&vco, &vco2Parameters);
+        Measure(vcoModulationNames[vcoModulation], &VcoKernel);
+    }
+
+    // Unison for each number of voices
+    VcoSetVco2Parameters(&vco, &defaultVco2Parameters);
+    unsigned int maximumNumberOfUnisonVoices = 0;
+    unsigned int numberOfUnisonVoices;
+    for (numberOfUnisonVoices = 1; numberOfUnisonVoices <= UNISON_MAXIMUM_NUMBER_OF_VOICES; numberOfUnisonVoices++) {
+        const UnisonParameters unisonParameters = {
+            .numberOfVoices = numberOfUnisonVoices,
+            .spread = 20.0f,
+            .mix = 0.5f,
+        };
+        VcoSetUnisonParameters(&vco, &unisonParameters);
+        char name[32];
+        snprintf(name, sizeof (name), "VCO unison, %u voices", numberOfUnisonVoices);
+        if ((Measure(name, &VcoKernel) <= UNISON_CYCLE_BUDGET) && (maximumNumberOfUnisonVoices == (numberOfUnisonVoices - 1))) {
+            maximumNumberOfUnisonVoices = numberOfUnisonVoices;
+        }
+    }
+    VcoSetUnisonParameters(&vco, &defaultUnisonParameters);
+    char unisonString[64];
+    snprintf(unisonString, sizeof (unisonString), "%-32s %5u\r\n", "VCO unison maximum voices", maximumNumberOfUnisonVoices);
+    Print(unisonString);
+
+    // Wavetable
+#ifdef WAVETABLE_ENABLED
+    WavetableInitialise();
+    Measure("Wavetable", &WavetableKernel);
+    char wavetableString[96];
+    snprintf(wavetableString, sizeof (wavetableString), "%-32s %5u bytes (delay reduced by %u ms)\r\n", "Wavetable RAM", WAVETABLE_RAM_SIZE, (unsigned int) ((1000 * (WAVETABLE_RAM_SIZE / 4)) / (unsigned int) SAMPLE_FREQUENCY));
+    Print(wavetableString);
+#endif
+
+    // Float and Q31
+    FillBuffers();
+    Measure("Cascade filter x3, float", &CascadeFilterKernel);
+    Measure("Cascade filter x3, Q31", &CascadeFilterQ31Kernel);
+    Measure("Delay mix, float", &DelayMixKernel);
+    Measure("Delay mix, Q31", &DelayMixQ31Kernel);
+
+    // Echo models
+    const char* const delayModelNames[DelayModelNumberOfModels] = {
+        "Echo digital",
+        "Echo tape",
+        "Echo BBD",
+    };
+    FillBuffers();
+    DelayModel delayModel;
+    for (delayModel = 0; delayModel < DelayModelNumberOfModels; delayModel++) {
+        EchoInitialise(&echo, delayModel);
+        Measure(delayModelNames[delayModel], &EchoKernel);
+    }
+
+    // Saturation
+    FillBuffers();
+    Measure("Soft clip", &SoftClipKernel);
+    Measure("Soft clip, 2x oversampled", &OversampledSoftClipKernel);
+    Measure("Output limiter", &LimiterKernel);
+
+    // Modulation effects
+#ifdef MODULATION_EFFECTS_ENABLED
+    static const char* const effectNames[ModulationEffectNumberOfEffects] = {
+        "Modulation effect, off",
+        "Modulation effect, chorus",
+        "Modulation effect, flanger",
+        "Modulation effect, phaser",
+    };
+    ModulationEffect effect;
+    for (effect = 0; effect < ModulationEffectNumberOfEffects; effect++) {
+        FillBuffers();
+        ModulationEffectsSetEffect(effect);
+        ModulationEffectsProcess(floatBuffer, DAC_BLOCK_SIZE); // apply effect change before measurement
+        Measure(effectNames[effect], &ModulationEffectsKernel);
+    }
+    ModulationEffectsSetEffect(ModulationEffectOff);
+#endif
+
+    // Reverb
+#ifdef REVERB_ENABLED
+    FillBuffers();
+    ReverbInitialise();
+    Measure("Reverb", &ReverbKernel);
+    char string[96];
+    snprintf(string, sizeof (string), "%-32s %5u bytes (delay reduced by %u ms)\r\n", "Reverb RAM", REVERB_RAM_SIZE, (unsigned int) ((1000 * (REVERB_RAM_SIZE / 4)) / (unsigned int) SAMPLE_FREQUENCY));
+    Print(string);
+#endif
+
+    // Convolution for each impulse response length
+#ifdef CONVOLUTION_ENABLED
+    ConvolutionInitialise();
+    unsigned int impulseResponseLength;
+    for (impulseResponseLength = 32; impulseResponseLength <= CONVOLUTION_MAXIMUM_LENGTH; impulseResponseLength *= 2) {
+        ConvolutionLoadBegin(impulseResponseLength);
+        unsigned int tap;
+        for (tap = 0; tap < impulseResponseLength; tap++) {
+            ConvolutionLoadTap(RandomNextFloat(&benchmarkRandom) * 0.01f);
+        }
+        ConvolutionLoadEnd();
+        FillBuffers();
+        char name[32];
+        snprintf(name, sizeof (name), "Convolution, %u taps", impulseResponseLength);
+        Measure(name, &ConvolutionKernel);
+    }
+    ConvolutionDisable();
+#endif
+
+    // Output conversion
+    FillBuffers();
+    Measure("Output per sample, float", &OutputPerSampleKernel);
+    Measure("Output per sample, Q31", &OutputPerSampleQ31Kernel);
+    DacSetDither(false);
+    DacSetSoftKnee(false);
+    Measure("Output block, float", &OutputBlockKernel);
+    Measure("Output block, Q31", &OutputBlockQ31Kernel);
+    DacSetDither(true);
+    DacSetSoftKnee(true);
+    Measure("Output block dither knee, float", &OutputBlockKernel);
+    Measure("Output block dither knee, Q31", &OutputBlockQ31Kernel);
+
+    // Fast math accuracy
+    Print("\r\nACCURACY (maximum error against reference):\r\n");
+    MeasureAccuracy("FastMathExp2 (relative)", &Exp2, &ReferenceExp2, -125.0, 127.0, true);
+    MeasureAccuracy("FastMathLog2", &Log2, &ReferenceLog2, 0.5, 2.0, false);
+    MeasureAccuracy("FastMathSin", &Sin, &sin, -2.0 * M_PI, 2.0 * M_PI, false);
+    MeasureAccuracy("FastMathTan (relative)", &Tan, &tan, 1e-3, 1.5, true);
+    MeasureAccuracy("FastMathTanh", &Tanh, &tanh, -10.0, 10.0, false);
+    CheckQ31();
+}
+
+/**
+ * @brief Measures and prints the number of cycles per sample for a kernel.
+ * @param name Benchmark name.
+ * @param kernel Kernel function.
+ * @return Number of cycles per sample.
+ */
+static unsigned int Measure(const char* const name, void (*kernel)(const unsigned int numberOfSamples)) {
+    const uint32_t startCount = _CP0_GET_COUNT();
+    kernel(BENCHMARK_NUMBER_OF_SAMPLES);
+    const uint32_t coreTimerTicks = _CP0_GET_COUNT() - startCount;
+    const unsigned int cyclesPerSample = (unsigned int) ((2 * coreTimerTicks) / BENCHMARK_NUMBER_OF_SAMPLES);
+    char string[64];
+    snprintf(string, sizeof (string), "%-32s %5u\r\n", name, cyclesPerSample);
+    Print(string);
+    return cyclesPerSample;
+}
+
+/**
+ * @brief Writes string to UART, waiting for space in the write buffer.
+ * @param string String to write.
+ */
+static void Print(const char* const string) {
+    while (Uart1IsWriteReady() < strlen(string));
+    Uart1WriteString(string);
+}
+
+/**
+ * @brief Recursive decay without quantise-to-zero protection.  The state is
+ * subnormal for most of the benchmark.
+ * @param numberOfSamples Number of samples.
+ */
+static void UnprotectedTail(const unsigned int numberOfSamples) {
+    float state = 1e-37f;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        state *= 0.999f;
+    }
+    sink = state;
+}
+
+/**
+ * @brief Decaying impulse response of the delay feedback filter.  The response
+ * falls below QUANTISE_TO_ZERO_THRESHOLD after approximately 600 samples and
+ * would be subnormal after approximately 1500 samples without quantise-to-zero
+ * protection.
+ * @param numberOfSamples Number of samples.
+ */
+static void CascadeFilterTail(const unsigned int numberOfSamples) {
+    CascadeFilter cascadeFilter = {0};
+    CascadeFilterSetCornerFrequency(&cascadeFilter, 1000.0f, SAMPLE_FREQUENCY, false, 3);
+    float output = CascadeFilterUpdate(&cascadeFilter, 1.0f);
+    unsigned int index;
+    for (index = 1; index < numberOfSamples; index++) {
+        output = CascadeFilterUpdate(&cascadeFilter, 0.0f);
+    }
+    sink = output;
+}
+
+/**
+ * @brief LFO waveform evaluated for one period.
+ * @param numberOfSamples Number of samples.
+ */
+static void LfoKernel(const unsigned int numberOfSamples) {
+    const float normalisedPeriodIncrement = 1.0f / (float) numberOfSamples;
+    float normalisedPeriod = 0.0f;
+    float sum = 0.0f;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        sum += LfoGetAmplitude(&lfo, normalisedPeriod);
+        normalisedPeriod += normalisedPeriodIncrement;
+    }
+    sink = sum;
+}
+
+/**
+ * @brief Band-limited sawtooth VCO at 440 Hz.
+ * @param numberOfSamples Number of samples.
+ */
+static void VcoKernel(const unsigned int numberOfSamples) {
+    float sum = 0.0f;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        sum += VcoUpdate(&vco, VcoWaveformSawtooth, 440.0f, 0.0f, 0.0f);
+    }
+    sink = sum;
+}
+
+#ifdef WAVETABLE_ENABLED
+
+/**
+ * @brief Wavetable at 440 Hz with the position swept across all tables.
+ * @param numberOfSamples Number of samples.
+ */
+static void WavetableKernel(const unsigned int numberOfSamples) {
+    const float increment = (1.0f / SAMPLE_FREQUENCY) * 440.0f;
+    const float positionIncrement = 1.0f / (float) numberOfSamples;
+    float normalisedPeriod = 0.0f;
+    float position = 0.0f;
+    float sum = 0.0f;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        sum += WavetableGetAmplitude(normalisedPeriod, 440.0f, position);
+        normalisedPeriod = WaveformsLimitNormalisedPeriod(normalisedPeriod + increment);
+        position += positionIncrement;
+    }
+    sink = sum;
+}
+
+#endif
+
+/**
+ * @brief Third-order cascade low-pass filter with float arithmetic.
+ * @param numberOfSamples Number of samples.
+ */
+static void CascadeFilterKernel(const unsigned int numberOfSamples) {
+    CascadeFilter cascadeFilter = {0};
+    CascadeFilterSetCornerFrequency(&cascadeFilter, 1000.0f, SAMPLE_FREQUENCY, false, 3);
+    float output = 0.0f;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        output = CascadeFilterUpdate(&cascadeFilter, (index & 64) == 0 ? 0.5f : -0.5f);
+    }
+    sink = output;
+}
+
+/**
+ * @brief Third-order cascade low-pass filter with Q31 arithmetic.
+ * @param numberOfSamples Number of samples.
+ */
+static void CascadeFilterQ31Kernel(const unsigned int numberOfSamples) {
+    CascadeFilterQ31 cascadeFilterQ31 = {0};
+    CascadeFilterQ31SetCornerFrequency(&cascadeFilterQ31, 1000.0f, SAMPLE_FREQUENCY, false, 3);
+    q31 output = 0;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        output = CascadeFilterQ31Update(&cascadeFilterQ31, (index & 64) == 0 ? (Q31_MAX / 2) : (Q31_MIN / 2));
+    }
+    sinkQ31 = output;
+}
+
+/**
+ * @brief Delay feedback multiply and clamped mix with float arithmetic.
+ * @param numberOfSamples Number of samples.
+ */
+static void DelayMixKernel(const unsigned int numberOfSamples) {
+    unsigned int index;
+    for (index = 1; index < numberOfSamples; index++) {
+        floatBuffer[index] = QUANTISE_TO_ZERO(floatBuffer[index] + CLAMP(0.7f * floatBuffer[index - 1], -1.0f, 1.0f));
+    }
+    sink = floatBuffer[numberOfSamples - 1];
+}
+
+/**
+ * @brief Delay feedback multiply and saturating mix with Q31 arithmetic.
+ * @param numberOfSamples Number of samples.
+ */
+static void DelayMixQ31Kernel(const unsigned int numberOfSamples) {
+    const q31 feedback = Q31FromFloat(0.7f);
+    unsigned int index;
+    for (index = 1; index < numberOfSamples; index++) {
+        q31Buffer[index] = Q31Add(q31Buffer[index], Q31Multiply(feedback, q31Buffer[index - 1]));
+    }
+    sinkQ31 = q31Buffer[numberOfSamples - 1];
+}
+
+/**
+ * @brief Echo model of the delay feedback path: control rate update once per
+ * block, interpolated read with modulation, playback and record.  The buffer
+ * is treated as the delay buffer.
+ * @param numberOfSamples Number of samples.
+ */
+static void EchoKernel(const unsigned int numberOfSamples) {
+    float sum = 0.0f;
+    unsigned int index;
+    for (index = 0; index < (numberOfSamples - 1); index++) {
+        if ((index % DAC_BLOCK_SIZE) == 0) {
+            EchoUpdate(&echo, 0.3f, DAC_BLOCK_SIZE);
+        }
+        const float modulation = EchoGetModulation(&echo);
+        const float fraction = modulation - (float) FastMathFloorToInt(modulation);
+        const float read = floatBuffer[index] + fraction * (floatBuffer[index + 1] - floatBuffer[index]);
+        sum += EchoRecord(&echo, EchoPlayback(&echo, read));
+    }
+    sink = sum;
+}
+
+/**
+ * @brief Soft clip of the delay feedback with an input driven up to +/-3.0.
+ * @param numberOfSamples Number of samples.
+ */
+static void SoftClipKernel(const unsigned int numberOfSamples) {
+    float sum = 0.0f;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        sum += SaturationSoftClip(3.0f * floatBuffer[index]);
+    }
+    sink = sum;
+}
+
+/**
+ * @brief 2x oversampled soft clip of the delay feedback with an input driven
+ * up to +/-3.0.
+ * @param numberOfSamples Number of samples.
+ */
+static void OversampledSoftClipKernel(const unsigned int numberOfSamples) {
+    SaturationOversampler saturationOversampler = {{0}};
+    float sum = 0.0f;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        sum += SaturationOversampledSoftClip(&saturationOversampler, 3.0f * floatBuffer[index]);
+    }
+    sink = sum;
+}
+
+/**
+ * @brief Output limiter, one block at a time.  The buffer is limited in place.
+ * @param numberOfSamples Number of samples.
+ */
+static void LimiterKernel(const unsigned int numberOfSamples) {
+    SaturationLimiter saturationLimiter;
+    SaturationLimiterInitialise(&saturationLimiter, 0.9f, 0.1f, SAMPLE_FREQUENCY);
+    unsigned int index;
+    for (index = 0; index <= (numberOfSamples - DAC_BLOCK_SIZE); index += DAC_BLOCK_SIZE) {
+        SaturationLimiterProcess(&saturationLimiter, &floatBuffer[index], DAC_BLOCK_SIZE);
+    }
+}
+
+#ifdef MODULATION_EFFECTS_ENABLED
+
+/**
+ * @brief Modulation effect, one block at a time.  The buffer is processed in
+ * place.
+ * @param numberOfSamples Number of samples.
+ */
+static void ModulationEffectsKernel(const unsigned int numberOfSamples) {
+    unsigned int index;
+    for (index = 0; index <= (numberOfSamples - DAC_BLOCK_SIZE); index += DAC_BLOCK_SIZE) {
+        ModulationEffectsProcess(&floatBuffer[index], DAC_BLOCK_SIZE);
+    }
+}
+
+#endif
+
+#ifdef REVERB_ENABLED
+
+/**
+ * @brief Reverb, one block at a time.  The buffer is processed in place.
+ * @param numberOfSamples Number of samples.
+ */
+static void ReverbKernel(const unsigned int numberOfSamples) {
+    unsigned int index;
+    for (index = 0; index <= (numberOfSamples - DAC_BLOCK_SIZE); index += DAC_BLOCK_SIZE) {
+        ReverbProcess(&floatBuffer[index], DAC_BLOCK_SIZE);
+    }
+}
+
+#endif
+
+#ifdef CONVOLUTION_ENABLED
+
+/**
+ * @brief Convolution, one partition at a time.  The buffer is processed in
+ * place.
+ * @param numberOfSamples Number of samples.
+ */
+static void ConvolutionKernel(const unsigned int numberOfSamples) {
+    unsigned int index;
+    for (index = 0; index <= (numberOfSamples - CONVOLUTION_PARTITION_SIZE); index += CONVOLUTION_PARTITION_SIZE) {
+        ConvolutionProcess(&floatBuffer[index], CONVOLUTION_PARTITION_SIZE);
+    }
+}
+
+#endif
+
+/**
+ * @brief Float to 24-bit DAC sample conversion, one sample at a time as
+ * previously written by each audio update.
+ * @param numberOfSamples Number of samples.
+ */
+static void OutputPerSampleKernel(const unsigned int numberOfSamples) {
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        sinkQ31 = CLAMP(floatBuffer[index], -1.0f, 1.0f) * (float) 0x7FFFFF;
+    }
+}
+
+/**
+ * @brief Q31 to 24-bit DAC sample conversion, one sample at a time as
+ * previously written by each audio update.
+ * @param numberOfSamples Number of samples.
+ */
+static void OutputPerSampleQ31Kernel(const unsigned int numberOfSamples) {
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        sinkQ31 = Q31Add(q31Buffer[index], 1 << 7) >> 8;
+    }
+}
+
+/**
+ * @brief Float to 24-bit DAC sample conversion, one block at a time.
+ * @param numberOfSamples Number of samples.
+ */
+static void OutputBlockKernel(const unsigned int numberOfSamples) {
+    unsigned int index;
+    for (index = 0; index <= (numberOfSamples - DAC_BLOCK_SIZE); index += DAC_BLOCK_SIZE) {
+        DacWriteBlock(&floatBuffer[index]);
+    }
+}
+
+/**
+ * @brief Q31 to 24-bit DAC sample conversion, one block at a time.
+ * @param numberOfSamples Number of samples.
+ */
+static void OutputBlockQ31Kernel(const unsigned int numberOfSamples) {
+    unsigned int index;
+    for (index = 0; index <= (numberOfSamples - DAC_BLOCK_SIZE); index += DAC_BLOCK_SIZE) {
+        DacWriteBlockQ31(&q31Buffer[index]);
+    }
+}
+
+/**
+ * @brief Fills the float and Q31 buffers with the same pseudo-random samples
+ * between -1.0 and +1.0 so that kernels process non-zero data.
+ */
+static void FillBuffers() {
+    unsigned int index;
+    for (index = 0; index < BENCHMARK_NUMBER_OF_SAMPLES; index++) {
+        q31Buffer[index] = (q31) RandomNext(&benchmarkRandom);
+        floatBuffer[index] = Q31ToFloat(q31Buffer[index]);
+    }
+}
+
+/**
+ * @brief Checks Q31 arithmetic for bit-exactness against the C reference
+ * implementation for random and extreme inputs, and the Q31 cascade filter
+ * against the float cascade filter.  The implementation compiled is printed
+ * because the check compares the reference with itself if the DSP ASE is not
+ * enabled.
+ */
+static void CheckQ31() {
+    unsigned int mismatches = 0;
+    unsigned int index;
+    for (index = 0; index < NUMBER_OF_ACCURACY_POINTS; index++) {
+        q31 a = (q31) RandomNext(&benchmarkRandom);
+        q31 b = (q31) RandomNext(&benchmarkRandom);
+        if ((index & 15) == 0) {
+            a = (index & 16) == 0 ? Q31_MIN : Q31_MAX;
+            b = (index & 32) == 0 ? Q31_MIN : Q31_MAX;
+        }
+        mismatches += Q31Add(a, b) != Q31AddReference(a, b) ? 1 : 0;
+        mismatches += Q31Subtract(a, b) != Q31SubtractReference(a, b) ? 1 : 0;
+        mismatches += Q31Multiply(a, b) != Q31MultiplyReference(a, b) ? 1 : 0;
+        mismatches += Q31ShiftRightRound(a, 8) != Q31ShiftRightRoundReference(a, 8) ? 1 : 0;
+    }
+    CascadeFilter cascadeFilter = {0};
+    CascadeFilterSetCornerFrequency(&cascadeFilter, 1000.0f, SAMPLE_FREQUENCY, false, 3);
+    CascadeFilterQ31 cascadeFilterQ31 = {0};
+    CascadeFilterQ31SetCornerFrequency(&cascadeFilterQ31, 1000.0f, SAMPLE_FREQUENCY, false, 3);
+    float maximumError = 0.0f;
+    for (index = 0; index < NUMBER_OF_ACCURACY_POINTS; index++) {
+        const q31 input = (q31) RandomNext(&benchmarkRandom) / 2;
+        const float output = CascadeFilterUpdate(&cascadeFilter, Q31ToFloat(input));
+        const float outputQ31 = Q31ToFloat(CascadeFilterQ31Update(&cascadeFilterQ31, input));
+        maximumError = MAX(maximumError, fabsf(output - outputQ31));
+    }
+    char string[128];
+    snprintf(string, sizeof (string), "%-32s %s\r\n%-32s %5u\r\n%-32s %.1e\r\n", "Q31 implementation", Q31_IMPLEMENTATION, "Q31 reference mismatches", mismatches, "Q31 cascade filter error", (double) maximumError);
+    Print(string);
+}
+
+/**
+ * @brief Measures and prints the maximum error of a fast math function.
+ * @param name Measurement name.
+ * @param fastFunction Fast math function.
+ * @param referenceFunction Reference libm function.
+ * @param minimum Minimum input.
+ * @param maximum Maximum input.
+ * @param relative True for relative error, false for absolute error.
+ */
+static void MeasureAccuracy(const char* const name, float (*fastFunction)(const float x), double (*referenceFunction)(double x), const double minimum, const double maximum, const bool relative) {
+    double maximumError = 0.0;
+    unsigned int index;
+    for (index = 0; index <= NUMBER_OF_ACCURACY_POINTS; index++) {
+        const float x = (float) (minimum + (maximum - minimum) * ((double) index / NUMBER_OF_ACCURACY_POINTS));
+        const double reference = referenceFunction((double) x);
+        double error = fabs((double) fastFunction(x) - reference);
+        if (relative == true) {
+            error /= fabs(reference);
+        }
+        if (error > maximumError) {
+            maximumError = error;
+        }
+    }
+    char string[64];
+    snprintf(string, sizeof (string), "%-32s %.1e\r\n", name, maximumError);
+    Print(string);
+}
+
+/**
+ * @brief Wrapper for accuracy measurement.
+ * @param x Input.
+ * @return Result.
+ */
+static float Exp2(const float x) {
+    return FastMathExp2(x);
+}
+
+/**
+ * @brief Wrapper for accuracy measurement.
+ * @param x Input.
+ * @return Result.
+ */
+static float Log2(const float x) {
+    return FastMathLog2(x);
+}
+
+/**
+ * @brief Wrapper for accuracy measurement.
+ * @param x Input.
+ * @return Result.
+ */
+static float Sin(const float x) {
+    return FastMathSin(x);
+}
+
+/**
+ * @brief Wrapper for accuracy measurement.
+ * @param x Input.
+ * @return Result.
+ */
+static float Tan(const float x) {
+    return FastMathTan(x);
+}
+
+/**
+ * @brief Wrapper for accuracy measurement.
+ * @param x Input.
+ * @return Result.
+ */
+static float Tanh(const float x) {
+    return FastMathTanh(x);
+}
+
+/**
+ * @brief Reference 2^x.
+ * @param x Input.
+ * @return Result.
+ */
+static double ReferenceExp2(double x) {
+    return pow(2.0, x);
+}
+
+/**
+ * @brief Reference log2(x).
+ * @param x Input.
+ * @return Result.
+ */
+static double ReferenceLog2(double x) {
+    return log(x) / M_LN2;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
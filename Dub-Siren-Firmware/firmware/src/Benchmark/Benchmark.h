@@ -0,0 +1,45 @@
+/**
+ * @file Benchmark.h
+ * @author Seb Madgwick
+ * @brief On-target DSP benchmarks.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Uncomment this definition to run benchmarks on start up, before the
+ * audio interrupts are enabled.  Results are printed to UART 1.
+ */
+//#define BENCHMARK_ENABLED
+
+/**
+ * @brief Number of samples processed by each benchmark.  Equivalent to 100 ms
+ * of audio.
+ */
+#define BENCHMARK_NUMBER_OF_SAMPLES (9600)
+
+/**
+ * @brief RAM used by the benchmark float and Q31 buffers in bytes.  The
+ * synthesiser delay buffer is reduced by this amount.
+ */
+#ifdef BENCHMARK_ENABLED
+#define BENCHMARK_RAM_SIZE (BENCHMARK_NUMBER_OF_SAMPLES * 8)
+#else
+#define BENCHMARK_RAM_SIZE (0)
+#endif
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+#ifdef BENCHMARK_ENABLED
+void BenchmarkRun();
+#endif
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
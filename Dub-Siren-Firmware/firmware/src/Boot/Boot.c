@@ -0,0 +1,135 @@
+/**
+ * @file Boot.c
+ * @author Seb Madgwick
+ * @brief Records start up phase timestamps and reports the boot time.
+ *
+ * Timestamps are measured from when the timer is initialised, immediately
+ * after the system clock is configured.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Boot.h"
+#include "Dac/Dac.h" // SAMPLE_FREQUENCY
+#include "Scheduler/Scheduler.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h> // snprintf
+#include "Synthesiser/Synthesiser.h"
+#include "Timer/Timer.h"
+#include "Uart/Uart1.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Timer ticks per audio sample.
+ */
+#define TIMER_TICKS_PER_SAMPLE ((uint64_t) (TIMER_TICKS_PER_SECOND / SAMPLE_FREQUENCY))
+
+/**
+ * @brief Period in microseconds that BootTasks polls for outstanding phases.
+ */
+#define POLL_PERIOD (100)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static char* BootPhaseToString(const BootPhase bootPhase);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static uint64_t phaseTicks[BootNumberOfPhases];
+static bool phaseReached[BootNumberOfPhases];
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Timestamps the boot phase if it has not already been reached.
+ * @param bootPhase Boot phase.
+ */
+void BootSetPhase(const BootPhase bootPhase) {
+    if (phaseReached[bootPhase] == true) {
+        return;
+    }
+    phaseTicks[bootPhase] = TimerGetTicks64();
+    phaseReached[bootPhase] = true;
+}
+
+/**
+ * @brief Do module tasks.  This function should be added to the scheduler as a
+ * one-shot task.  It re-arms itself until all phases have been reached and then
+ * prints the boot report.
+ */
+void BootTasks() {
+
+    // Back-date first sample by the number of samples output since
+    if (phaseReached[BootPhaseFirstSample] == false) {
+        const uint32_t sampleCount = SynthesiserGetSampleCount();
+        if (sampleCount > 0) {
+            phaseTicks[BootPhaseFirstSample] = TimerGetTicks64() - ((uint64_t) (sampleCount - 1) * TIMER_TICKS_PER_SAMPLE);
+            phaseReached[BootPhaseFirstSample] = true;
+        }
+    }
+
+    // Re-arm until all phases reached
+    unsigned int index;
+    for (index = 0; index < BootNumberOfPhases; index++) {
+        if (phaseReached[index] == false) {
+            SchedulerAddOneShotTask("Boot", &BootTasks, POLL_PERIOD);
+            return;
+        }
+    }
+    BootPrint();
+}
+
+/**
+ * @brief Prints boot phase timestamps and the boot to audio time.
+ */
+void BootPrint() {
+    Uart1WriteStringIfReady("\r\nBOOT (us):\r\n");
+    unsigned int index;
+    for (index = 0; index < BootNumberOfPhases; index++) {
+        char string[64];
+        if (phaseReached[index] == true) {
+            snprintf(string, sizeof (string), "%-24s %8u\r\n", BootPhaseToString(index), (unsigned int) (phaseTicks[index] / (TIMER_TICKS_PER_SECOND / 1000000)));
+        } else {
+            snprintf(string, sizeof (string), "%-24s %8s\r\n", BootPhaseToString(index), "-");
+        }
+        Uart1WriteStringIfReady(string);
+    }
+    if (phaseReached[BootPhaseFirstSample] == true) {
+        char string[64];
+        snprintf(string, sizeof (string), "Boot to audio %u us\r\n", (unsigned int) (phaseTicks[BootPhaseFirstSample] / (TIMER_TICKS_PER_SECOND / 1000000)));
+        Uart1WriteStringIfReady(string);
+    }
+}
+
+/**
+ * @brief Returns the boot phase name.
+ * @param bootPhase Boot phase.
+ * @return Boot phase name.
+ */
+static char* BootPhaseToString(const BootPhase bootPhase) {
+    switch (bootPhase) {
+        case BootPhaseAudioStarted:
+            return (char *) &"Audio started";
+        case BootPhaseFirstSample:
+            return (char *) &"First sample";
+        case BootPhaseUserInterfaceStarted:
+            return (char *) &"User interface started";
+        case BootPhasePotentiometersReady:
+            return (char *) &"Potentiometers ready";
+        case BootPhasePresetsLoaded:
+            return (char *) &"Presets loaded";
+        case BootNumberOfPhases:
+            break;
+    }
+    return (char *) &"";
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,35 @@
+/**
+ * @file Boot.h
+ * @author Seb Madgwick
+ * @brief Records start up phase timestamps and reports the boot time.
+ */
+
+#ifndef BOOT_H
+#define BOOT_H
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Boot phases.  Each phase is timestamped the first time it is reached.
+ */
+typedef enum {
+    BootPhaseAudioStarted,
+    BootPhaseFirstSample,
+    BootPhaseUserInterfaceStarted,
+    BootPhasePotentiometersReady,
+    BootPhasePresetsLoaded,
+    BootNumberOfPhases,
+} BootPhase;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void BootSetPhase(const BootPhase bootPhase);
+void BootTasks();
+void BootPrint();
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,254 @@
+/**
+ * @file Convolution.c
+ * @author Seb Madgwick
+ * @brief Zero-latency convolution with short impulse responses for horn and
+ * speaker cabinet emulation.
+ *
+ * The impulse response is split into partitions of CONVOLUTION_PARTITION_SIZE
+ * taps.  The first partition is applied as a direct-form FIR filter so that
+ * there is no latency.  The remaining partitions are applied by uniformly
+ * partitioned overlap-save FFT convolution.  Because partition k is only
+ * applied to inputs at least k partitions old, the contribution of all
+ * remaining partitions to the current block is available from the spectra of
+ * previous input blocks before the current block is received.
+ *
+ * Each block requires one FFT, one inverse FFT, one complex multiply-add per
+ * bin per partition, and CONVOLUTION_PARTITION_SIZE multiply-adds per sample
+ * for the first partition.
+ *
+ * An impulse response is loaded one tap at a time.  Convolution is disabled
+ * while loading so that the spectra are not used while incomplete.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Convolution.h"
+
+#ifdef CONVOLUTION_ENABLED
+
+#include "Dac/Dac.h" // DAC_BLOCK_SIZE
+#include "Fft/Fft.h"
+#include <string.h> // memcpy, memset
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#if FFT_SIZE != (2 * CONVOLUTION_PARTITION_SIZE)
+#error "FFT size must be twice the convolution partition size"
+#endif
+
+#if CONVOLUTION_PARTITION_SIZE != DAC_BLOCK_SIZE
+#error "Convolution partition size must equal the DAC block size"
+#endif
+
+/**
+ * @brief Maximum number of partitions applied by FFT convolution.
+ */
+#define MAXIMUM_FFT_PARTITIONS ((CONVOLUTION_MAXIMUM_LENGTH / CONVOLUTION_PARTITION_SIZE) - 1)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void TransformPartition(const unsigned int partition);
+static inline __attribute__((always_inline)) void MultiplyAccumulate(float* const accumulator, const float* const a, const float* const b);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static float firstPartition[CONVOLUTION_PARTITION_SIZE];
+static float partitionSpectra[MAXIMUM_FFT_PARTITIONS][FFT_SIZE];
+static float inputSpectra[MAXIMUM_FFT_PARTITIONS][FFT_SIZE]; // circular buffer of input spectra, newest at inputSpectraIndex
+static unsigned int inputSpectraIndex;
+static float previousInput[CONVOLUTION_PARTITION_SIZE];
+static unsigned int numberOfFftPartitions;
+static unsigned int length;
+static volatile bool enabled;
+static bool loading;
+static unsigned int loadLength;
+static unsigned int loadIndex;
+static float loadPartition[CONVOLUTION_PARTITION_SIZE];
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises module.  This function should be called once, on system
+ * start up.
+ */
+void ConvolutionInitialise() {
+    FftInitialise();
+}
+
+/**
+ * @brief Disables convolution and starts loading a new impulse response.
+ * @param newLength Impulse response length in samples.  Must not exceed
+ * CONVOLUTION_MAXIMUM_LENGTH.
+ * @return True if successful.
+ */
+bool ConvolutionLoadBegin(const unsigned int newLength) {
+    if ((newLength == 0) || (newLength > CONVOLUTION_MAXIMUM_LENGTH)) {
+        return false;
+    }
+    ConvolutionDisable();
+    loading = true;
+    loadLength = newLength;
+    loadIndex = 0;
+    memset(firstPartition, 0, sizeof (firstPartition));
+    memset(loadPartition, 0, sizeof (loadPartition));
+    return true;
+}
+
+/**
+ * @brief Loads the next tap of the impulse response.  Each complete partition
+ * is transformed as it is received.
+ * @param tap Tap.
+ * @return True if successful.
+ */
+bool ConvolutionLoadTap(const float tap) {
+    if ((loading == false) || (loadIndex >= loadLength)) {
+        return false;
+    }
+    if (loadIndex < CONVOLUTION_PARTITION_SIZE) {
+        firstPartition[loadIndex] = tap;
+    } else {
+        loadPartition[loadIndex % CONVOLUTION_PARTITION_SIZE] = tap;
+    }
+    loadIndex++;
+    if ((loadIndex > CONVOLUTION_PARTITION_SIZE) && ((loadIndex % CONVOLUTION_PARTITION_SIZE) == 0)) {
+        TransformPartition((loadIndex / CONVOLUTION_PARTITION_SIZE) - 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Completes loading of the impulse response and enables convolution.
+ * @return True if successful.  False if the number of taps loaded does not
+ * match the length specified by ConvolutionLoadBegin.
+ */
+bool ConvolutionLoadEnd() {
+    if ((loading == false) || (loadIndex != loadLength)) {
+        loading = false;
+        return false;
+    }
+    loading = false;
+
+    // Transform incomplete last partition
+    if ((loadIndex > CONVOLUTION_PARTITION_SIZE) && ((loadIndex % CONVOLUTION_PARTITION_SIZE) != 0)) {
+        TransformPartition(loadIndex / CONVOLUTION_PARTITION_SIZE);
+    }
+
+    // Reset state and enable
+    numberOfFftPartitions = (loadLength - 1) / CONVOLUTION_PARTITION_SIZE;
+    memset(inputSpectra, 0, sizeof (inputSpectra));
+    memset(previousInput, 0, sizeof (previousInput));
+    inputSpectraIndex = 0;
+    length = loadLength;
+    enabled = true;
+    return true;
+}
+
+/**
+ * @brief Transforms the load partition into the spectrum of an impulse
+ * response partition.  The taps are scaled to normalise the inverse FFT.
+ * @param partition Partition number.  Must not be 0.
+ */
+static void TransformPartition(const unsigned int partition) {
+    float* const spectrum = partitionSpectra[partition - 1];
+    unsigned int index;
+    for (index = 0; index < CONVOLUTION_PARTITION_SIZE; index++) {
+        spectrum[index] = loadPartition[index] * (1.0f / FFT_SIZE);
+        spectrum[CONVOLUTION_PARTITION_SIZE + index] = 0.0f;
+    }
+    FftRealForward(spectrum);
+    memset(loadPartition, 0, sizeof (loadPartition));
+}
+
+/**
+ * @brief Disables convolution.  Samples are passed through unmodified.
+ */
+void ConvolutionDisable() {
+    enabled = false;
+    loading = false;
+}
+
+/**
+ * @brief Returns the length of the impulse response.
+ * @return Impulse response length in samples.  0 if convolution is disabled.
+ */
+unsigned int ConvolutionGetLength() {
+    return enabled ? length : 0;
+}
+
+/**
+ * @brief Convolves a block of samples in place with the impulse response.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.  Must equal
+ * CONVOLUTION_PARTITION_SIZE, otherwise the samples are not processed.
+ */
+void ConvolutionProcess(float* const samples, const unsigned int numberOfSamples) {
+    if ((enabled == false) || (numberOfSamples != CONVOLUTION_PARTITION_SIZE)) {
+        return;
+    }
+
+    // Overlap-save frame of previous and current input
+    float frame[FFT_SIZE];
+    memcpy(frame, previousInput, sizeof (previousInput));
+    memcpy(&frame[CONVOLUTION_PARTITION_SIZE], samples, sizeof (previousInput));
+    memcpy(previousInput, samples, sizeof (previousInput));
+
+    // Contribution of FFT partitions from previous input spectra
+    float accumulator[FFT_SIZE];
+    memset(accumulator, 0, sizeof (accumulator));
+    unsigned int spectrumIndex = inputSpectraIndex;
+    unsigned int partition;
+    for (partition = 0; partition < numberOfFftPartitions; partition++) {
+        MultiplyAccumulate(accumulator, partitionSpectra[partition], inputSpectra[spectrumIndex]);
+        spectrumIndex = (spectrumIndex == 0) ? (MAXIMUM_FFT_PARTITIONS - 1) : (spectrumIndex - 1);
+    }
+    if (numberOfFftPartitions > 0) {
+        FftRealInverse(accumulator);
+    }
+
+    // Add contribution of first partition as direct-form FIR
+    unsigned int index;
+    for (index = 0; index < CONVOLUTION_PARTITION_SIZE; index++) {
+        const float* const input = &frame[CONVOLUTION_PARTITION_SIZE + index];
+        float sum = accumulator[CONVOLUTION_PARTITION_SIZE + index];
+        unsigned int tap;
+        for (tap = 0; tap < CONVOLUTION_PARTITION_SIZE; tap++) {
+            sum += firstPartition[tap] * input[-(int) tap];
+        }
+        samples[index] = sum;
+    }
+
+    // Store spectrum of frame for subsequent blocks
+    if (numberOfFftPartitions > 0) {
+        if (++inputSpectraIndex >= MAXIMUM_FFT_PARTITIONS) {
+            inputSpectraIndex = 0;
+        }
+        memcpy(inputSpectra[inputSpectraIndex], frame, sizeof (frame));
+        FftRealForward(inputSpectra[inputSpectraIndex]);
+    }
+}
+
+/**
+ * @brief Multiplies two packed spectra and adds the result to an accumulator.
+ * @param accumulator Accumulator packed spectrum.
+ * @param a First packed spectrum.
+ * @param b Second packed spectrum.
+ */
+static inline __attribute__((always_inline)) void MultiplyAccumulate(float* const accumulator, const float* const a, const float* const b) {
+    accumulator[0] += a[0] * b[0]; // DC
+    accumulator[1] += a[1] * b[1]; // Nyquist
+    unsigned int index;
+    for (index = 2; index < FFT_SIZE; index += 2) {
+        accumulator[index] += a[index] * b[index] - a[index + 1] * b[index + 1];
+        accumulator[index + 1] += a[index] * b[index + 1] + a[index + 1] * b[index];
+    }
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
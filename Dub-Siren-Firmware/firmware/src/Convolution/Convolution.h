@@ -0,0 +1,65 @@
+/**
+ * @file Convolution.h
+ * @author Seb Madgwick
+ * @brief Zero-latency convolution with short impulse responses for horn and
+ * speaker cabinet emulation.
+ */
+
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Uncomment this definition to enable convolution of the output with an
+ * impulse response loaded via the serial interface.  The synthesiser delay
+ * buffer is reduced by CONVOLUTION_RAM_SIZE.  Convolution is not applied if
+ * FIXED_POINT_ENABLED is defined.
+ */
+//#define CONVOLUTION_ENABLED
+
+/**
+ * @brief Partition size in samples.  Must equal the number of samples
+ * processed by each call of ConvolutionProcess.
+ */
+#define CONVOLUTION_PARTITION_SIZE (32)
+
+/**
+ * @brief Maximum impulse response length in samples.  Must be a multiple of
+ * CONVOLUTION_PARTITION_SIZE.
+ */
+#define CONVOLUTION_MAXIMUM_LENGTH (2048)
+
+/**
+ * @brief RAM used by the impulse response spectra and input spectra in bytes.
+ * Each tap requires two floats of each.
+ */
+#ifdef CONVOLUTION_ENABLED
+#define CONVOLUTION_RAM_SIZE (CONVOLUTION_MAXIMUM_LENGTH * 16)
+#else
+#define CONVOLUTION_RAM_SIZE (0)
+#endif
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+#ifdef CONVOLUTION_ENABLED
+void ConvolutionInitialise();
+bool ConvolutionLoadBegin(const unsigned int length);
+bool ConvolutionLoadTap(const float tap);
+bool ConvolutionLoadEnd();
+void ConvolutionDisable();
+unsigned int ConvolutionGetLength();
+void ConvolutionProcess(float* const samples, const unsigned int numberOfSamples);
+#endif
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -6,23 +6,77 @@
  * REFCLKO1 is configured for 24.576 MHz using MPLAB Harmony.  This corresponds
  * to an LRCK value of 96 kHz and I2S data clock of SCLK of 6.144 MHz (64 bits
  * per LRCK period).  See page 13 of CS4354 datasheet.
+ *
+ * Samples are double buffered in blocks of DAC_BLOCK_SIZE.  The SPI interrupt
+ * writes the playing block to the DAC one sample at a time and triggers the
+ * audio update interrupt each time it switches blocks.  The audio update
+ * callback then has one block period to render the next block.
  */
 
 //------------------------------------------------------------------------------
 // Includes
 
 #include "Dac.h"
+#include "FastMath/FastMath.h"
+#include <math.h> // fabsf, copysignf
 #include "MathHelpers.h"
+#include "Random/Random.h"
+#include <stdint.h>
 #include "system/int/sys_int.h"
 #include "system_config.h" // SYS_CLK_BUS_REFERENCE_1
 #include "Timer/Timer.h"
+#include "Trace/Trace.h"
 #include <xc.h>
 
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Number of core timer ticks per audio sample.  The core timer
+ * increments at half the system clock frequency.
+ */
+#define CORE_TIMER_TICKS_PER_SAMPLE ((float) SYS_CLK_FREQ / (2.0f * SAMPLE_FREQUENCY))
+
+/**
+ * @brief Number of core timer ticks per block.
+ */
+#define CORE_TIMER_TICKS_PER_BLOCK (CORE_TIMER_TICKS_PER_SAMPLE * (float) DAC_BLOCK_SIZE)
+
+/**
+ * @brief Full-scale value of a 24-bit DAC sample.
+ */
+#define Q23_SCALE (8388608.0f)
+
+/**
+ * @brief Soft knee threshold.  Samples below this magnitude are not modified.
+ * Equivalent to -2.5 dBFS.
+ */
+#define SOFT_KNEE_THRESHOLD (0.75f)
+
+/**
+ * @brief Soft knee threshold in Q31.
+ */
+#define SOFT_KNEE_THRESHOLD_Q31 ((q31) (SOFT_KNEE_THRESHOLD * 2147483648.0f))
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static inline __attribute__((always_inline)) float SoftKnee(const float sample);
+static inline __attribute__((always_inline)) int32_t TpdfDither();
+
 //------------------------------------------------------------------------------
 // Variables
 
 static void (*audioUpdateCallback)();
-static int buffer;
+static int32_t blocks[2][DAC_BLOCK_SIZE];
+static volatile unsigned int playingBlock;
+static unsigned int playingIndex;
+static volatile bool renderPending;
+static uint32_t underrunCount;
+static uint32_t peakAudioUpdateTicks;
+static bool ditherEnabled = true;
+static bool softKneeEnabled = true;
+static Random ditherRandom;
 
 //------------------------------------------------------------------------------
 // Functions
@@ -31,12 +85,14 @@ static int buffer;
  * @breif Initialises module.  This function should be called once, on system
  * start up.
  * @param audioUpdate External audio update callback function.  The audio update
- * callback function must call DacWriteBuffer immediately.
+ * callback function must render DAC_BLOCK_SIZE samples and call DacWriteBlock
+ * or DacWriteBlockQ31.
  */
 void DacInitialise(void (*audioUpdate)()) {
 
     // Store address of audio update function
     audioUpdateCallback = audioUpdate;
+    RandomInitialise(&ditherRandom, 1);
 
     // Configure I2S
     SPI1BRG = (unsigned int) ((((float) SYS_CLK_BUS_REFERENCE_1 / (2.0f * 6144000.0f)) - 1.0f) + 0.5f); // 6.144 MHz
@@ -61,12 +117,21 @@ void DacInitialise(void (*audioUpdate)()) {
 }
 
 /**
- * @breif SPI interrupt service routine to write buffered value to DAC and call
- * external audio update function.
+ * @breif SPI interrupt service routine to write the next sample of the playing
+ * block to DAC and call external audio update function at the end of each
+ * block.
  */
 void __ISR(_SPI1_TX_VECTOR) Spi1TXInterrupt() {
-    SPI1BUF = buffer;
-    SYS_INT_SourceStatusSet(INT_SOURCE_TIMER_1); // trigger lower priority audio update interrupt
+    SPI1BUF = blocks[playingBlock][playingIndex];
+    if (++playingIndex >= DAC_BLOCK_SIZE) {
+        playingIndex = 0;
+        if (renderPending == true) {
+            underrunCount++; // next block incomplete
+        }
+        playingBlock ^= 1;
+        renderPending = true;
+        SYS_INT_SourceStatusSet(INT_SOURCE_TIMER_1); // trigger lower priority audio update interrupt
+    }
     SYS_INT_SourceStatusClear(INT_SOURCE_SPI_1_TRANSMIT); // clear interrupt flag
 }
 
@@ -75,16 +140,134 @@ void __ISR(_SPI1_TX_VECTOR) Spi1TXInterrupt() {
  * interrupt is software triggered.
  */
 void __ISR(_TIMER_1_VECTOR) Timer1Interrupt() {
+    const uint32_t startTicks = _CP0_GET_COUNT();
     audioUpdateCallback();
+    const uint32_t audioUpdateTicks = _CP0_GET_COUNT() - startTicks;
+    if (audioUpdateTicks > peakAudioUpdateTicks) {
+        peakAudioUpdateTicks = audioUpdateTicks;
+    }
+    if (audioUpdateTicks > (uint32_t) CORE_TIMER_TICKS_PER_BLOCK) {
+        TRACE(TraceEventAudioOverrun, MIN(audioUpdateTicks, UINT16_MAX));
+    }
+    renderPending = false;
     SYS_INT_SourceStatusClear(INT_SOURCE_TIMER_1); // clear interrupt flag
 }
 
 /**
- * @breif Writes sample to DAC buffer.
- * @param sample Sample value between -1.0 and +1.0.
+ * @breif Writes a block of samples to the DAC buffer that is not playing.  Each
+ * sample is passed through the soft knee, dithered and then rounded and
+ * saturated to the 24-bit DAC resolution.
+ * @param samples DAC_BLOCK_SIZE samples between -1.0 and +1.0.
+ */
+void DacWriteBlock(const float* const samples) {
+    int32_t * const block = blocks[playingBlock ^ 1];
+    const bool softKnee = softKneeEnabled;
+    const bool dither = ditherEnabled;
+    unsigned int index;
+    for (index = 0; index < DAC_BLOCK_SIZE; index++) {
+        float sample = samples[index];
+        if (softKnee == true) {
+            sample = SoftKnee(sample);
+        }
+        sample *= Q23_SCALE;
+        if (dither == true) {
+            sample += (float) TpdfDither() * (1.0f / 65536.0f);
+        }
+        sample = CLAMP(sample, -Q23_SCALE, Q23_SCALE - 1.0f);
+        block[index] = FastMathFloorToInt(sample + 0.5f);
+    }
+}
+
+/**
+ * @breif Writes a block of Q31 samples to the DAC buffer that is not playing.
+ * Each sample is passed through the soft knee, dithered and then rounded to the
+ * 24-bit DAC resolution.  The soft knee is calculated in floating-point for
+ * only those samples above the threshold.
+ * @param samples DAC_BLOCK_SIZE Q31 samples.
+ */
+void DacWriteBlockQ31(const q31 * const samples) {
+    int32_t * const block = blocks[playingBlock ^ 1];
+    const bool softKnee = softKneeEnabled;
+    const bool dither = ditherEnabled;
+    unsigned int index;
+    for (index = 0; index < DAC_BLOCK_SIZE; index++) {
+        q31 sample = samples[index];
+        if ((softKnee == true) && ((sample > SOFT_KNEE_THRESHOLD_Q31) || (sample < -SOFT_KNEE_THRESHOLD_Q31))) {
+            sample = Q31FromFloat(SoftKnee(Q31ToFloat(sample)));
+        }
+        if (dither == true) {
+            sample = Q31Add(sample, TpdfDither() >> 8); // 1 LSB of 24-bit is 2^8 in Q31
+        }
+        block[index] = MIN(Q31ShiftRightRound(sample, 8), 0x7FFFFF);
+    }
+}
+
+/**
+ * @brief Soft knee.  Samples above the threshold are compressed so that the
+ * output approaches but never reaches full scale.  The gradient is continuous
+ * at the threshold.
+ * @param sample Sample.
+ * @return Sample with magnitude less than 1.0.
+ */
+static inline __attribute__((always_inline)) float SoftKnee(const float sample) {
+    const float magnitude = fabsf(sample);
+    if (magnitude <= SOFT_KNEE_THRESHOLD) {
+        return sample;
+    }
+    const float excess = (magnitude - SOFT_KNEE_THRESHOLD) * (1.0f / (1.0f - SOFT_KNEE_THRESHOLD));
+    return copysignf(SOFT_KNEE_THRESHOLD + (1.0f - SOFT_KNEE_THRESHOLD) * excess * FastMathReciprocal(1.0f + excess), sample);
+}
+
+/**
+ * @brief Returns triangular probability density function (TPDF) dither as the
+ * sum of two uniform 16-bit random numbers.
+ * @return Dither between -65535 and +65535 corresponding to +/-1 LSB of the
+ * 24-bit DAC resolution.
+ */
+static inline __attribute__((always_inline)) int32_t TpdfDither() {
+    const uint32_t random = RandomNext(&ditherRandom);
+    return (int32_t) (random & 0xFFFF) + (int32_t) (random >> 16) - 0xFFFF;
+}
+
+/**
+ * @brief Enables or disables TPDF dither of the DAC output.  Dither is enabled
+ * by default.
+ * @param enabled True to enable dither.
+ */
+void DacSetDither(const bool enabled) {
+    ditherEnabled = enabled;
+}
+
+/**
+ * @brief Enables or disables the soft knee of the DAC output.  If disabled then
+ * samples are hard clipped to full scale.  The soft knee is enabled by default.
+ * @param enabled True to enable the soft knee.
+ */
+void DacSetSoftKnee(const bool enabled) {
+    softKneeEnabled = enabled;
+}
+
+/**
+ * @brief Returns the peak execution time of the audio update callback since the
+ * previous call of this function, as a fraction of the block period.  A value
+ * of 1.0 or greater indicates that the audio update deadline was missed.
+ * @return Peak audio update load.
+ */
+float DacGetPeakLoad() {
+    SYS_INT_SourceDisable(INT_SOURCE_TIMER_1); // disable interrupt
+    const uint32_t audioUpdateTicks = peakAudioUpdateTicks;
+    peakAudioUpdateTicks = 0;
+    SYS_INT_SourceEnable(INT_SOURCE_TIMER_1); // enable interrupt
+    return (float) audioUpdateTicks * (1.0f / CORE_TIMER_TICKS_PER_BLOCK);
+}
+
+/**
+ * @brief Returns the number of blocks that were not rendered before they were
+ * due to be played.
+ * @return Number of underruns.
  */
-void DacWriteBuffer(const float sample) {
-    buffer = CLAMP(sample, -1.0f, 1.0f) * (float) 0x7FFFFF;
+uint32_t DacGetUnderrunCount() {
+    return underrunCount;
 }
 
 //------------------------------------------------------------------------------
@@ -7,6 +7,13 @@
 #ifndef DAC_H
 #define DAC_H
 
+//------------------------------------------------------------------------------
+// Includes
+
+#include "FixedPoint/Q31.h"
+#include <stdbool.h>
+#include <stdint.h>
+
 //------------------------------------------------------------------------------
 // Definitions
 
@@ -15,11 +22,22 @@
  */
 #define SAMPLE_FREQUENCY (96000.0f)
 
+/**
+ * @breif Number of samples rendered by each call of the audio update callback.
+ * The DAC output is delayed by one block.
+ */
+#define DAC_BLOCK_SIZE (32)
+
 //------------------------------------------------------------------------------
 // Function prototypes
 
 void DacInitialise(void (*audioUpdate)());
-void DacWriteBuffer(const float sample);
+void DacWriteBlock(const float* const samples);
+void DacWriteBlockQ31(const q31 * const samples);
+void DacSetDither(const bool enabled);
+void DacSetSoftKnee(const bool enabled);
+float DacGetPeakLoad();
+uint32_t DacGetUnderrunCount();
 
 #endif
 
@@ -9,6 +9,7 @@
 
 #include "DebouncedButton.h"
 #include "Timer/Timer.h"
+#include "Trace/Trace.h"
 
 //------------------------------------------------------------------------------
 // Definitions
@@ -18,6 +19,12 @@
  */
 #define HOLDOFF_PERIOD ((uint64_t) (TIMER_TICKS_PER_SECOND / 100))
 
+/**
+ * @brief Trace argument identifying the button as port number << 8 | port bit,
+ * e.g. 0x020D for RC13.  Port registers are spaced 0x100 apart from PORTA.
+ */
+#define TRACE_ARGUMENT(debouncedButton) (((((uintptr_t) (debouncedButton)->port) >> 8) & 0xF) << 8 | (debouncedButton)->portBit)
+
 //------------------------------------------------------------------------------
 // Function prototypes
 
@@ -74,11 +81,13 @@ static inline __attribute__((always_inline)) void Update(DebouncedButton * const
         debouncedButton->ticks = currentTicks;
         if (debouncedButton->isHeld == false) {
             debouncedButton->wasPressed = true;
+            TRACE(TraceEventButtonPressed, TRACE_ARGUMENT(debouncedButton));
         }
         debouncedButton->isHeld = true;
     } else {
-        if (currentTicks >= (debouncedButton->ticks + HOLDOFF_PERIOD)) {
+        if ((debouncedButton->isHeld == true) && (currentTicks >= (debouncedButton->ticks + HOLDOFF_PERIOD))) {
             debouncedButton->isHeld = false;
+            TRACE(TraceEventButtonReleased, TRACE_ARGUMENT(debouncedButton));
         }
     }
 }
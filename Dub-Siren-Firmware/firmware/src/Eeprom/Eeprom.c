@@ -9,6 +9,7 @@
 
 #include "Eeprom.h"
 #include <stdbool.h>
+#include "Trace/Trace.h"
 
 //------------------------------------------------------------------------------
 // Definitions
@@ -18,11 +19,6 @@
  */
 #define I2C_ADDRESS (0x50)
 
-/**
- * @brief Page size of EEPROM.
- */
-#define EEPROM_PAGE_SIZE (32)
-
 //------------------------------------------------------------------------------
 // Function prototypes
 
@@ -39,6 +35,7 @@ static void StartSequence(const I2cBitBang * const i2cBitBang, const unsigned in
  * @param numberOfBytes Number of bytes to read.
  */
 void EepromRead(const I2cBitBang * const i2cBitBang, const unsigned int address, char *const destination, const size_t numberOfBytes) {
+    TRACE(TraceEventEepromReadStart, address);
     StartSequence(i2cBitBang, address);
     I2CBitBangStop(i2cBitBang);
     I2CBitBangStart(i2cBitBang);
@@ -56,6 +53,7 @@ void EepromRead(const I2cBitBang * const i2cBitBang, const unsigned int address,
         }
     }
     I2CBitBangStop(i2cBitBang);
+    TRACE(TraceEventEepromReadEnd, numberOfBytes);
 }
 
 /**
@@ -66,6 +64,7 @@ void EepromRead(const I2cBitBang * const i2cBitBang, const unsigned int address,
  * @param numberOfBytes Number of bytes to written.
  */
 void EepromWrite(const I2cBitBang * const i2cBitBang, unsigned int address, const char* source, const size_t numberOfBytes) {
+    TRACE(TraceEventEepromWriteStart, address);
     StartSequence(i2cBitBang, address);
     const unsigned int endAddress = address + numberOfBytes;
     int currentPageNumber = address / EEPROM_PAGE_SIZE;
@@ -79,6 +78,7 @@ void EepromWrite(const I2cBitBang * const i2cBitBang, unsigned int address, cons
         }
     }
     I2CBitBangStop(i2cBitBang);
+    TRACE(TraceEventEepromWriteEnd, numberOfBytes);
 }
 
 /**
@@ -110,5 +110,19 @@ void EepromEraseAll(const I2cBitBang * const i2cBitBang) {
     }
 }
 
+/**
+ * @brief Returns true if the EEPROM is not engaged in a write cycle.  Unlike
+ * the read and write functions, this function polls for an acknowledge once
+ * and does not wait for the write cycle to complete.
+ * @param i2cBitBang I2C bit bang structure.
+ * @return True if the EEPROM is ready.
+ */
+bool EepromIsReady(const I2cBitBang * const i2cBitBang) {
+    I2CBitBangStart(i2cBitBang);
+    const bool ack = I2CBitBangSend(i2cBitBang, I2CSlaveAddressWrite(I2C_ADDRESS));
+    I2CBitBangStop(i2cBitBang);
+    return ack;
+}
+
 //------------------------------------------------------------------------------
 // End of file
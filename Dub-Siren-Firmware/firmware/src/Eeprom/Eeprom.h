@@ -21,12 +21,19 @@
 
 #define EEPROM_SIZE (0x3FF)
 
+/**
+ * @brief Page size of EEPROM.  A write must not cross a page boundary if it is
+ * to complete in a single write cycle.
+ */
+#define EEPROM_PAGE_SIZE (32)
+
 //------------------------------------------------------------------------------
 // Function prototypes
 
 void EepromRead(const I2cBitBang * const i2cBitBang, const unsigned int address, char *const destination, const size_t numberOfBytes);
 void EepromWrite(const I2cBitBang * const i2cBitBang, unsigned int address, const char* source, const size_t numberOfBytes);
 void EepromEraseAll(const I2cBitBang * const i2cBitBang);
+bool EepromIsReady(const I2cBitBang * const i2cBitBang);
 
 #endif
 
@@ -0,0 +1,428 @@
+/**
+ * @file EffectsChain.c
+ * @author Seb Madgwick
+ * @brief Ordered chain of block-processing effect nodes applied to the
+ * synthesiser output.
+ *
+ * The layout of the chain may be changed at run time.  The new layout is
+ * applied by the audio update at the start of the next block so that nodes
+ * are never modified while being processed.  Applying a layout discards the
+ * state of all nodes and allocates new state from a static arena.  Nodes that
+ * cannot be allocated, duplicates of single-instance nodes and node types not
+ * enabled at compile time are kept in the chain but are inactive.
+ *
+ * The modulation, reverb and convolution modules own their state and so may
+ * only appear once in the chain.  Their state is not reset when the layout
+ * changes.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Convolution/Convolution.h"
+#include "Dac/Dac.h" // SAMPLE_FREQUENCY
+#include "EffectsChain.h"
+#include "Filters/CascadeFilter.h"
+#include "MathHelpers.h"
+#include "ModulationEffects/ModulationEffects.h"
+#include "Reverb/Reverb.h"
+#include "Saturation/Saturation.h"
+#include <stddef.h> // NULL, size_t
+#include <string.h> // memset
+#include <xc.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Filter node parameters.
+ */
+#define LOW_PASS_FILTER_FREQUENCY (3000.0f)
+#define HIGH_PASS_FILTER_FREQUENCY (150.0f)
+#define FILTER_ORDER (2)
+
+/**
+ * @brief Saturator node drive.  The output is attenuated by the same amount so
+ * that low-level signals are unchanged.
+ */
+#define SATURATOR_DRIVE (2.0f)
+
+/**
+ * @brief Delay node parameters.  The delay length is in samples and equivalent
+ * to 32 ms.  Samples are stored as 16-bit to halve the arena required.
+ */
+#define DELAY_NODE_LENGTH (3072)
+#define DELAY_NODE_FEEDBACK (0.3f)
+#define DELAY_NODE_MIX (0.35f)
+
+/**
+ * @brief Delay node state structure.
+ */
+typedef struct {
+    unsigned int index;
+    int16_t buffer[DELAY_NODE_LENGTH];
+} DelayNode;
+
+/**
+ * @brief Node descriptor structure.  A NULL process function indicates that
+ * the node type is not enabled at compile time.
+ */
+typedef struct {
+    const char* name;
+    size_t stateSize;
+    bool singleInstance;
+    void (*initialise)(void* const state);
+    void (*process)(void* const state, float* const samples, const unsigned int numberOfSamples);
+} NodeDescriptor;
+
+/**
+ * @brief Node structure.
+ */
+typedef struct {
+    EffectsChainNodeType type;
+    bool active;
+    void* state;
+    void (*process)(void* const state, float* const samples, const unsigned int numberOfSamples);
+    uint32_t ticks;
+    uint32_t maximumTicks;
+} Node;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void ApplyLayout(const EffectsChainLayout * const layout);
+static void* Allocate(const size_t size);
+static void LowPassFilterInitialise(void* const state);
+static void HighPassFilterInitialise(void* const state);
+static void FilterProcess(void* const state, float* const samples, const unsigned int numberOfSamples);
+static void SaturatorProcess(void* const state, float* const samples, const unsigned int numberOfSamples);
+static void DelayProcess(void* const state, float* const samples, const unsigned int numberOfSamples);
+#ifdef MODULATION_EFFECTS_ENABLED
+static void ModulationProcess(void* const state, float* const samples, const unsigned int numberOfSamples);
+#endif
+#ifdef REVERB_ENABLED
+static void ReverbNodeProcess(void* const state, float* const samples, const unsigned int numberOfSamples);
+#endif
+#ifdef CONVOLUTION_ENABLED
+static void ConvolutionNodeProcess(void* const state, float* const samples, const unsigned int numberOfSamples);
+#endif
+
+//------------------------------------------------------------------------------
+// Variables
+
+const EffectsChainLayout defaultEffectsChainLayout = {
+    .nodeTypes =
+    {
+        EffectsChainNodeTypeModulation,
+        EffectsChainNodeTypeReverb,
+        EffectsChainNodeTypeConvolution,
+    },
+};
+
+static const NodeDescriptor nodeDescriptors[EffectsChainNodeTypeNumberOfTypes] = {
+    [EffectsChainNodeTypeNone] =
+    {"none", 0, false, NULL, NULL},
+    [EffectsChainNodeTypeLowPassFilter] =
+    {"lowpass", sizeof (CascadeFilter), false, &LowPassFilterInitialise, &FilterProcess},
+    [EffectsChainNodeTypeHighPassFilter] =
+    {"highpass", sizeof (CascadeFilter), false, &HighPassFilterInitialise, &FilterProcess},
+    [EffectsChainNodeTypeSaturator] =
+    {"saturator", sizeof (SaturationOversampler), false, NULL, &SaturatorProcess},
+    [EffectsChainNodeTypeDelay] =
+    {"delay", sizeof (DelayNode), false, NULL, &DelayProcess},
+#ifdef MODULATION_EFFECTS_ENABLED
+    [EffectsChainNodeTypeModulation] =
+    {"modfx", 0, true, NULL, &ModulationProcess},
+#else
+    [EffectsChainNodeTypeModulation] =
+    {"modfx", 0, true, NULL, NULL},
+#endif
+#ifdef REVERB_ENABLED
+    [EffectsChainNodeTypeReverb] =
+    {"reverb", 0, true, NULL, &ReverbNodeProcess},
+#else
+    [EffectsChainNodeTypeReverb] =
+    {"reverb", 0, true, NULL, NULL},
+#endif
+#ifdef CONVOLUTION_ENABLED
+    [EffectsChainNodeTypeConvolution] =
+    {"convolution", 0, true, NULL, &ConvolutionNodeProcess},
+#else
+    [EffectsChainNodeTypeConvolution] =
+    {"convolution", 0, true, NULL, NULL},
+#endif
+};
+
+static uint32_t arena[EFFECTS_CHAIN_ARENA_SIZE / sizeof (uint32_t)]; // uint32_t for alignment
+static size_t arenaIndex;
+static Node nodes[EFFECTS_CHAIN_MAXIMUM_NUMBER_OF_NODES];
+static unsigned int numberOfNodes;
+static EffectsChainLayout requestedLayout;
+static volatile bool layoutChanged;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises module.  This function should be called once, on system
+ * start up, before the audio update is enabled.
+ */
+void EffectsChainInitialise() {
+#ifdef REVERB_ENABLED
+    ReverbInitialise();
+#endif
+#ifdef CONVOLUTION_ENABLED
+    ConvolutionInitialise();
+#endif
+    requestedLayout = defaultEffectsChainLayout;
+    ApplyLayout(&requestedLayout);
+}
+
+/**
+ * @brief Sets the layout of the chain.  The layout is applied at the start of
+ * the next block.
+ * @param layout Layout.
+ */
+void EffectsChainSetLayout(const EffectsChainLayout * const layout) {
+    layoutChanged = false; // prevent a partially written layout being applied
+    requestedLayout = *layout;
+    layoutChanged = true;
+}
+
+/**
+ * @brief Gets the most recently set layout of the chain.
+ * @param layout Layout.
+ */
+void EffectsChainGetLayout(EffectsChainLayout * const layout) {
+    *layout = requestedLayout;
+}
+
+/**
+ * @brief Gets node statistics.  The type of nodes beyond the end of the chain
+ * is EffectsChainNodeTypeNone.
+ * @param index Node index.
+ * @param nodeStatistics Node statistics.
+ */
+void EffectsChainGetNodeStatistics(const unsigned int index, EffectsChainNodeStatistics * const nodeStatistics) {
+    if (index >= numberOfNodes) {
+        nodeStatistics->type = EffectsChainNodeTypeNone;
+        nodeStatistics->active = false;
+        nodeStatistics->ticks = 0;
+        nodeStatistics->maximumTicks = 0;
+        return;
+    }
+    nodeStatistics->type = nodes[index].type;
+    nodeStatistics->active = nodes[index].active;
+    nodeStatistics->ticks = nodes[index].ticks;
+    nodeStatistics->maximumTicks = nodes[index].maximumTicks;
+}
+
+/**
+ * @brief Resets the maximum ticks of each node.
+ */
+void EffectsChainResetStatistics() {
+    unsigned int index;
+    for (index = 0; index < EFFECTS_CHAIN_MAXIMUM_NUMBER_OF_NODES; index++) {
+        nodes[index].maximumTicks = 0;
+    }
+}
+
+/**
+ * @brief Returns the node type name.
+ * @param type Node type.
+ * @return Node type name.
+ */
+const char* EffectsChainNodeTypeToString(const EffectsChainNodeType type) {
+    if (type >= EffectsChainNodeTypeNumberOfTypes) {
+        return "";
+    }
+    return nodeDescriptors[type].name;
+}
+
+/**
+ * @brief Processes a block of samples in place with each node in the chain.
+ * This function must only be called by the audio update.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+void EffectsChainProcess(float* const samples, const unsigned int numberOfSamples) {
+    if (layoutChanged == true) {
+        layoutChanged = false;
+        ApplyLayout(&requestedLayout);
+    }
+    unsigned int index;
+    for (index = 0; index < numberOfNodes; index++) {
+        Node * const node = &nodes[index];
+        if (node->active == false) {
+            continue;
+        }
+        const uint32_t startTicks = _CP0_GET_COUNT();
+        node->process(node->state, samples, numberOfSamples);
+        node->ticks = _CP0_GET_COUNT() - startTicks;
+        node->maximumTicks = MAX(node->maximumTicks, node->ticks);
+    }
+}
+
+/**
+ * @brief Discards all nodes and creates the nodes of the layout with state
+ * allocated from the arena.
+ * @param layout Layout.
+ */
+static void ApplyLayout(const EffectsChainLayout * const layout) {
+    arenaIndex = 0;
+    numberOfNodes = 0;
+    bool used[EffectsChainNodeTypeNumberOfTypes] = {false};
+    unsigned int index;
+    for (index = 0; index < EFFECTS_CHAIN_MAXIMUM_NUMBER_OF_NODES; index++) {
+        const EffectsChainNodeType type = layout->nodeTypes[index];
+        if ((type == EffectsChainNodeTypeNone) || (type >= EffectsChainNodeTypeNumberOfTypes)) {
+            break;
+        }
+        const NodeDescriptor * const descriptor = &nodeDescriptors[type];
+        Node * const node = &nodes[numberOfNodes++];
+        node->type = type;
+        node->active = false;
+        node->state = NULL;
+        node->process = descriptor->process;
+        node->ticks = 0;
+        node->maximumTicks = 0;
+        if ((descriptor->process == NULL) || ((descriptor->singleInstance == true) && (used[type] == true))) {
+            continue;
+        }
+        if (descriptor->stateSize > 0) {
+            node->state = Allocate(descriptor->stateSize);
+            if (node->state == NULL) {
+                continue;
+            }
+        }
+        if (descriptor->initialise != NULL) {
+            descriptor->initialise(node->state);
+        }
+        used[type] = true;
+        node->active = true;
+    }
+}
+
+/**
+ * @brief Allocates zeroed memory from the arena.
+ * @param size Size in bytes.
+ * @return Allocated memory, or NULL if the arena is exhausted.
+ */
+static void* Allocate(const size_t size) {
+    const size_t alignedSize = (size + (sizeof (uint32_t) - 1)) & ~(sizeof (uint32_t) - 1);
+    if ((arenaIndex + alignedSize) > sizeof (arena)) {
+        return NULL;
+    }
+    void* const memory = &((uint8_t*) arena)[arenaIndex];
+    arenaIndex += alignedSize;
+    memset(memory, 0, alignedSize);
+    return memory;
+}
+
+/**
+ * @brief Initialises low-pass filter node.
+ * @param state Node state.
+ */
+static void LowPassFilterInitialise(void* const state) {
+    CascadeFilterSetCornerFrequency((CascadeFilter*) state, LOW_PASS_FILTER_FREQUENCY, SAMPLE_FREQUENCY, false, FILTER_ORDER);
+}
+
+/**
+ * @brief Initialises high-pass filter node.
+ * @param state Node state.
+ */
+static void HighPassFilterInitialise(void* const state) {
+    CascadeFilterSetCornerFrequency((CascadeFilter*) state, HIGH_PASS_FILTER_FREQUENCY, SAMPLE_FREQUENCY, true, FILTER_ORDER);
+}
+
+/**
+ * @brief Processes filter node.
+ * @param state Node state.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+static void FilterProcess(void* const state, float* const samples, const unsigned int numberOfSamples) {
+    CascadeFilter * const cascadeFilter = (CascadeFilter*) state;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        samples[index] = CascadeFilterUpdate(cascadeFilter, samples[index]);
+    }
+}
+
+/**
+ * @brief Processes saturator node.
+ * @param state Node state.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+static void SaturatorProcess(void* const state, float* const samples, const unsigned int numberOfSamples) {
+    SaturationOversampler * const saturationOversampler = (SaturationOversampler*) state;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        samples[index] = (1.0f / SATURATOR_DRIVE) * SaturationOversampledSoftClip(saturationOversampler, SATURATOR_DRIVE * samples[index]);
+    }
+}
+
+/**
+ * @brief Processes delay node.  A short slapback echo with feedback.
+ * @param state Node state.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+static void DelayProcess(void* const state, float* const samples, const unsigned int numberOfSamples) {
+    DelayNode * const delayNode = (DelayNode*) state;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        const float delayed = (float) delayNode->buffer[delayNode->index] * (1.0f / 32768.0f);
+        delayNode->buffer[delayNode->index] = (int16_t) CLAMP((samples[index] + DELAY_NODE_FEEDBACK * delayed) * 32768.0f, -32768.0f, 32767.0f); // truncation towards zero prevents limit cycles
+        if (++delayNode->index >= DELAY_NODE_LENGTH) {
+            delayNode->index = 0;
+        }
+        samples[index] += DELAY_NODE_MIX * delayed;
+    }
+}
+
+#ifdef MODULATION_EFFECTS_ENABLED
+
+/**
+ * @brief Processes modulation effects node.
+ * @param state Unused.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+static void ModulationProcess(void* const state, float* const samples, const unsigned int numberOfSamples) {
+    ModulationEffectsProcess(samples, numberOfSamples);
+}
+
+#endif
+
+#ifdef REVERB_ENABLED
+
+/**
+ * @brief Processes reverb node.
+ * @param state Unused.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+static void ReverbNodeProcess(void* const state, float* const samples, const unsigned int numberOfSamples) {
+    ReverbProcess(samples, numberOfSamples);
+}
+
+#endif
+
+#ifdef CONVOLUTION_ENABLED
+
+/**
+ * @brief Processes convolution node.
+ * @param state Unused.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+static void ConvolutionNodeProcess(void* const state, float* const samples, const unsigned int numberOfSamples) {
+    ConvolutionProcess(samples, numberOfSamples);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
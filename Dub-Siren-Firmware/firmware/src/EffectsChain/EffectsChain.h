@@ -0,0 +1,84 @@
+/**
+ * @file EffectsChain.h
+ * @author Seb Madgwick
+ * @brief Ordered chain of block-processing effect nodes applied to the
+ * synthesiser output.
+ */
+
+#ifndef EFFECTS_CHAIN_H
+#define EFFECTS_CHAIN_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum number of nodes in the chain.
+ */
+#define EFFECTS_CHAIN_MAXIMUM_NUMBER_OF_NODES (6)
+
+/**
+ * @brief Size of the arena from which node state is allocated in bytes.  The
+ * synthesiser delay buffer is reduced by this amount.
+ */
+#define EFFECTS_CHAIN_ARENA_SIZE (8192)
+
+/**
+ * @brief Effects chain node type.  Values are stored in presets and so must
+ * not be reordered.
+ */
+typedef enum {
+    EffectsChainNodeTypeNone,
+    EffectsChainNodeTypeLowPassFilter,
+    EffectsChainNodeTypeHighPassFilter,
+    EffectsChainNodeTypeSaturator,
+    EffectsChainNodeTypeDelay,
+    EffectsChainNodeTypeModulation,
+    EffectsChainNodeTypeReverb,
+    EffectsChainNodeTypeConvolution,
+    EffectsChainNodeTypeNumberOfTypes,
+} EffectsChainNodeType;
+
+/**
+ * @brief Effects chain layout structure.  Node types are listed in processing
+ * order.  Unused entries are EffectsChainNodeTypeNone.
+ */
+typedef struct {
+    uint8_t nodeTypes[EFFECTS_CHAIN_MAXIMUM_NUMBER_OF_NODES];
+} EffectsChainLayout;
+
+/**
+ * @brief Effects chain node statistics structure.
+ */
+typedef struct {
+    EffectsChainNodeType type;
+    bool active; // false if the node type is unavailable or could not be allocated
+    uint32_t ticks; // core timer ticks for the most recent block
+    uint32_t maximumTicks; // core timer ticks for the longest block
+} EffectsChainNodeStatistics;
+
+//------------------------------------------------------------------------------
+// Variable declarations
+
+extern const EffectsChainLayout defaultEffectsChainLayout;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void EffectsChainInitialise();
+void EffectsChainSetLayout(const EffectsChainLayout * const layout);
+void EffectsChainGetLayout(EffectsChainLayout * const layout);
+void EffectsChainGetNodeStatistics(const unsigned int index, EffectsChainNodeStatistics * const nodeStatistics);
+void EffectsChainResetStatistics();
+const char* EffectsChainNodeTypeToString(const EffectsChainNodeType type);
+void EffectsChainProcess(float* const samples, const unsigned int numberOfSamples);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,180 @@
+/**
+ * @file FastMath.h
+ * @author Seb Madgwick
+ * @brief Fast single-precision approximations of math functions for use within
+ * the audio update.
+ *
+ * Maximum errors are measured against double-precision libm over the stated
+ * input range.  Polynomial coefficients are minimax fits.  None of these
+ * functions set errno or handle NaN or infinite inputs.
+ */
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <math.h> // fabsf, copysignf
+#include "MathHelpers.h"
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Float and integer representation of the same 32 bits.
+ */
+typedef union {
+    float floatValue;
+    int32_t intValue;
+} FastMathBits;
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Rounds float to nearest integer, with ties to even.  Branch-free.
+ * Exact for |value| < 2^22.
+ * @param value Value.
+ * @return Nearest integer.
+ */
+static inline __attribute__((always_inline)) int32_t FastMathRoundToInt(const float value) {
+    const FastMathBits bits = {.floatValue = value + 12582912.0f}; // 1.5 * 2^23 moves the integer part into the mantissa
+    return bits.intValue - 0x4B400000;
+}
+
+/**
+ * @brief Rounds float down to integer.  Branch-free on targets with
+ * conditional moves.  Exact for |value| < 2^31.
+ * @param value Value.
+ * @return Largest integer not greater than value.
+ */
+static inline __attribute__((always_inline)) int32_t FastMathFloorToInt(const float value) {
+    const int32_t truncated = (int32_t) value;
+    return truncated - (value < (float) truncated ? 1 : 0);
+}
+
+/**
+ * @brief Calculates 2^x.  Input is clamped to -125 to 127.  Maximum relative
+ * error is 2.4e-7.
+ * @param x Exponent.
+ * @return 2^x.
+ */
+static inline __attribute__((always_inline)) float FastMathExp2(const float x) {
+    const float clampedX = CLAMP(x, -125.0f, 127.0f);
+    const int32_t integer = FastMathRoundToInt(clampedX);
+    const float fraction = clampedX - (float) integer; // -0.5 to 0.5
+    FastMathBits bits;
+    bits.floatValue = 1.0000000717f + fraction * (0.6931469671f + fraction * (0.2402211972f + fraction * (0.05550713275f + fraction * (0.009675541330f + fraction * 0.001327647151f))));
+    bits.intValue += integer << 23;
+    return bits.floatValue;
+}
+
+/**
+ * @brief Calculates log2(x).  Input must be a positive normal number.  Maximum
+ * error is 4e-7, absolute for |log2(x)| <= 1 and relative otherwise.
+ * @param x Value.
+ * @return log2(x).
+ */
+static inline __attribute__((always_inline)) float FastMathLog2(const float x) {
+    FastMathBits bits = {.floatValue = x};
+    const int32_t exponent = (bits.intValue - 0x3F2AAAAB) >> 23; // 0x3F2AAAAB is 2/3
+    bits.intValue -= exponent << 23; // mantissa in range 2/3 to 4/3
+    const float t = bits.floatValue - 1.0f;
+    return (float) exponent + t * (1.442693586f + t * (-0.7214026978f + t * (0.4810667797f + t * (-0.3577288912f + t * (0.2836528902f + t * (-0.2842508455f + t * 0.2570909674f))))));
+}
+
+/**
+ * @brief Calculates sin(2 * pi * cycles).  Branch-free.  Maximum absolute error
+ * is 2.5e-7 for |cycles| <= 1.
+ * @param cycles Angle in cycles.
+ * @return sin(2 * pi * cycles).
+ */
+static inline __attribute__((always_inline)) float FastMathSinCycles(const float cycles) {
+    const float wrapped = cycles - (float) FastMathRoundToInt(cycles); // -0.5 to 0.5
+    const float u = 0.25f - fabsf(wrapped); // sin(2 * pi * wrapped) = +/-cos(2 * pi * u), where u is -0.25 to 0.25
+    const float u2 = u * u;
+    const float cosine = 0.9999999535f + u2 * (-19.73917145f + u2 * (64.93459128f + u2 * (-85.24034421f + u2 * 56.24247914f)));
+    return copysignf(cosine, wrapped);
+}
+
+/**
+ * @brief Calculates sin(x).  Maximum absolute error is 1e-6 for |x| <= 2 * pi.
+ * Error increases with |x| because of range reduction.
+ * @param x Angle in radians.
+ * @return sin(x).
+ */
+static inline __attribute__((always_inline)) float FastMathSin(const float x) {
+    return FastMathSinCycles(x * (float) (1.0 / (2.0 * M_PI)));
+}
+
+/**
+ * @brief Calculates cos(x).  Maximum absolute error is 1e-6 for |x| <= 2 * pi.
+ * Error increases with |x| because of range reduction.
+ * @param x Angle in radians.
+ * @return cos(x).
+ */
+static inline __attribute__((always_inline)) float FastMathCos(const float x) {
+    return FastMathSinCycles(x * (float) (1.0 / (2.0 * M_PI)) + 0.25f);
+}
+
+/**
+ * @brief Calculates tan(x) for bilinear transform prewarping.  Maximum relative
+ * error is 2.2e-7 for |x| <= pi / 4 and 1.4e-6 for |x| <= 1.5.
+ * @param x Angle in radians.
+ * @return tan(x).
+ */
+static inline __attribute__((always_inline)) float FastMathTan(const float x) {
+    const float x2 = x * x;
+    const float numerator = x * (135135.0f + x2 * (-17325.0f + x2 * (378.0f - x2)));
+    const float denominator = 135135.0f + x2 * (-62370.0f + x2 * (3150.0f - 28.0f * x2));
+    return numerator / denominator;
+}
+
+/**
+ * @brief Calculates tanh(x) for saturation.  Maximum absolute error is 1.5e-7.
+ * @param x Value.
+ * @return tanh(x).
+ */
+static inline __attribute__((always_inline)) float FastMathTanh(const float x) {
+    const float exp2x = FastMathExp2(CLAMP(x, -20.0f, 20.0f) * (float) (2.0 / M_LN2));
+    return (exp2x - 1.0f) / (exp2x + 1.0f);
+}
+
+/**
+ * @brief Calculates 1 / x.  Uses the FPU reciprocal instruction if available,
+ * otherwise division.  Maximum error is 1 ULP.
+ * @param x Value.
+ * @return 1 / x.
+ */
+static inline __attribute__((always_inline)) float FastMathReciprocal(const float x) {
+#ifdef __mips_hard_float
+    float result;
+    __asm__("recip.s %0, %1" : "=f" (result) : "f" (x));
+    return result;
+#else
+    return 1.0f / x;
+#endif
+}
+
+/**
+ * @brief Calculates 1 / sqrt(x).  Uses the FPU reciprocal square root
+ * instruction if available, otherwise division.  Maximum error is 1 ULP.
+ * @param x Value greater than zero.
+ * @return 1 / sqrt(x).
+ */
+static inline __attribute__((always_inline)) float FastMathReciprocalSquareRoot(const float x) {
+#ifdef __mips_hard_float
+    float result;
+    __asm__("rsqrt.s %0, %1" : "=f" (result) : "f" (x));
+    return result;
+#else
+    return 1.0f / sqrtf(x);
+#endif
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
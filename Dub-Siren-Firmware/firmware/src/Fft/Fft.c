@@ -0,0 +1,177 @@
+/**
+ * @file Fft.c
+ * @author Seb Madgwick
+ * @brief Fixed-size real FFT.
+ *
+ * The real transform of FFT_SIZE samples is calculated as a complex transform
+ * of FFT_SIZE / 2 samples, with even samples as the real part and odd samples
+ * as the imaginary part, followed by a split step.  The complex transform is
+ * an in-place iterative radix-2 decimation-in-time FFT.  Twiddle factors and
+ * the bit-reversal permutation are calculated once by FftInitialise so that
+ * the transform requires only single-precision multiply-adds.
+ *
+ * Spectra are packed into FFT_SIZE floats: data[0] is the real DC bin,
+ * data[1] is the real Nyquist bin, and data[2k] and data[2k + 1] are the real
+ * and imaginary parts of bin k for k = 1 to FFT_SIZE / 2 - 1.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "FastMath/FastMath.h"
+#include "Fft.h"
+#include "MathHelpers.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Complex transform size.
+ */
+#define COMPLEX_SIZE (FFT_SIZE / 2)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void ComplexTransform(float* const data, const bool inverse);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static float twiddleReal[COMPLEX_SIZE]; // cos(2 * pi * k / FFT_SIZE)
+static float twiddleImaginary[COMPLEX_SIZE]; // -sin(2 * pi * k / FFT_SIZE)
+static uint8_t bitReverse[COMPLEX_SIZE];
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises module.  This function should be called once, on system
+ * start up.
+ */
+void FftInitialise() {
+    unsigned int index;
+    for (index = 0; index < COMPLEX_SIZE; index++) {
+        const float angle = (float) (2.0 * M_PI / FFT_SIZE) * (float) index;
+        twiddleReal[index] = FastMathCos(angle);
+        twiddleImaginary[index] = -FastMathSin(angle);
+        unsigned int reversed = 0;
+        unsigned int bit;
+        for (bit = 1; bit < COMPLEX_SIZE; bit <<= 1) {
+            reversed = (reversed << 1) | ((index & bit) != 0);
+        }
+        bitReverse[index] = reversed;
+    }
+}
+
+/**
+ * @brief Calculates the FFT of real samples in place.
+ * @param data FFT_SIZE real samples.  Replaced by the packed spectrum.
+ */
+void FftRealForward(float* const data) {
+    ComplexTransform(data, false);
+
+    // DC and Nyquist bins
+    const float dcReal = data[0];
+    const float dcImaginary = data[1];
+    data[0] = dcReal + dcImaginary;
+    data[1] = dcReal - dcImaginary;
+
+    // Split remaining bins in pairs k and COMPLEX_SIZE - k
+    unsigned int k;
+    for (k = 1; k <= (COMPLEX_SIZE / 2); k++) {
+        const unsigned int j = COMPLEX_SIZE - k;
+        const float evenReal = 0.5f * (data[2 * k] + data[2 * j]);
+        const float evenImaginary = 0.5f * (data[2 * k + 1] - data[2 * j + 1]);
+        const float oddReal = 0.5f * (data[2 * k + 1] + data[2 * j + 1]);
+        const float oddImaginary = 0.5f * (data[2 * j] - data[2 * k]);
+        const float rotatedReal = twiddleReal[k] * oddReal - twiddleImaginary[k] * oddImaginary;
+        const float rotatedImaginary = twiddleReal[k] * oddImaginary + twiddleImaginary[k] * oddReal;
+        data[2 * k] = evenReal + rotatedReal;
+        data[2 * k + 1] = evenImaginary + rotatedImaginary;
+        data[2 * j] = evenReal - rotatedReal;
+        data[2 * j + 1] = rotatedImaginary - evenImaginary;
+    }
+}
+
+/**
+ * @brief Calculates the inverse FFT of a packed spectrum in place.  The result
+ * is not normalised and so is the original samples multiplied by FFT_SIZE.
+ * @param data Packed spectrum.  Replaced by FFT_SIZE real samples.
+ */
+void FftRealInverse(float* const data) {
+
+    // DC and Nyquist bins
+    const float dc = data[0];
+    const float nyquist = data[1];
+    data[0] = dc + nyquist;
+    data[1] = dc - nyquist;
+
+    // Merge remaining bins in pairs k and COMPLEX_SIZE - k
+    unsigned int k;
+    for (k = 1; k <= (COMPLEX_SIZE / 2); k++) {
+        const unsigned int j = COMPLEX_SIZE - k;
+        const float evenReal = data[2 * k] + data[2 * j];
+        const float evenImaginary = data[2 * k + 1] - data[2 * j + 1];
+        const float rotatedReal = data[2 * k] - data[2 * j];
+        const float rotatedImaginary = data[2 * k + 1] + data[2 * j + 1];
+        const float oddReal = twiddleReal[k] * rotatedReal + twiddleImaginary[k] * rotatedImaginary; // multiply by conjugate twiddle
+        const float oddImaginary = twiddleReal[k] * rotatedImaginary - twiddleImaginary[k] * rotatedReal;
+        data[2 * k] = evenReal - oddImaginary;
+        data[2 * k + 1] = evenImaginary + oddReal;
+        data[2 * j] = evenReal + oddImaginary;
+        data[2 * j + 1] = oddReal - evenImaginary;
+    }
+
+    ComplexTransform(data, true);
+}
+
+/**
+ * @brief Calculates the unnormalised complex FFT of COMPLEX_SIZE interleaved
+ * samples in place.
+ * @param data Interleaved real and imaginary parts.
+ * @param inverse True for the inverse transform.
+ */
+static void ComplexTransform(float* const data, const bool inverse) {
+
+    // Bit-reversal permutation
+    unsigned int index;
+    for (index = 0; index < COMPLEX_SIZE; index++) {
+        const unsigned int reversed = bitReverse[index];
+        if (reversed > index) {
+            const float real = data[2 * index];
+            const float imaginary = data[2 * index + 1];
+            data[2 * index] = data[2 * reversed];
+            data[2 * index + 1] = data[2 * reversed + 1];
+            data[2 * reversed] = real;
+            data[2 * reversed + 1] = imaginary;
+        }
+    }
+
+    // Butterflies
+    const float sign = inverse ? -1.0f : 1.0f;
+    unsigned int half;
+    for (half = 1; half < COMPLEX_SIZE; half <<= 1) {
+        const unsigned int stride = COMPLEX_SIZE / half; // twiddle index stride for FFT_SIZE table
+        unsigned int butterfly;
+        for (butterfly = 0; butterfly < half; butterfly++) {
+            const float wReal = twiddleReal[butterfly * stride];
+            const float wImaginary = sign * twiddleImaginary[butterfly * stride];
+            unsigned int top;
+            for (top = butterfly; top < COMPLEX_SIZE; top += 2 * half) {
+                const unsigned int bottom = top + half;
+                const float real = wReal * data[2 * bottom] - wImaginary * data[2 * bottom + 1];
+                const float imaginary = wReal * data[2 * bottom + 1] + wImaginary * data[2 * bottom];
+                data[2 * bottom] = data[2 * top] - real;
+                data[2 * bottom + 1] = data[2 * top + 1] - imaginary;
+                data[2 * top] += real;
+                data[2 * top + 1] += imaginary;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// End of file
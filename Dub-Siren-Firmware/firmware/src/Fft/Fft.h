@@ -0,0 +1,28 @@
+/**
+ * @file Fft.h
+ * @author Seb Madgwick
+ * @brief Fixed-size real FFT.
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief FFT size in real samples.  Must be a power of two.
+ */
+#define FFT_SIZE (64)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void FftInitialise();
+void FftRealForward(float* const data);
+void FftRealInverse(float* const data);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,52 @@
+/**
+ * @file CascadeFilterQ31.c
+ * @author Seb Madgwick
+ * @brief Cascaded first-order low-pass or high-pass filter using Q31
+ * fixed-point arithmetic.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "CascadeFilterQ31.h"
+#include "MathHelpers.h"
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Sets the filter corner frequency of each filter in the cascade.
+ * @param cascadeFilterQ31 Cascade Q31 filter structure.
+ * @param cornerFrequency Corner frequency in Hz.
+ * @param sampleFrequency Sample frequency in Hz.
+ * @param isHighPass True if high-pass filter, False if low-pass filter.
+ * @param numberOfFilters Number of filters in the cascade.
+ */
+void CascadeFilterQ31SetCornerFrequency(CascadeFilterQ31 * const cascadeFilterQ31, const float cornerFrequency, const float sampleFrequency, const bool isHighPass, const unsigned int numberOfFilters) {
+    cascadeFilterQ31->numberOfFilters = CLAMP(numberOfFilters, 1, MAXIMUM_NUMBER_OF_CASCADED_FILTERS);
+    FirstOrderFilterQ31SetCornerFrequency(&cascadeFilterQ31->firstOrderFilterQ31[0], cornerFrequency, sampleFrequency, isHighPass);
+    unsigned int index;
+    for (index = 1; index < cascadeFilterQ31->numberOfFilters; index++) {
+        cascadeFilterQ31->firstOrderFilterQ31[index].isHighPass = isHighPass;
+        cascadeFilterQ31->firstOrderFilterQ31[index].coefficient = cascadeFilterQ31->firstOrderFilterQ31[0].coefficient; // avoid repeated calculations
+    }
+}
+
+/**
+ * @brief Updates each filter in the cascade with the new input sample and
+ * returns the output.
+ * @param cascadeFilterQ31 Cascade Q31 filter structure.
+ * @param input Input sample.
+ * @return Cascaded filter output.
+ */
+q31 CascadeFilterQ31Update(CascadeFilterQ31 * const cascadeFilterQ31, const q31 input) {
+    q31 output = input;
+    unsigned int index;
+    for (index = 0; index < cascadeFilterQ31->numberOfFilters; index++) {
+        output = FirstOrderFilterQ31Update(&cascadeFilterQ31->firstOrderFilterQ31[index], output);
+    }
+    return output;
+}
+
+//------------------------------------------------------------------------------
+// End of file
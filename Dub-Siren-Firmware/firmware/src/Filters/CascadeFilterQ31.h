@@ -0,0 +1,38 @@
+/**
+ * @file CascadeFilterQ31.h
+ * @author Seb Madgwick
+ * @brief Cascaded first-order low-pass or high-pass filter using Q31
+ * fixed-point arithmetic.
+ */
+
+#ifndef CASCADE_FILTER_Q31_H
+#define CASCADE_FILTER_Q31_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "CascadeFilter.h" // MAXIMUM_NUMBER_OF_CASCADED_FILTERS
+#include "FirstOrderFilterQ31.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Cascade Q31 filter structure.  Structure members are used internally
+ * and should not be used by the user application.
+ */
+typedef struct {
+    unsigned int numberOfFilters;
+    FirstOrderFilterQ31 firstOrderFilterQ31[MAXIMUM_NUMBER_OF_CASCADED_FILTERS];
+} CascadeFilterQ31;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void CascadeFilterQ31SetCornerFrequency(CascadeFilterQ31 * const cascadeFilterQ31, const float cornerFrequency, const float sampleFrequency, const bool isHighPass, const unsigned int numberOfFilters);
+q31 CascadeFilterQ31Update(CascadeFilterQ31 * const cascadeFilterQ31, const q31 input);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
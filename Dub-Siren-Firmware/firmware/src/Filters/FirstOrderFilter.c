@@ -12,6 +12,7 @@
 
 #include "FirstOrderFilter.h"
 #include "math.h" // M_PI
+#include "MathHelpers.h"
 
 //------------------------------------------------------------------------------
 // Functions
@@ -46,6 +47,7 @@ float FirstOrderFilterUpdate(FirstOrderFilter * const firstOrderFilter, const fl
     } else {
         output = firstOrderFilter->previousOutput + ((input - firstOrderFilter->previousOutput) * firstOrderFilter->coefficient);
     }
+    output = QUANTISE_TO_ZERO(output); // prevent subnormal values as output decays
     firstOrderFilter->previousInput = input;
     firstOrderFilter->previousOutput = output;
     return output;
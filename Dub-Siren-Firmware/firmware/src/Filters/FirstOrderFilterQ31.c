@@ -0,0 +1,53 @@
+/**
+ * @file FirstOrderFilterQ31.c
+ * @author Seb Madgwick
+ * @brief First-order low-pass or high-pass filter using Q31 fixed-point
+ * arithmetic.
+ *
+ * Equivalent to FirstOrderFilter with saturating arithmetic.  Decaying outputs
+ * reach zero without the subnormal values of the float implementation.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "FirstOrderFilter.h"
+#include "FirstOrderFilterQ31.h"
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Sets the filter corner frequency.
+ * @param firstOrderFilterQ31 First-order Q31 filter structure.
+ * @param cornerFrequency Corner frequency in Hz.
+ * @param sampleFrequency Sample frequency in Hz.
+ * @param isHighPass True if high-pass filter, false if low-pass filter.
+ */
+void FirstOrderFilterQ31SetCornerFrequency(FirstOrderFilterQ31 * const firstOrderFilterQ31, const float cornerFrequency, const float sampleFrequency, const bool isHighPass) {
+    FirstOrderFilter firstOrderFilter;
+    FirstOrderFilterSetCornerFrequency(&firstOrderFilter, cornerFrequency, sampleFrequency, isHighPass);
+    firstOrderFilterQ31->isHighPass = isHighPass;
+    firstOrderFilterQ31->coefficient = Q31FromFloat(firstOrderFilter.coefficient);
+}
+
+/**
+ * @brief Updates the filter with the new input sample and returns the output.
+ * @param firstOrderFilterQ31 First-order Q31 filter structure.
+ * @param input Input sample.
+ * @return First-order filter output.
+ */
+q31 FirstOrderFilterQ31Update(FirstOrderFilterQ31 * const firstOrderFilterQ31, const q31 input) {
+    q31 output;
+    if (firstOrderFilterQ31->isHighPass == true) {
+        output = Q31Multiply(firstOrderFilterQ31->coefficient, Q31Add(firstOrderFilterQ31->previousOutput, Q31Subtract(input, firstOrderFilterQ31->previousInput)));
+    } else {
+        output = Q31Add(firstOrderFilterQ31->previousOutput, Q31Multiply(Q31Subtract(input, firstOrderFilterQ31->previousOutput), firstOrderFilterQ31->coefficient));
+    }
+    firstOrderFilterQ31->previousInput = input;
+    firstOrderFilterQ31->previousOutput = output;
+    return output;
+}
+
+//------------------------------------------------------------------------------
+// End of file
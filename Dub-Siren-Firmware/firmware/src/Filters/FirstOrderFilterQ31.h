@@ -0,0 +1,40 @@
+/**
+ * @file FirstOrderFilterQ31.h
+ * @author Seb Madgwick
+ * @brief First-order low-pass or high-pass filter using Q31 fixed-point
+ * arithmetic.
+ */
+
+#ifndef FIRST_ORDER_FILTER_Q31_H
+#define FIRST_ORDER_FILTER_Q31_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "FixedPoint/Q31.h"
+#include <stdbool.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief First-order Q31 filter structure.  Structure members are used
+ * internally and should not be used by the user application.
+ */
+typedef struct {
+    bool isHighPass; // else is low-pass
+    q31 previousInput;
+    q31 previousOutput;
+    q31 coefficient;
+} FirstOrderFilterQ31;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void FirstOrderFilterQ31SetCornerFrequency(FirstOrderFilterQ31 * const firstOrderFilterQ31, const float cornerFrequency, const float sampleFrequency, const bool isHighPass);
+q31 FirstOrderFilterQ31Update(FirstOrderFilterQ31 * const firstOrderFilterQ31, const q31 input);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,188 @@
+/**
+ * @file Q31.h
+ * @author Seb Madgwick
+ * @brief Saturating Q31 fixed-point arithmetic.
+ *
+ * Uses the MIPS DSP ASE if enabled by the compiler (-mdspr2), otherwise a
+ * portable C reference implementation.  The reference functions are always
+ * available and produce bit-exact results to the DSP ASE instructions.
+ */
+
+#ifndef Q31_H
+#define Q31_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Q31 fixed-point type.  Range is -1.0 to 1.0 - 2^-31.
+ */
+typedef int32_t q31;
+
+/**
+ * @brief Maximum Q31 value.
+ */
+#define Q31_MAX ((q31) INT32_MAX)
+
+/**
+ * @brief Minimum Q31 value.
+ */
+#define Q31_MIN ((q31) INT32_MIN)
+
+/**
+ * @brief Description of the implementation compiled.  The firmware must be
+ * compiled with -mdspr2 so that the DSP ASE is used on the target.
+ */
+#if defined(__mips_dspr2)
+#define Q31_IMPLEMENTATION "DSP ASE rev 2"
+#elif defined(__mips_dsp)
+#define Q31_IMPLEMENTATION "DSP ASE"
+#elif defined(__XC32)
+#error "Q31 arithmetic requires the DSP ASE.  Add -mdspr2 to the XC32 compiler options."
+#else
+#define Q31_IMPLEMENTATION "C reference"
+#endif
+
+//------------------------------------------------------------------------------
+// Inline functions - Reference
+
+/**
+ * @brief Saturating addition.  Reference implementation of ADDQ_S.W.
+ * @param a A.
+ * @param b B.
+ * @return a + b.
+ */
+static inline __attribute__((always_inline)) q31 Q31AddReference(const q31 a, const q31 b) {
+    const int64_t sum = (int64_t) a + (int64_t) b;
+    return sum > Q31_MAX ? Q31_MAX : (sum < Q31_MIN ? Q31_MIN : (q31) sum);
+}
+
+/**
+ * @brief Saturating subtraction.  Reference implementation of SUBQ_S.W.
+ * @param a A.
+ * @param b B.
+ * @return a - b.
+ */
+static inline __attribute__((always_inline)) q31 Q31SubtractReference(const q31 a, const q31 b) {
+    const int64_t difference = (int64_t) a - (int64_t) b;
+    return difference > Q31_MAX ? Q31_MAX : (difference < Q31_MIN ? Q31_MIN : (q31) difference);
+}
+
+/**
+ * @brief Rounding, saturating multiplication.  Reference implementation of
+ * MULQ_RS.W.
+ * @param a A.
+ * @param b B.
+ * @return a * b.
+ */
+static inline __attribute__((always_inline)) q31 Q31MultiplyReference(const q31 a, const q31 b) {
+    if ((a == Q31_MIN) && (b == Q31_MIN)) {
+        return Q31_MAX; // -1.0 * -1.0 saturates
+    }
+    return (q31) ((((int64_t) a * (int64_t) b) + (INT64_C(1) << 30)) >> 31);
+}
+
+/**
+ * @brief Arithmetic shift right with rounding.  Reference implementation of
+ * SHRA_R.W.
+ * @param value Value.
+ * @param shift Shift, 1 to 31.
+ * @return value / 2^shift, rounded.
+ */
+static inline __attribute__((always_inline)) int32_t Q31ShiftRightRoundReference(const q31 value, const unsigned int shift) {
+    return (int32_t) ((((int64_t) value) + (INT64_C(1) << (shift - 1))) >> shift);
+}
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Saturating addition.
+ * @param a A.
+ * @param b B.
+ * @return a + b.
+ */
+static inline __attribute__((always_inline)) q31 Q31Add(const q31 a, const q31 b) {
+#ifdef __mips_dsp
+    return __builtin_mips_addq_s_w(a, b);
+#else
+    return Q31AddReference(a, b);
+#endif
+}
+
+/**
+ * @brief Saturating subtraction.
+ * @param a A.
+ * @param b B.
+ * @return a - b.
+ */
+static inline __attribute__((always_inline)) q31 Q31Subtract(const q31 a, const q31 b) {
+#ifdef __mips_dsp
+    return __builtin_mips_subq_s_w(a, b);
+#else
+    return Q31SubtractReference(a, b);
+#endif
+}
+
+/**
+ * @brief Rounding, saturating multiplication.
+ * @param a A.
+ * @param b B.
+ * @return a * b.
+ */
+static inline __attribute__((always_inline)) q31 Q31Multiply(const q31 a, const q31 b) {
+#ifdef __mips_dspr2
+    return __builtin_mips_mulq_rs_w(a, b);
+#else
+    return Q31MultiplyReference(a, b);
+#endif
+}
+
+/**
+ * @brief Arithmetic shift right with rounding.  The shift must be a
+ * compile-time constant if the DSP ASE is used.
+ * @param value Value.
+ * @param shift Shift, 1 to 31.
+ * @return value / 2^shift, rounded.
+ */
+static inline __attribute__((always_inline)) int32_t Q31ShiftRightRound(const q31 value, const unsigned int shift) {
+#ifdef __mips_dsp
+    return __builtin_mips_shra_r_w(value, shift);
+#else
+    return Q31ShiftRightRoundReference(value, shift);
+#endif
+}
+
+/**
+ * @brief Converts float to Q31, saturating values outside of -1.0 to 1.0.
+ * @param value Float value.
+ * @return Q31 value.
+ */
+static inline __attribute__((always_inline)) q31 Q31FromFloat(const float value) {
+    if (value >= 1.0f) {
+        return Q31_MAX;
+    }
+    if (value <= -1.0f) {
+        return Q31_MIN;
+    }
+    return (q31) (value * 2147483648.0f);
+}
+
+/**
+ * @brief Converts Q31 to float.
+ * @param value Q31 value.
+ * @return Float value.
+ */
+static inline __attribute__((always_inline)) float Q31ToFloat(const q31 value) {
+    return (float) value * (1.0f / 2147483648.0f);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,75 @@
+/**
+ * @file Fpu.c
+ * @author Seb Madgwick
+ * @brief FPU control for PIC32MZ.
+ *
+ * The FS bit of the FCSR causes subnormal operands and results to be replaced
+ * by zero.  Without this, the FPU may take many additional cycles to handle
+ * subnormal values, e.g. in the decaying tail of a recursive filter.  See
+ * section 50 of the PIC32 Family Reference Manual (Floating Point Unit).
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Fpu.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief FCSR FS (flush to zero) bit mask.
+ */
+#define FCSR_FS_MASK (1u << 24)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static inline __attribute__((always_inline)) unsigned int ReadFcsr();
+static inline __attribute__((always_inline)) void WriteFcsr(const unsigned int fcsr);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Enables or disables flush-to-zero mode.  This function should be
+ * called on system start up, before any interrupts that use the FPU are
+ * enabled.
+ * @param enabled True to enable flush-to-zero mode.
+ */
+void FpuSetFlushToZero(const bool enabled) {
+    if (enabled == true) {
+        WriteFcsr(ReadFcsr() | FCSR_FS_MASK);
+    } else {
+        WriteFcsr(ReadFcsr() & ~FCSR_FS_MASK);
+    }
+}
+
+/**
+ * @brief Returns true if flush-to-zero mode is enabled.
+ * @return True if flush-to-zero mode is enabled.
+ */
+bool FpuGetFlushToZero() {
+    return (ReadFcsr() & FCSR_FS_MASK) != 0;
+}
+
+/**
+ * @brief Reads the FPU control and status register.
+ * @return FCSR value.
+ */
+static inline __attribute__((always_inline)) unsigned int ReadFcsr() {
+    unsigned int fcsr;
+    __asm__ volatile("cfc1 %0, $31" : "=r" (fcsr));
+    return fcsr;
+}
+
+/**
+ * @brief Writes the FPU control and status register.
+ * @param fcsr FCSR value.
+ */
+static inline __attribute__((always_inline)) void WriteFcsr(const unsigned int fcsr) {
+    __asm__ volatile("ctc1 %0, $31" : : "r" (fcsr));
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,24 @@
+/**
+ * @file Fpu.h
+ * @author Seb Madgwick
+ * @brief FPU control for PIC32MZ.
+ */
+
+#ifndef FPU_H
+#define FPU_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void FpuSetFlushToZero(const bool enabled);
+bool FpuGetFlushToZero();
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -10,7 +10,7 @@
 //------------------------------------------------------------------------------
 // Includes
 
-#include <math.h> // floorf
+#include <math.h> // fabsf, floorf
 
 //------------------------------------------------------------------------------
 // Definitions
@@ -40,6 +40,19 @@
  */
 #define MAP(x, x1, x2, y1, y2) ((((float)(x)) - ((float)(x1))) / (((float)(x2)) - ((float)(x1))) * (((float)(y2)) - ((float)(y1))) + ((float)(y1)))
 
+/**
+ * @brief Threshold below which QUANTISE_TO_ZERO replaces a value with zero.
+ * Equivalent to -300 dBFS, well above the subnormal range.
+ */
+#define QUANTISE_TO_ZERO_THRESHOLD (1e-15f)
+
+/**
+ * @brief Returns zero if float value is negligibly small.  Applied to the state
+ * of recursive filters and feedback loops so that decaying tails reach zero
+ * instead of subnormal values.
+ */
+#define QUANTISE_TO_ZERO(value) (fabsf(value) < QUANTISE_TO_ZERO_THRESHOLD ? 0.0f : (value))
+
 #endif
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,281 @@
+/**
+ * @file ModulationEffects.c
+ * @author Seb Madgwick
+ * @brief Chorus, flanger and phaser modulation effects.
+ *
+ * The chorus and flanger are short modulated delays that share a small
+ * dedicated buffer, separate from the synthesiser delay buffer.  Delayed
+ * samples are read with linear interpolation.  The chorus mixes two taps
+ * modulated in antiphase.  The flanger mixes one tap with feedback.  The
+ * phaser is a chain of first-order all-pass filters with feedback.
+ *
+ * The LFO is evaluated once per block using the sine waveform table.  The
+ * chorus and flanger delays are ramped linearly across each block to avoid
+ * zipper noise.  The phaser all-pass coefficient is updated once per block.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "ModulationEffects.h"
+
+#ifdef MODULATION_EFFECTS_ENABLED
+
+#include "Dac/Dac.h" // SAMPLE_FREQUENCY
+#include "FastMath/FastMath.h"
+#include "MathHelpers.h"
+#include <string.h> // memset
+#include "Synthesiser/Waveforms.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Chorus parameters.  Delays are in seconds.  The maximum delay must
+ * be less than MODULATION_EFFECTS_BUFFER_SIZE.
+ */
+#define CHORUS_DELAY (0.012f)
+#define CHORUS_DEPTH (0.004f)
+#define CHORUS_RATE (0.8f)
+#define CHORUS_MIX (0.5f)
+
+/**
+ * @brief Flanger parameters.  Delays are in seconds.
+ */
+#define FLANGER_DELAY (0.0015f)
+#define FLANGER_DEPTH (0.0013f)
+#define FLANGER_RATE (0.2f)
+#define FLANGER_FEEDBACK (0.7f)
+#define FLANGER_MIX (0.5f)
+
+/**
+ * @brief Phaser parameters.  Frequencies are in Hz.
+ */
+#define PHASER_MINIMUM_FREQUENCY (200.0f)
+#define PHASER_MAXIMUM_FREQUENCY (4000.0f)
+#define PHASER_RATE (0.4f)
+#define PHASER_FEEDBACK (0.5f)
+#define PHASER_MIX (0.5f)
+
+/**
+ * @brief Number of phaser all-pass stages.  Each pair of stages creates one
+ * notch.
+ */
+#define NUMBER_OF_PHASER_STAGES (6)
+
+/**
+ * @brief Buffer index mask.
+ */
+#define BUFFER_MASK (MODULATION_EFFECTS_BUFFER_SIZE - 1)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void Reset();
+static float UpdateLfo(const float rate, const unsigned int numberOfSamples);
+static void ProcessChorus(float* const samples, const unsigned int numberOfSamples);
+static void ProcessFlanger(float* const samples, const unsigned int numberOfSamples);
+static void ProcessPhaser(float* const samples, const unsigned int numberOfSamples);
+static inline __attribute__((always_inline)) float ReadBuffer(const float delay);
+static inline __attribute__((always_inline)) void WriteBuffer(const float sample);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static volatile ModulationEffect requestedEffect;
+static ModulationEffect activeEffect;
+static float buffer[MODULATION_EFFECTS_BUFFER_SIZE];
+static unsigned int bufferIndex;
+static float lfoPhase;
+static float previousDelays[2];
+static float feedbackSample;
+static float phaserStates[NUMBER_OF_PHASER_STAGES];
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Sets the modulation effect.  The effect state is reset by the next
+ * call of ModulationEffectsProcess.
+ * @param effect Effect.
+ */
+void ModulationEffectsSetEffect(const ModulationEffect effect) {
+    requestedEffect = effect;
+}
+
+/**
+ * @brief Applies the modulation effect to a block of samples in place.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+void ModulationEffectsProcess(float* const samples, const unsigned int numberOfSamples) {
+    const ModulationEffect effect = requestedEffect;
+    if (effect != activeEffect) {
+        activeEffect = effect;
+        Reset();
+    }
+    switch (activeEffect) {
+        case ModulationEffectOff:
+            break;
+        case ModulationEffectChorus:
+            ProcessChorus(samples, numberOfSamples);
+            break;
+        case ModulationEffectFlanger:
+            ProcessFlanger(samples, numberOfSamples);
+            break;
+        case ModulationEffectPhaser:
+            ProcessPhaser(samples, numberOfSamples);
+            break;
+        case ModulationEffectNumberOfEffects:
+            break;
+    }
+}
+
+/**
+ * @brief Clears the buffer and state so that the new effect does not start
+ * with the tail of the previous effect.
+ */
+static void Reset() {
+    memset(buffer, 0, sizeof (buffer));
+    memset(phaserStates, 0, sizeof (phaserStates));
+    feedbackSample = 0.0f;
+    lfoPhase = 0.0f;
+    previousDelays[0] = -1.0f; // indicates no previous delay
+}
+
+/**
+ * @brief Advances the LFO phase by one block.
+ * @param rate LFO frequency in Hz.
+ * @param numberOfSamples Number of samples.
+ * @return LFO phase as a normalised period.
+ */
+static float UpdateLfo(const float rate, const unsigned int numberOfSamples) {
+    lfoPhase += rate * (float) numberOfSamples * (1.0f / SAMPLE_FREQUENCY);
+    if (lfoPhase >= 1.0f) {
+        lfoPhase -= 1.0f;
+    }
+    return lfoPhase;
+}
+
+/**
+ * @brief Processes a block with the chorus.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+static void ProcessChorus(float* const samples, const unsigned int numberOfSamples) {
+
+    // Calculate target delays of antiphase taps
+    const float phase = UpdateLfo(CHORUS_RATE, numberOfSamples);
+    const float modulation = (CHORUS_DEPTH * SAMPLE_FREQUENCY) * WaveformsSine(phase);
+    const float delays[2] = {
+        (CHORUS_DELAY * SAMPLE_FREQUENCY) + modulation,
+        (CHORUS_DELAY * SAMPLE_FREQUENCY) - modulation,
+    };
+    if (previousDelays[0] < 0.0f) {
+        previousDelays[0] = delays[0];
+        previousDelays[1] = delays[1];
+    }
+    const float increments[2] = {
+        (delays[0] - previousDelays[0]) / (float) numberOfSamples,
+        (delays[1] - previousDelays[1]) / (float) numberOfSamples,
+    };
+
+    // Process samples
+    float delay0 = previousDelays[0];
+    float delay1 = previousDelays[1];
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        delay0 += increments[0];
+        delay1 += increments[1];
+        const float wet = 0.5f * (ReadBuffer(delay0) + ReadBuffer(delay1));
+        WriteBuffer(samples[index]);
+        samples[index] += CHORUS_MIX * (wet - samples[index]);
+    }
+    previousDelays[0] = delays[0];
+    previousDelays[1] = delays[1];
+}
+
+/**
+ * @brief Processes a block with the flanger.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+static void ProcessFlanger(float* const samples, const unsigned int numberOfSamples) {
+
+    // Calculate target delay
+    const float phase = UpdateLfo(FLANGER_RATE, numberOfSamples);
+    const float delay = (FLANGER_DELAY * SAMPLE_FREQUENCY) + (FLANGER_DEPTH * SAMPLE_FREQUENCY) * WaveformsSine(phase);
+    if (previousDelays[0] < 0.0f) {
+        previousDelays[0] = delay;
+    }
+    const float increment = (delay - previousDelays[0]) / (float) numberOfSamples;
+
+    // Process samples
+    float rampedDelay = previousDelays[0];
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        rampedDelay += increment;
+        const float delayed = ReadBuffer(rampedDelay);
+        WriteBuffer(samples[index] + FLANGER_FEEDBACK * delayed);
+        samples[index] += FLANGER_MIX * (delayed - samples[index]);
+    }
+    previousDelays[0] = delay;
+}
+
+/**
+ * @brief Processes a block with the phaser.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+static void ProcessPhaser(float* const samples, const unsigned int numberOfSamples) {
+
+    // Calculate all-pass coefficient for exponential sweep
+    const float phase = UpdateLfo(PHASER_RATE, numberOfSamples);
+    const float sweep = 0.5f * (1.0f + WaveformsSine(phase));
+    const float frequency = PHASER_MINIMUM_FREQUENCY * FastMathExp2(FastMathLog2(PHASER_MAXIMUM_FREQUENCY / PHASER_MINIMUM_FREQUENCY) * sweep);
+    const float tangent = FastMathTan((float) M_PI * frequency * (1.0f / SAMPLE_FREQUENCY));
+    const float coefficient = (tangent - 1.0f) * FastMathReciprocal(tangent + 1.0f);
+
+    // Process samples
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        float allPass = samples[index] + PHASER_FEEDBACK * feedbackSample;
+        unsigned int stage;
+        for (stage = 0; stage < NUMBER_OF_PHASER_STAGES; stage++) {
+            const float output = coefficient * allPass + phaserStates[stage];
+            phaserStates[stage] = QUANTISE_TO_ZERO(allPass - coefficient * output);
+            allPass = output;
+        }
+        feedbackSample = allPass;
+        samples[index] += PHASER_MIX * (allPass - samples[index]);
+    }
+}
+
+/**
+ * @brief Reads sample from buffer with linear interpolation.
+ * @param delay Delay in samples, including fraction.  Must be at least 1 and
+ * less than MODULATION_EFFECTS_BUFFER_SIZE - 1.
+ * @return Sample.
+ */
+static inline __attribute__((always_inline)) float ReadBuffer(const float delay) {
+    const float position = (float) (bufferIndex + MODULATION_EFFECTS_BUFFER_SIZE) - delay;
+    const int positionFloor = FastMathFloorToInt(position);
+    const float fraction = position - (float) positionFloor;
+    const float sample0 = buffer[positionFloor & BUFFER_MASK];
+    const float sample1 = buffer[(positionFloor + 1) & BUFFER_MASK];
+    return sample0 + fraction * (sample1 - sample0);
+}
+
+/**
+ * @brief Writes sample to buffer and increments the index.
+ * @param sample Sample.
+ */
+static inline __attribute__((always_inline)) void WriteBuffer(const float sample) {
+    buffer[bufferIndex] = sample;
+    bufferIndex = (bufferIndex + 1) & BUFFER_MASK;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,58 @@
+/**
+ * @file ModulationEffects.h
+ * @author Seb Madgwick
+ * @brief Chorus, flanger and phaser modulation effects.
+ */
+
+#ifndef MODULATION_EFFECTS_H
+#define MODULATION_EFFECTS_H
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Uncomment this definition to enable the modulation effects after the
+ * delay.  The synthesiser delay buffer is reduced by
+ * MODULATION_EFFECTS_RAM_SIZE.  The effects are not applied if
+ * FIXED_POINT_ENABLED is defined.
+ */
+//#define MODULATION_EFFECTS_ENABLED
+
+/**
+ * @brief Chorus and flanger buffer size in samples.  Must be a power of two.
+ * Equivalent to 21 ms.
+ */
+#define MODULATION_EFFECTS_BUFFER_SIZE (2048)
+
+/**
+ * @brief RAM used by the chorus and flanger buffer in bytes.
+ */
+#ifdef MODULATION_EFFECTS_ENABLED
+#define MODULATION_EFFECTS_RAM_SIZE (MODULATION_EFFECTS_BUFFER_SIZE * 4)
+#else
+#define MODULATION_EFFECTS_RAM_SIZE (0)
+#endif
+
+/**
+ * @brief Modulation effect.
+ */
+typedef enum {
+    ModulationEffectOff,
+    ModulationEffectChorus,
+    ModulationEffectFlanger,
+    ModulationEffectPhaser,
+    ModulationEffectNumberOfEffects,
+} ModulationEffect;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+#ifdef MODULATION_EFFECTS_ENABLED
+void ModulationEffectsSetEffect(const ModulationEffect effect);
+void ModulationEffectsProcess(float* const samples, const unsigned int numberOfSamples);
+#endif
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -12,6 +12,7 @@
 
 #include <xc.h>
 #include "Potentiometers.h"
+#include <stdbool.h>
 #include <stdint.h>
 #include "system/int/sys_int.h"
 
@@ -41,9 +42,19 @@ typedef struct {
 
 #define SAMC_VALUE (100)
 
+/**
+ * @brief ADC start up states.
+ */
+typedef enum {
+    AdcStateWaitForVoltageReference,
+    AdcStateWaitForWakeUp,
+    AdcStateRunning,
+} AdcState;
+
 //------------------------------------------------------------------------------
 // Function prototypes
 
+static void StartConversions();
 static inline __attribute__((always_inline)) float CalculatePotentiometerValue(const uint32_t inputAccumulator);
 
 //------------------------------------------------------------------------------
@@ -51,13 +62,16 @@ static inline __attribute__((always_inline)) float CalculatePotentiometerValue(c
 
 static AdcDataAccumulator adcDataAccumulator;
 static float currentPotentiometers[NUMBER_OF_POTENTIOMETERS];
+static AdcState adcState;
+static volatile bool ready;
 
 //------------------------------------------------------------------------------
 // Functions
 
 /**
  * @brief Initialises module.  This function should be called once, on system
- * start up.
+ * start up.  The ADC warm up is completed by PotentiometersTasks so that this
+ * function does not block.
  */
 void PotentiometersInitialise() {
 
@@ -122,23 +136,57 @@ void PotentiometersInitialise() {
 
     // Enable ADC
     ADCCON1bits.ON = 1;
+    adcState = AdcStateWaitForVoltageReference;
+    ready = false;
+}
 
-    // Wait for voltage reference
-    while (ADCCON2bits.BGVRRDY == 0);
+/**
+ * @brief Do module tasks.  Completes the ADC warm up started by
+ * PotentiometersInitialise.  This function should be called periodically.
+ */
+void PotentiometersTasks() {
+    switch (adcState) {
+        case AdcStateWaitForVoltageReference:
+            if (ADCCON2bits.BGVRRDY == 0) {
+                return;
+            }
+
+            // Wake up ADCs
+            ADCANCONbits.ANEN0 = 1;
+            ADCANCONbits.ANEN1 = 1;
+            ADCANCONbits.ANEN2 = 1;
+            ADCANCONbits.ANEN4 = 1;
+            ADCANCONbits.ANEN7 = 1;
+            adcState = AdcStateWaitForWakeUp;
+            return;
+
+        case AdcStateWaitForWakeUp:
+            if ((ADCANCONbits.WKRDY0 == 0) || (ADCANCONbits.WKRDY1 == 0) || (ADCANCONbits.WKRDY2 == 0) || (ADCANCONbits.WKRDY4 == 0) || (ADCANCONbits.WKRDY7 == 0)) {
+                return;
+            }
+            StartConversions();
+            adcState = AdcStateRunning;
+            return;
+
+        case AdcStateRunning:
+            return;
+    }
+}
 
-    // Wake up ADCs
-    ADCANCONbits.ANEN0 = 1;
-    ADCANCONbits.ANEN1 = 1;
-    ADCANCONbits.ANEN2 = 1;
-    ADCANCONbits.ANEN4 = 1;
-    ADCANCONbits.ANEN7 = 1;
+/**
+ * @brief Returns true once the first oversampled potentiometer values are
+ * available.
+ * @return True once the first oversampled potentiometer values are available.
+ */
+bool PotentiometersIsReady() {
+    return ready;
+}
 
-    // Wait for ADCs to wake up
-    while (ADCANCONbits.WKRDY0 == 0);
-    while (ADCANCONbits.WKRDY1 == 0);
-    while (ADCANCONbits.WKRDY2 == 0);
-    while (ADCANCONbits.WKRDY4 == 0);
-    while (ADCANCONbits.WKRDY7 == 0);
+/**
+ * @brief Enables the digital ADCs and starts continuous background
+ * conversions.
+ */
+static void StartConversions() {
 
     // Enable digital ADCs
     ADCCON3bits.DIGEN0 = 1;
@@ -200,6 +248,7 @@ void __ISR(_ADC_EOS_VECTOR) AdcEndOfScanInterrupt() {
         currentPotentiometers[6] = CalculatePotentiometerValue(adcDataAccumulator.input7);
         currentPotentiometers[7] = CalculatePotentiometerValue(adcDataAccumulator.input8);
         currentPotentiometers[8] = CalculatePotentiometerValue(adcDataAccumulator.input9);
+        ready = true;
 
         // Reset accumulators
         adcDataAccumulator.sampleCount = 0;
@@ -8,6 +8,11 @@
 #ifndef POTENTIOMETERS_H
 #define POTENTIOMETERS_H
 
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+
 //------------------------------------------------------------------------------
 // Definitions
 
@@ -35,6 +40,8 @@ typedef enum {
 // Function prototypes
 
 void PotentiometersInitialise();
+void PotentiometersTasks();
+bool PotentiometersIsReady();
 void PotentiometersGetValues(float potentiometers[NUMBER_OF_POTENTIOMETERS]);
 
 #endif
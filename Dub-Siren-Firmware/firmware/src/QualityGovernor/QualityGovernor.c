@@ -0,0 +1,144 @@
+/**
+ * @file QualityGovernor.c
+ * @author Seb Madgwick
+ * @brief Reduces synthesiser quality if the audio update load approaches the
+ * sample period and restores quality once the load decreases.
+ *
+ * The peak audio update load is measured between each call of
+ * QualityGovernorTasks.  The quality is reduced immediately if the headroom
+ * falls below a lower threshold and is only increased once the headroom has
+ * remained above a higher threshold for a hold period.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Dac/Dac.h"
+#include "QualityGovernor.h"
+#include <stdio.h> // snprintf
+#include "Uart/Uart1.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Headroom below which quality is reduced.
+ */
+#define DECREASE_QUALITY_HEADROOM (0.15f)
+
+/**
+ * @brief Headroom above which quality is increased after the hold period.
+ */
+#define INCREASE_QUALITY_HEADROOM (0.4f)
+
+/**
+ * @brief Number of consecutive calls of QualityGovernorTasks that headroom
+ * must exceed INCREASE_QUALITY_HEADROOM before quality is increased.
+ */
+#define INCREASE_QUALITY_HOLD_UPDATES (20)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void SetQuality(const SynthesiserQuality newQuality);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static SynthesiserQuality quality;
+static float headroom;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises module.  This function should be called once, on system
+ * start up, after the synthesiser has been initialised.
+ */
+void QualityGovernorInitialise() {
+    quality = SynthesiserQualityHigh;
+    headroom = 1.0f;
+    SynthesiserSetQuality(quality);
+    DacGetPeakLoad(); // reset peak load
+}
+
+/**
+ * @brief Do module tasks.  This function should be called every 100 ms by the
+ * scheduler.
+ */
+void QualityGovernorTasks() {
+
+    // Calculate headroom
+    headroom = 1.0f - DacGetPeakLoad();
+
+    // Decrease quality
+    static unsigned int holdCount;
+    if (headroom < DECREASE_QUALITY_HEADROOM) {
+        holdCount = 0;
+        if (quality < (SynthesiserQualityNumberOfQualities - 1)) {
+            SetQuality(quality + 1);
+        }
+        return;
+    }
+
+    // Increase quality
+    if (headroom > INCREASE_QUALITY_HEADROOM) {
+        if (++holdCount >= INCREASE_QUALITY_HOLD_UPDATES) {
+            holdCount = 0;
+            if (quality > SynthesiserQualityHigh) {
+                SetQuality(quality - 1);
+            }
+        }
+    } else {
+        holdCount = 0;
+    }
+}
+
+/**
+ * @brief Sets synthesiser quality and prints the change.
+ * @param newQuality New synthesiser quality.
+ */
+static void SetQuality(const SynthesiserQuality newQuality) {
+    quality = newQuality;
+    SynthesiserSetQuality(quality);
+    char string[64];
+    snprintf(string, sizeof (string), "\r\nQUALITY: %s (headroom %d%%)\r\n", QualityGovernorQualityToString(quality), (int) (headroom * 100.0f));
+    Uart1WriteStringIfReady(string);
+}
+
+/**
+ * @brief Returns the current synthesiser quality.
+ * @return Current synthesiser quality.
+ */
+SynthesiserQuality QualityGovernorGetQuality() {
+    return quality;
+}
+
+/**
+ * @brief Returns the headroom measured during the most recent period as
+ * a fraction of the sample period.
+ * @return Headroom.
+ */
+float QualityGovernorGetHeadroom() {
+    return headroom;
+}
+
+/**
+ * @brief Returns synthesiser quality enumeration string.
+ */
+char* QualityGovernorQualityToString(const SynthesiserQuality quality) {
+    switch (quality) {
+        case SynthesiserQualityHigh:
+            return (char *) &"High";
+        case SynthesiserQualityMedium:
+            return (char *) &"Medium";
+        case SynthesiserQualityLow:
+            return (char *) &"Low";
+        case SynthesiserQualityNumberOfQualities:
+            break;
+    }
+    return (char *) &"Invalid";
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,28 @@
+/**
+ * @file QualityGovernor.h
+ * @author Seb Madgwick
+ * @brief Reduces synthesiser quality if the audio update load approaches the
+ * sample period and restores quality once the load decreases.
+ */
+
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Synthesiser/Synthesiser.h"
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void QualityGovernorInitialise();
+void QualityGovernorTasks();
+SynthesiserQuality QualityGovernorGetQuality();
+float QualityGovernorGetHeadroom();
+char* QualityGovernorQualityToString(const SynthesiserQuality quality);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
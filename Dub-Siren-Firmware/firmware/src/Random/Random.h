@@ -0,0 +1,69 @@
+/**
+ * @file Random.h
+ * @author Seb Madgwick
+ * @brief Fast pseudo-random number generator for use within the audio update.
+ *
+ * 32-bit xorshift generator with a period of 2^32 - 1.  Not suitable for
+ * cryptographic use.
+ * @see https://en.wikipedia.org/wiki/Xorshift
+ */
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Random structure.  Each user of the generator should own a structure
+ * so that the sequence is not shared between interrupt contexts.
+ */
+typedef struct {
+    uint32_t state;
+} Random;
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Initialises the random structure.
+ * @param random Random structure.
+ * @param seed Seed.  A value of zero is replaced with a non-zero value because
+ * zero is not part of the sequence.
+ */
+static inline __attribute__((always_inline)) void RandomInitialise(Random * const random, const uint32_t seed) {
+    random->state = seed == 0 ? 0x2545F491 : seed;
+}
+
+/**
+ * @brief Returns the next pseudo-random number.
+ * @param random Random structure.
+ * @return Pseudo-random number between 1 and 2^32 - 1.
+ */
+static inline __attribute__((always_inline)) uint32_t RandomNext(Random * const random) {
+    uint32_t state = random->state;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    random->state = state;
+    return state;
+}
+
+/**
+ * @brief Returns the next pseudo-random number as a float.
+ * @param random Random structure.
+ * @return Pseudo-random number between -1.0 and 1.0.
+ */
+static inline __attribute__((always_inline)) float RandomNextFloat(Random * const random) {
+    return (float) (int32_t) RandomNext(random) * (1.0f / 2147483648.0f);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,279 @@
+/**
+ * @file Reverb.c
+ * @author Seb Madgwick
+ * @brief Feedback delay network (FDN) reverb with delay lines packed as 16-bit
+ * samples in a fixed-size arena.
+ *
+ * The input is diffused by four series all-pass filters, two of which have
+ * modulated delays, and then fed to four delay lines of mutually prime
+ * lengths.  The delay line outputs are mixed by an orthonormal 4x4 Hadamard
+ * matrix, attenuated for the decay time, low-pass filtered and fed back.
+ *
+ * All delay lines are stored in a single arena as 16-bit samples to halve the
+ * RAM required.  The quantisation noise floor is -90 dBFS.  The all-pass
+ * filters are evaluated one filter at a time over the whole block.
+ * Modulation is updated once per block.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Reverb.h"
+
+#ifdef REVERB_ENABLED
+
+#include "Dac/Dac.h" // SAMPLE_FREQUENCY
+#include "FastMath/FastMath.h"
+#include "MathHelpers.h"
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief All-pass filter delay lengths in samples.  Equivalent to the input
+ * diffusers of the Dattorro plate scaled to 96 kHz.
+ */
+#define ALL_PASS_LENGTH_0 (461)
+#define ALL_PASS_LENGTH_1 (347)
+#define ALL_PASS_LENGTH_2 (1223)
+#define ALL_PASS_LENGTH_3 (907)
+
+/**
+ * @brief Modulation depth of the modulated all-pass filters in samples.  The
+ * modulated filters require this many additional samples.  Each all-pass
+ * filter requires one additional sample for interpolation.
+ */
+#define MODULATION_DEPTH (16)
+
+/**
+ * @brief Modulation frequency in Hz.
+ */
+#define MODULATION_FREQUENCY (0.5f)
+
+/**
+ * @brief FDN delay line lengths in samples.
+ */
+#define LINE_LENGTH_0 (3203)
+#define LINE_LENGTH_1 (4021)
+#define LINE_LENGTH_2 (4813)
+#define LINE_LENGTH_3 (5641)
+
+/**
+ * @brief Total length of all delay lines.
+ */
+#define TOTAL_LENGTH (ALL_PASS_LENGTH_0 + ALL_PASS_LENGTH_1 + ALL_PASS_LENGTH_2 + ALL_PASS_LENGTH_3 + 2 * MODULATION_DEPTH + 4 + LINE_LENGTH_0 + LINE_LENGTH_1 + LINE_LENGTH_2 + LINE_LENGTH_3)
+
+#if TOTAL_LENGTH > REVERB_ARENA_SIZE
+#error "Reverb delay lines exceed arena"
+#endif
+
+/**
+ * @brief Number of all-pass filters and FDN delay lines.
+ */
+#define NUMBER_OF_ALL_PASS_FILTERS (4)
+#define NUMBER_OF_LINES (4)
+
+/**
+ * @brief All-pass filter gain.
+ */
+#define ALL_PASS_GAIN (0.6f)
+
+/**
+ * @brief Decay time (RT60) in seconds.
+ */
+#define DECAY_TIME (2.5f)
+
+/**
+ * @brief Damping low-pass filter corner frequency in Hz.
+ */
+#define DAMPING_FREQUENCY (6000.0f)
+
+/**
+ * @brief Default wet mix.
+ */
+#define DEFAULT_MIX (0.25f)
+
+/**
+ * @brief Delay line structure.
+ */
+typedef struct {
+    int16_t* buffer;
+    unsigned int length;
+    unsigned int index;
+} DelayLine;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void InitialiseDelayLine(DelayLine * const delayLine, const unsigned int length);
+static void ProcessAllPass(DelayLine * const delayLine, float* const samples, const unsigned int numberOfSamples, const float delay);
+static inline __attribute__((always_inline)) float ReadDelayLine(const DelayLine * const delayLine, const unsigned int delay);
+static inline __attribute__((always_inline)) void WriteDelayLine(DelayLine * const delayLine, const float sample);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static int16_t arena[REVERB_ARENA_SIZE];
+static unsigned int arenaIndex;
+static DelayLine allPasses[NUMBER_OF_ALL_PASS_FILTERS];
+static DelayLine lines[NUMBER_OF_LINES];
+static float lineGains[NUMBER_OF_LINES];
+static float dampingStates[NUMBER_OF_LINES];
+static float dampingCoefficient;
+static float modulationPhase;
+static volatile float mix = DEFAULT_MIX;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises module.  This function should be called once, on system
+ * start up.
+ */
+void ReverbInitialise() {
+
+    // Allocate delay lines from arena
+    InitialiseDelayLine(&allPasses[0], ALL_PASS_LENGTH_0 + MODULATION_DEPTH + 1);
+    InitialiseDelayLine(&allPasses[1], ALL_PASS_LENGTH_1 + 1);
+    InitialiseDelayLine(&allPasses[2], ALL_PASS_LENGTH_2 + MODULATION_DEPTH + 1);
+    InitialiseDelayLine(&allPasses[3], ALL_PASS_LENGTH_3 + 1);
+    InitialiseDelayLine(&lines[0], LINE_LENGTH_0);
+    InitialiseDelayLine(&lines[1], LINE_LENGTH_1);
+    InitialiseDelayLine(&lines[2], LINE_LENGTH_2);
+    InitialiseDelayLine(&lines[3], LINE_LENGTH_3);
+
+    // Calculate gain of each line for the decay time
+    unsigned int index;
+    for (index = 0; index < NUMBER_OF_LINES; index++) {
+        lineGains[index] = FastMathExp2((-3.0f * (float) (1.0 / M_LOG10E / M_LN2)) * (float) lines[index].length / (DECAY_TIME * SAMPLE_FREQUENCY)); // -60 dB after decay time
+    }
+    dampingCoefficient = 1.0f - FastMathExp2((float) (-2.0 * M_PI / M_LN2) * DAMPING_FREQUENCY * (1.0f / SAMPLE_FREQUENCY));
+}
+
+/**
+ * @brief Allocates delay line from the arena.
+ * @param delayLine Delay line structure.
+ * @param length Length in samples.
+ */
+static void InitialiseDelayLine(DelayLine * const delayLine, const unsigned int length) {
+    delayLine->buffer = &arena[arenaIndex];
+    delayLine->length = length;
+    delayLine->index = 0;
+    arenaIndex += length;
+}
+
+/**
+ * @brief Sets the wet mix.
+ * @param newMix 0.0 to 1.0.  0.0 bypasses the reverb.
+ */
+void ReverbSetMix(const float newMix) {
+    mix = CLAMP(newMix, 0.0f, 1.0f);
+}
+
+/**
+ * @brief Adds reverb to a block of samples in place.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.  Must not exceed
+ * REVERB_MAXIMUM_BLOCK_SIZE.
+ */
+void ReverbProcess(float* const samples, const unsigned int numberOfSamples) {
+    const float wet = mix;
+    if (wet == 0.0f) {
+        return;
+    }
+
+    // Input diffusion
+    float diffused[REVERB_MAXIMUM_BLOCK_SIZE];
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        diffused[index] = samples[index];
+    }
+    modulationPhase += MODULATION_FREQUENCY * (float) numberOfSamples * (1.0f / SAMPLE_FREQUENCY);
+    modulationPhase -= (float) FastMathFloorToInt(modulationPhase);
+    const float modulation = (0.5f * MODULATION_DEPTH) * (1.0f + FastMathSinCycles(modulationPhase));
+    ProcessAllPass(&allPasses[0], diffused, numberOfSamples, (float) ALL_PASS_LENGTH_0 + modulation);
+    ProcessAllPass(&allPasses[1], diffused, numberOfSamples, (float) ALL_PASS_LENGTH_1);
+    ProcessAllPass(&allPasses[2], diffused, numberOfSamples, (float) (ALL_PASS_LENGTH_2 + MODULATION_DEPTH) - modulation);
+    ProcessAllPass(&allPasses[3], diffused, numberOfSamples, (float) ALL_PASS_LENGTH_3);
+
+    // Feedback delay network
+    for (index = 0; index < numberOfSamples; index++) {
+        const float output0 = ReadDelayLine(&lines[0], LINE_LENGTH_0);
+        const float output1 = ReadDelayLine(&lines[1], LINE_LENGTH_1);
+        const float output2 = ReadDelayLine(&lines[2], LINE_LENGTH_2);
+        const float output3 = ReadDelayLine(&lines[3], LINE_LENGTH_3);
+        const float sum01 = output0 + output1;
+        const float difference01 = output0 - output1;
+        const float sum23 = output2 + output3;
+        const float difference23 = output2 - output3;
+        const float mixed[NUMBER_OF_LINES] = {
+            0.5f * (sum01 + sum23),
+            0.5f * (difference01 + difference23),
+            0.5f * (sum01 - sum23),
+            0.5f * (difference01 - difference23),
+        };
+        unsigned int lineIndex;
+        for (lineIndex = 0; lineIndex < NUMBER_OF_LINES; lineIndex++) {
+            dampingStates[lineIndex] += (lineGains[lineIndex] * mixed[lineIndex] - dampingStates[lineIndex]) * dampingCoefficient;
+            dampingStates[lineIndex] = QUANTISE_TO_ZERO(dampingStates[lineIndex]);
+            WriteDelayLine(&lines[lineIndex], dampingStates[lineIndex] + 0.5f * diffused[index]);
+        }
+        samples[index] += wet * 0.5f * (output0 - output1 + output2 - output3);
+    }
+}
+
+/**
+ * @brief Processes a block of samples in place with a Schroeder all-pass
+ * filter.
+ * @param delayLine Delay line structure.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ * @param delay Delay in samples, including fraction.  Must be at least one
+ * less than the delay line length.
+ */
+static void ProcessAllPass(DelayLine * const delayLine, float* const samples, const unsigned int numberOfSamples, const float delay) {
+    const unsigned int delayFloor = (unsigned int) delay; // truncation is floor because delay is not negative
+    const float fraction = delay - (float) delayFloor;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        const float delayed0 = ReadDelayLine(delayLine, delayFloor);
+        const float delayed = delayed0 + fraction * (ReadDelayLine(delayLine, delayFloor + 1) - delayed0);
+        const float input = samples[index] - ALL_PASS_GAIN * delayed;
+        WriteDelayLine(delayLine, input);
+        samples[index] = delayed + ALL_PASS_GAIN * input;
+    }
+}
+
+/**
+ * @brief Reads sample from delay line.
+ * @param delayLine Delay line structure.
+ * @param delay Delay in samples, 1 to the delay line length.
+ * @return Sample.
+ */
+static inline __attribute__((always_inline)) float ReadDelayLine(const DelayLine * const delayLine, const unsigned int delay) {
+    int readIndex = (int) delayLine->index - (int) delay;
+    if (readIndex < 0) {
+        readIndex += delayLine->length; // handle index underflow
+    }
+    return (float) delayLine->buffer[readIndex] * (1.0f / 32768.0f);
+}
+
+/**
+ * @brief Writes sample to delay line and increments the index.  The sample is
+ * saturated to 16 bits and truncated towards zero to prevent limit cycles in
+ * the feedback loop.
+ * @param delayLine Delay line structure.
+ * @param sample Sample.
+ */
+static inline __attribute__((always_inline)) void WriteDelayLine(DelayLine * const delayLine, const float sample) {
+    delayLine->buffer[delayLine->index] = (int16_t) CLAMP(sample * 32768.0f, -32768.0f, 32767.0f);
+    if (++delayLine->index >= delayLine->length) {
+        delayLine->index = 0;
+    }
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
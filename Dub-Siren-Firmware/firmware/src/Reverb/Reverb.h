@@ -0,0 +1,52 @@
+/**
+ * @file Reverb.h
+ * @author Seb Madgwick
+ * @brief Feedback delay network (FDN) reverb with delay lines packed as 16-bit
+ * samples in a fixed-size arena.
+ */
+
+#ifndef REVERB_H
+#define REVERB_H
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Uncomment this definition to enable the reverb after the delay.  The
+ * synthesiser delay buffer is reduced by REVERB_RAM_SIZE to make room for the
+ * reverb arena.  The reverb is not applied if FIXED_POINT_ENABLED is defined.
+ */
+//#define REVERB_ENABLED
+
+/**
+ * @brief Reverb arena size in 16-bit samples.
+ */
+#define REVERB_ARENA_SIZE (20656)
+
+/**
+ * @brief RAM used by the reverb arena in bytes.
+ */
+#ifdef REVERB_ENABLED
+#define REVERB_RAM_SIZE (REVERB_ARENA_SIZE * 2)
+#else
+#define REVERB_RAM_SIZE (0)
+#endif
+
+/**
+ * @brief Maximum number of samples processed by each call of ReverbProcess.
+ */
+#define REVERB_MAXIMUM_BLOCK_SIZE (32)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+#ifdef REVERB_ENABLED
+void ReverbInitialise();
+void ReverbSetMix(const float mix);
+void ReverbProcess(float* const samples, const unsigned int numberOfSamples);
+#endif
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,95 @@
+/**
+ * @file Saturation.c
+ * @author Seb Madgwick
+ * @brief Soft clip, 2x oversampled soft clip and peak limiter.
+ *
+ * The oversampled soft clip interpolates each input sample pair with a 4-tap
+ * half-band interpolator, clips both samples at twice the sample frequency and
+ * then decimates with a 7-tap half-band filter.  The latency is
+ * SATURATION_OVERSAMPLED_LATENCY samples.  The soft clip has a knee so that
+ * signals below the threshold are not coloured.
+ *
+ * The peak limiter has no look-ahead.  Gain reduction is applied on the sample
+ * that exceeds the threshold and is released exponentially.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <math.h> // expf, fabsf
+#include "Saturation.h"
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises the oversampler.
+ * @param saturationOversampler Oversampler structure.
+ * @param threshold Knee threshold.  See SaturationSoftKnee.
+ */
+void SaturationOversamplerInitialise(SaturationOversampler * const saturationOversampler, const float threshold) {
+    *saturationOversampler = (SaturationOversampler){.threshold = threshold};
+}
+
+/**
+ * @brief Soft clip at twice the sample frequency to reduce aliasing.
+ * @param saturationOversampler Oversampler structure.
+ * @param input Input.
+ * @return Output between approximately -1.0 and +1.0.  The decimation filter
+ * may overshoot by up to 0.02%.
+ */
+float SaturationOversampledSoftClip(SaturationOversampler * const saturationOversampler, const float input) {
+    float* const x = saturationOversampler->input;
+    float* const odd = saturationOversampler->odd;
+
+    // Upsample and clip
+    const float even = SaturationSoftKnee(x[1], saturationOversampler->threshold);
+    const float interpolated = SaturationSoftKnee(0.5625f * (x[1] + x[0]) - 0.0625f * (x[2] + input), saturationOversampler->threshold);
+    x[2] = x[1];
+    x[1] = x[0];
+    x[0] = input;
+
+    // Decimate
+    const float output = 0.5f * saturationOversampler->even + 0.28125f * (odd[0] + odd[1]) - 0.03125f * (odd[2] + interpolated);
+    odd[2] = odd[1];
+    odd[1] = odd[0];
+    odd[0] = interpolated;
+    saturationOversampler->even = even;
+    return output;
+}
+
+/**
+ * @brief Initialises the peak limiter.
+ * @param saturationLimiter Peak limiter structure.
+ * @param threshold Threshold.  The output magnitude will not exceed this value.
+ * @param releaseTime Release time constant in seconds.
+ * @param sampleFrequency Sample frequency in Hz.
+ */
+void SaturationLimiterInitialise(SaturationLimiter * const saturationLimiter, const float threshold, const float releaseTime, const float sampleFrequency) {
+    saturationLimiter->threshold = threshold;
+    saturationLimiter->releaseCoefficient = expf(-1.0f / (releaseTime * sampleFrequency));
+    saturationLimiter->envelope = 0.0f;
+}
+
+/**
+ * @brief Limits a block of samples in place.
+ * @param saturationLimiter Peak limiter structure.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+void SaturationLimiterProcess(SaturationLimiter * const saturationLimiter, float* const samples, const unsigned int numberOfSamples) {
+    const float threshold = saturationLimiter->threshold;
+    const float releaseCoefficient = saturationLimiter->releaseCoefficient;
+    float envelope = saturationLimiter->envelope;
+    unsigned int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        envelope = MAX(fabsf(samples[index]), envelope * releaseCoefficient);
+        if (envelope > threshold) {
+            samples[index] *= threshold * FastMathReciprocal(envelope);
+        }
+    }
+    saturationLimiter->envelope = QUANTISE_TO_ZERO(envelope);
+}
+
+//------------------------------------------------------------------------------
+// End of file
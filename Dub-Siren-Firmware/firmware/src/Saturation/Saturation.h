@@ -0,0 +1,92 @@
+/**
+ * @file Saturation.h
+ * @author Seb Madgwick
+ * @brief Soft clip, 2x oversampled soft clip and peak limiter.
+ */
+
+#ifndef SATURATION_H
+#define SATURATION_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "FastMath/FastMath.h"
+#include "MathHelpers.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Latency of SaturationOversampledSoftClip in samples.
+ */
+#define SATURATION_OVERSAMPLED_LATENCY (3)
+
+/**
+ * @brief Oversampler structure.  Structure members are used internally and
+ * should not be used by the user application.  A zero-initialised structure
+ * soft clips with a knee threshold of 0.0.
+ */
+typedef struct {
+    float input[3];
+    float even;
+    float odd[3];
+    float threshold;
+} SaturationOversampler;
+
+/**
+ * @brief Peak limiter structure.  Structure members are used internally and
+ * should not be used by the user application.
+ */
+typedef struct {
+    float threshold;
+    float releaseCoefficient;
+    float envelope;
+} SaturationLimiter;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void SaturationOversamplerInitialise(SaturationOversampler * const saturationOversampler, const float threshold);
+float SaturationOversampledSoftClip(SaturationOversampler * const saturationOversampler, const float input);
+void SaturationLimiterInitialise(SaturationLimiter * const saturationLimiter, const float threshold, const float releaseTime, const float sampleFrequency);
+void SaturationLimiterProcess(SaturationLimiter * const saturationLimiter, float* const samples, const unsigned int numberOfSamples);
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Soft clip using a Pade approximant of tanh.  The gradient is 1.0 at
+ * zero and 0.0 where the output reaches +/-1.0 at an input of +/-3.0.  Maximum
+ * error against tanh is 0.024.
+ * @param input Input.
+ * @return Output between -1.0 and +1.0.
+ */
+static inline __attribute__((always_inline)) float SaturationSoftClip(const float input) {
+    const float x = CLAMP(input, -3.0f, 3.0f);
+    const float xSquared = x * x;
+    return x * (27.0f + xSquared) * FastMathReciprocal(27.0f + 9.0f * xSquared);
+}
+
+/**
+ * @brief Soft clip with a knee.  The output is equal to the input below the
+ * threshold.  The excess above the threshold is soft clipped into the
+ * remaining range so that the gradient is continuous at the threshold.  A
+ * threshold of 0.0 is equivalent to SaturationSoftClip.
+ * @param input Input.
+ * @param threshold Threshold, 0.0 to less than 1.0.
+ * @return Output between -1.0 and +1.0.
+ */
+static inline __attribute__((always_inline)) float SaturationSoftKnee(const float input, const float threshold) {
+    const float magnitude = fabsf(input);
+    if (magnitude <= threshold) {
+        return input;
+    }
+    const float range = 1.0f - threshold;
+    const float output = threshold + range * SaturationSoftClip((magnitude - threshold) * FastMathReciprocal(range));
+    return input < 0.0f ? -output : output;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
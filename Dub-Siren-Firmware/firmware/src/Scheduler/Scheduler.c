@@ -0,0 +1,206 @@
+/**
+ * @file Scheduler.c
+ * @author Seb Madgwick
+ * @brief Cooperative run-to-completion task scheduler.
+ *
+ * Tasks are released according to the 64-bit timer.  The most overdue task is
+ * run to completion each time SchedulerTasks is called.  The deadline of a
+ * periodic task is its next release.  A deadline miss is counted if a task
+ * completes after its deadline, in which case the next release is immediate.
+ * The CPU waits for the next interrupt if no task is due.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stddef.h> // NULL
+#include "Scheduler.h"
+#include "Timer/Timer.h"
+#include <xc.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Number of timer ticks per microsecond.
+ */
+#define TICKS_PER_MICROSECOND (TIMER_TICKS_PER_SECOND / 1000000)
+
+/**
+ * @brief Task structure.
+ */
+typedef struct {
+    const char* name;
+    void (*function)();
+    uint64_t period; // timer ticks, 0 for a one-shot task
+    uint64_t releaseTicks;
+    bool released;
+    uint32_t runCount;
+    uint32_t deadlineMissCount;
+    uint32_t maximumRunTicks;
+} Task;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static Task* FindTask(void (*function)());
+
+//------------------------------------------------------------------------------
+// Variables
+
+static Task tasks[MAXIMUM_NUMBER_OF_TASKS];
+static unsigned int numberOfTasks;
+static uint64_t idleTicks;
+static uint64_t idleStartTicks;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Adds a periodic task.  The first release is after one period.
+ * @param name Task name.
+ * @param function Task function.
+ * @param period Period in microseconds.
+ * @return True if successful, false if the maximum number of tasks has been
+ * reached.
+ */
+bool SchedulerAddPeriodicTask(const char* const name, void (*function)(), const uint32_t period) {
+    if (numberOfTasks >= MAXIMUM_NUMBER_OF_TASKS) {
+        return false;
+    }
+    Task * const task = &tasks[numberOfTasks++];
+    task->name = name;
+    task->function = function;
+    task->period = (uint64_t) period * TICKS_PER_MICROSECOND;
+    task->releaseTicks = TimerGetTicks64() + task->period;
+    task->released = true;
+    return true;
+}
+
+/**
+ * @brief Adds a one-shot task, or re-arms the one-shot task if the function has
+ * already been added.
+ * @param name Task name.
+ * @param function Task function.
+ * @param delay Delay until release in microseconds.
+ * @return True if successful, false if the maximum number of tasks has been
+ * reached.
+ */
+bool SchedulerAddOneShotTask(const char* const name, void (*function)(), const uint32_t delay) {
+    Task* task = FindTask(function);
+    if (task == NULL) {
+        if (numberOfTasks >= MAXIMUM_NUMBER_OF_TASKS) {
+            return false;
+        }
+        task = &tasks[numberOfTasks++];
+        task->name = name;
+        task->function = function;
+        task->period = 0;
+    }
+    task->releaseTicks = TimerGetTicks64() + ((uint64_t) delay * TICKS_PER_MICROSECOND);
+    task->released = true;
+    return true;
+}
+
+/**
+ * @brief Returns the task with the specified function.
+ * @param function Task function.
+ * @return Task, or NULL if the function has not been added.
+ */
+static Task* FindTask(void (*function)()) {
+    unsigned int index;
+    for (index = 0; index < numberOfTasks; index++) {
+        if (tasks[index].function == function) {
+            return &tasks[index];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Runs the most overdue task.  This function should be called
+ * repeatedly within the main program loop.
+ */
+void SchedulerTasks() {
+
+    // Find most overdue task
+    const uint64_t currentTicks = TimerGetTicks64();
+    Task* task = NULL;
+    unsigned int index;
+    for (index = 0; index < numberOfTasks; index++) {
+        if ((tasks[index].released == false) || (tasks[index].releaseTicks > currentTicks)) {
+            continue;
+        }
+        if ((task == NULL) || (tasks[index].releaseTicks < task->releaseTicks)) {
+            task = &tasks[index];
+        }
+    }
+
+    // Wait for next interrupt if no task due
+    if (task == NULL) {
+        _wait();
+        idleTicks += TimerGetTicks64() - currentTicks;
+        return;
+    }
+
+    // Run task
+    if (task->period == 0) {
+        task->released = false; // one-shot task may re-arm itself
+    }
+    task->function();
+    const uint64_t endTicks = TimerGetTicks64();
+    task->runCount++;
+    const uint32_t runTicks = (uint32_t) (endTicks - currentTicks);
+    if (runTicks > task->maximumRunTicks) {
+        task->maximumRunTicks = runTicks;
+    }
+
+    // Schedule next release of periodic task
+    if (task->period == 0) {
+        return;
+    }
+    task->releaseTicks += task->period;
+    if (endTicks > task->releaseTicks) {
+        task->deadlineMissCount++;
+        task->releaseTicks = endTicks;
+    }
+}
+
+/**
+ * @brief Returns the number of tasks.
+ * @return Number of tasks.
+ */
+unsigned int SchedulerGetNumberOfTasks() {
+    return numberOfTasks;
+}
+
+/**
+ * @brief Gets task statistics.
+ * @param index Task index.
+ * @param taskStatistics Task statistics structure to be written to.
+ */
+void SchedulerGetTaskStatistics(const unsigned int index, SchedulerTaskStatistics * const taskStatistics) {
+    if (index >= numberOfTasks) {
+        return;
+    }
+    taskStatistics->name = tasks[index].name;
+    taskStatistics->runCount = tasks[index].runCount;
+    taskStatistics->deadlineMissCount = tasks[index].deadlineMissCount;
+    taskStatistics->maximumRunTime = tasks[index].maximumRunTicks / TICKS_PER_MICROSECOND;
+}
+
+/**
+ * @brief Returns the fraction of time spent idle since the previous call of
+ * this function.  Time spent in interrupts while idle is counted as idle.
+ * @return Idle time as a fraction between 0.0 and 1.0.
+ */
+float SchedulerGetIdle() {
+    const uint64_t currentTicks = TimerGetTicks64();
+    const float idle = (float) idleTicks / (float) (currentTicks - idleStartTicks);
+    idleTicks = 0;
+    idleStartTicks = currentTicks;
+    return idle;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,54 @@
+/**
+ * @file Scheduler.h
+ * @author Seb Madgwick
+ * @brief Cooperative run-to-completion task scheduler.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum number of tasks.  One more than the number of tasks added by
+ * the application.
+ */
+#define MAXIMUM_NUMBER_OF_TASKS (8)
+
+/**
+ * @brief RAM used by the task table in bytes.  Each task is 40 bytes.  The
+ * synthesiser delay buffer is reduced by this amount.
+ */
+#define SCHEDULER_RAM_SIZE (MAXIMUM_NUMBER_OF_TASKS * 40)
+
+/**
+ * @brief Task statistics structure.
+ */
+typedef struct {
+    const char* name;
+    uint32_t runCount;
+    uint32_t deadlineMissCount;
+    uint32_t maximumRunTime; // microseconds
+} SchedulerTaskStatistics;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+bool SchedulerAddPeriodicTask(const char* const name, void (*function)(), const uint32_t period);
+bool SchedulerAddOneShotTask(const char* const name, void (*function)(), const uint32_t delay);
+void SchedulerTasks();
+unsigned int SchedulerGetNumberOfTasks();
+void SchedulerGetTaskStatistics(const unsigned int index, SchedulerTaskStatistics * const taskStatistics);
+float SchedulerGetIdle();
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
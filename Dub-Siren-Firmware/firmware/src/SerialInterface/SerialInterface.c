@@ -0,0 +1,1014 @@
+/**
+ * @file SerialInterface.c
+ * @author Seb Madgwick
+ * @brief Serial interface module.  Interprets text commands received by UART 1.
+ *
+ * Each command is a single line of text terminated by a carriage return and/or
+ * line feed.  The command name is separated from any arguments by a space.
+ * Send "help" for a list of commands.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Boot/Boot.h"
+#include "Convolution/Convolution.h"
+#include "EffectsChain/EffectsChain.h"
+#include "ModulationEffects/ModulationEffects.h"
+#include "QualityGovernor/QualityGovernor.h"
+#include "Reverb/Reverb.h"
+#include "Scheduler/Scheduler.h"
+#include "SerialInterface.h"
+#include <stdbool.h>
+#include <stdint.h> // int16_t
+#include <stdio.h> // snprintf
+#include <stdlib.h> // strtof, strtol
+#include <string.h> // strcmp, strchr, strlen, strncmp
+#include "Synthesiser/Synthesiser.h"
+#include "Synthesiser/Wavetable.h"
+#include "Trace/Trace.h"
+#include "Uart/Uart1.h"
+#include "UserInterface/UserInterface.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum command line length including the null terminator.
+ */
+#define LINE_BUFFER_SIZE (256)
+
+/**
+ * @brief Command structure.
+ */
+typedef struct {
+    const char* name;
+    const char* description;
+    void (*function)(const char* const arguments);
+} Command;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void ProcessLine(char* const line);
+static void Help(const char* const arguments);
+static void Load(const char* const arguments);
+static void Trigger(const char* const arguments);
+static void Gate(const char* const arguments);
+static void Tasks(const char* const arguments);
+static void Boot(const char* const arguments);
+static void Echo(const char* const arguments);
+static void Mode(const char* const arguments);
+static void Chain(const char* const arguments);
+static void Envelope(const char* const arguments);
+static void Modulation(const char* const arguments);
+static void PrintModulationMatrix(const ModulationMatrixParameters * const parameters);
+static bool ParseEnvelope(const char* const arguments, EnvelopeParameters * const envelopeParameters);
+static const char* ParseName(const char* const arguments, const char* const * const names, const unsigned int numberOfNames, unsigned int * const index);
+static void Vco2(const char* const arguments);
+static void Unison(const char* const arguments);
+static void Pitch(const char* const arguments);
+static void PrintPitch(const PitchParameters * const parameters);
+#ifdef MODULATION_EFFECTS_ENABLED
+static void ModulationEffects(const char* const arguments);
+#endif
+#ifdef REVERB_ENABLED
+static void Reverb(const char* const arguments);
+#endif
+#ifdef CONVOLUTION_ENABLED
+static void ImpulseResponse(const char* const arguments);
+#endif
+#ifdef WAVETABLE_ENABLED
+static void Wavetable(const char* const arguments);
+#endif
+#if defined(CONVOLUTION_ENABLED) || defined(WAVETABLE_ENABLED)
+static const char* LoadHexSamples(const char* hex, bool (*loadSample)(const float sample), const char* const loadFailedMessage);
+static int HexToInt(const char character);
+#endif
+#ifdef TRACE_ENABLED
+static void Trace(const char* const arguments);
+#endif
+
+//------------------------------------------------------------------------------
+// Variables
+
+static const char* const lfoWaveformNames[LfoWaveformNumberOfWaveforms] = {
+    "sine",
+    "triangle",
+    "sawtooth",
+    "square",
+    "steppedtriangle",
+    "steppedsawtooth",
+    "samplehold",
+    "smoothrandom",
+};
+static const char* const modulationSourceNames[ModulationSourceNumberOfSources] = {
+    "lfo1",
+    "lfo2",
+    "lfo3",
+    "env",
+    "modenv",
+    "random",
+};
+static const char* const modulationDestinationNames[ModulationDestinationNumberOfDestinations] = {
+    "pitch",
+    "pw",
+    "delaytime",
+    "feedback",
+    "cutoff",
+    "wtpos",
+};
+static const char* const vcoWaveformNames[VcoWaveformNumberOfWaveforms] = {
+    "sine",
+    "triangle",
+    "sawtooth",
+    "square",
+    "pulse",
+    "noise",
+    "wavetable",
+};
+static const char* const vcoModulationNames[VcoModulationNumberOfModulations] = {
+    "mix",
+    "fm",
+    "sync",
+    "ring",
+};
+static const char* const pitchScaleNames[PitchScaleNumberOfScales] = {
+    "off",
+    "chromatic",
+    "major",
+    "minor",
+    "majpent",
+    "minpent",
+};
+static const Command commands[] = {
+    {"help", "Print list of commands", &Help},
+    {"load", "Print synthesiser quality and audio update headroom", &Load},
+    {"trigger", "Trigger synthesiser", &Trigger},
+    {"gate", "Set gate state: gate <on|off>", &Gate},
+    {"tasks", "Print scheduler task statistics and idle time", &Tasks},
+    {"boot", "Print boot phase timestamps and boot to audio time", &Boot},
+    {"echo", "Set delay model: echo <digital|tape|bbd>", &Echo},
+    {"mode", "Set delay mode: mode <normal|freeze|reverse|hold>", &Mode},
+    {"chain", "Print effects chain or set nodes: chain [node ...|none]", &Chain},
+    {"env", "Set envelope: env <A ms> <D ms> <S %> <R ms> [adsr|ad] [analog|reset]", &Envelope},
+    {"mod", "Print or set modulation: mod [route source dest depth|route off|lfo|env]", &Modulation},
+    {"vco2", "Set VCO 2: vco2 <off|mix|fm|sync|ring> <waveform> <ratio> <amount>", &Vco2},
+    {"unison", "Set unison: unison <off|voices spread-cents mix-%>", &Unison},
+    {"pitch", "Print or set pitch: pitch [glide ms|scale name|tune <default|ref-Hz cents ...>]", &Pitch},
+#ifdef MODULATION_EFFECTS_ENABLED
+    {"modfx", "Set modulation effect: modfx <off|chorus|flanger|phaser>", &ModulationEffects},
+#endif
+#ifdef REVERB_ENABLED
+    {"reverb", "Set reverb mix: reverb <0-100>", &Reverb},
+#endif
+#ifdef CONVOLUTION_ENABLED
+    {"ir", "Load impulse response: ir <begin length|data hex|end|off>", &ImpulseResponse},
+#endif
+#ifdef WAVETABLE_ENABLED
+    {"wt", "Set wavetable position or load tables: wt <pos 0-100|begin tables|data hex|end|default>", &Wavetable},
+#endif
+#ifdef TRACE_ENABLED
+    {"trace", "Dump binary trace log for TraceDecoder.m", &Trace},
+#endif
+};
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Do module tasks.  This function should be called periodically by the
+ * scheduler.
+ */
+void SerialInterfaceTasks() {
+    static char line[LINE_BUFFER_SIZE];
+    static unsigned int lineIndex;
+    static bool lineOverflow;
+    while (Uart1IsReadReady() > 0) {
+        const char character = Uart1Read();
+        if ((character == '\r') || (character == '\n')) {
+            if ((lineIndex > 0) && (lineOverflow == false)) {
+                line[lineIndex] = '\0';
+                ProcessLine(line);
+            }
+            lineIndex = 0;
+            lineOverflow = false;
+            continue;
+        }
+        if (lineIndex >= (LINE_BUFFER_SIZE - 1)) {
+            lineOverflow = true; // discard line
+            continue;
+        }
+        line[lineIndex++] = character;
+    }
+}
+
+/**
+ * @brief Interprets line and calls corresponding command function.
+ * @param line Null-terminated command line.
+ */
+static void ProcessLine(char* const line) {
+    char* arguments = strchr(line, ' ');
+    if (arguments == NULL) {
+        arguments = &line[strlen(line)];
+    } else {
+        *arguments++ = '\0';
+    }
+    unsigned int index;
+    for (index = 0; index < (sizeof (commands) / sizeof (Command)); index++) {
+        if (strcmp(line, commands[index].name) == 0) {
+            commands[index].function(arguments);
+            return;
+        }
+    }
+    Uart1WriteStringIfReady("\r\nUnknown command. Send \"help\" for a list of commands.\r\n");
+}
+
+/**
+ * @brief Prints list of commands.
+ * @param arguments Unused.
+ */
+static void Help(const char* const arguments) {
+    Uart1WriteStringIfReady("\r\nCOMMANDS:\r\n");
+    unsigned int index;
+    for (index = 0; index < (sizeof (commands) / sizeof (Command)); index++) {
+        char string[128];
+        snprintf(string, sizeof (string), "%-16s %s\r\n", commands[index].name, commands[index].description);
+        Uart1WriteStringIfReady(string);
+    }
+}
+
+/**
+ * @brief Prints synthesiser quality and audio update headroom.
+ * @param arguments Unused.
+ */
+static void Load(const char* const arguments) {
+    char string[64];
+    snprintf(string, sizeof (string), "\r\nQUALITY: %s (headroom %d%%)\r\n",
+            QualityGovernorQualityToString(QualityGovernorGetQuality()),
+            (int) (QualityGovernorGetHeadroom() * 100.0f));
+    Uart1WriteStringIfReady(string);
+}
+
+/**
+ * @brief Triggers synthesiser.
+ * @param arguments Unused.
+ */
+static void Trigger(const char* const arguments) {
+    SynthesiserTrigger();
+}
+
+/**
+ * @brief Sets gate state.
+ * @param arguments "on" or "off".
+ */
+static void Gate(const char* const arguments) {
+    if (strcmp(arguments, "on") == 0) {
+        SynthesiserSetGate(true);
+    } else if (strcmp(arguments, "off") == 0) {
+        SynthesiserSetGate(false);
+    } else {
+        Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+    }
+}
+
+/**
+ * @brief Prints scheduler task statistics and idle time since the previous
+ * call of this function.
+ * @param arguments Unused.
+ */
+static void Tasks(const char* const arguments) {
+    Uart1WriteStringIfReady("\r\nTASKS (runs, deadline misses, maximum run time in us):\r\n");
+    unsigned int index;
+    for (index = 0; index < SchedulerGetNumberOfTasks(); index++) {
+        SchedulerTaskStatistics taskStatistics;
+        SchedulerGetTaskStatistics(index, &taskStatistics);
+        char string[96];
+        snprintf(string, sizeof (string), "%-16s %10u %6u %6u\r\n",
+                taskStatistics.name,
+                (unsigned int) taskStatistics.runCount,
+                (unsigned int) taskStatistics.deadlineMissCount,
+                (unsigned int) taskStatistics.maximumRunTime);
+        Uart1WriteStringIfReady(string);
+    }
+    char string[32];
+    snprintf(string, sizeof (string), "Idle %d%%\r\n", (int) (SchedulerGetIdle() * 100.0f));
+    Uart1WriteStringIfReady(string);
+}
+
+/**
+ * @brief Prints boot phase timestamps.
+ * @param arguments Unused.
+ */
+static void Boot(const char* const arguments) {
+    BootPrint();
+}
+
+/**
+ * @brief Sets delay model.
+ * @param arguments "digital", "tape" or "bbd".
+ */
+static void Echo(const char* const arguments) {
+    static const char* const delayModelNames[DelayModelNumberOfModels] = {
+        "digital",
+        "tape",
+        "bbd",
+    };
+    DelayModel delayModel;
+    for (delayModel = 0; delayModel < DelayModelNumberOfModels; delayModel++) {
+        if (strcmp(arguments, delayModelNames[delayModel]) == 0) {
+            SynthesiserSetDelayModel(delayModel);
+            return;
+        }
+    }
+    Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+}
+
+/**
+ * @brief Sets delay mode.
+ * @param arguments "normal", "freeze", "reverse" or "hold".
+ */
+static void Mode(const char* const arguments) {
+    static const char* const delayModeNames[DelayModeNumberOfModes] = {
+        "normal",
+        "freeze",
+        "reverse",
+        "hold",
+    };
+    DelayMode delayMode;
+    for (delayMode = 0; delayMode < DelayModeNumberOfModes; delayMode++) {
+        if (strcmp(arguments, delayModeNames[delayMode]) == 0) {
+            SynthesiserSetDelayMode(delayMode);
+            return;
+        }
+    }
+    Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+}
+
+/**
+ * @brief Prints the effects chain nodes with the cycles per sample of each
+ * node since the previous call of this function, or sets the effects chain
+ * layout.
+ * @param arguments Empty to print the effects chain, "none" for an empty
+ * chain, or node names separated by spaces in processing order.
+ */
+static void Chain(const char* const arguments) {
+
+    // Print nodes
+    if (*arguments == '\0') {
+        Uart1WriteStringIfReady("\r\nEFFECTS CHAIN (cycles per sample, maximum cycles per sample):\r\n");
+        unsigned int index;
+        for (index = 0; index < EFFECTS_CHAIN_MAXIMUM_NUMBER_OF_NODES; index++) {
+            EffectsChainNodeStatistics nodeStatistics;
+            EffectsChainGetNodeStatistics(index, &nodeStatistics);
+            if (nodeStatistics.type == EffectsChainNodeTypeNone) {
+                break;
+            }
+            char string[64];
+            if (nodeStatistics.active == false) {
+                snprintf(string, sizeof (string), "%-16s inactive\r\n", EffectsChainNodeTypeToString(nodeStatistics.type));
+            } else {
+                snprintf(string, sizeof (string), "%-16s %6u %6u\r\n",
+                        EffectsChainNodeTypeToString(nodeStatistics.type),
+                        (unsigned int) ((2 * nodeStatistics.ticks) / DAC_BLOCK_SIZE), // core timer runs at half the CPU clock
+                        (unsigned int) ((2 * nodeStatistics.maximumTicks) / DAC_BLOCK_SIZE));
+            }
+            Uart1WriteStringIfReady(string);
+        }
+        EffectsChainResetStatistics();
+        return;
+    }
+
+    // Parse node names
+    EffectsChainLayout layout = {.nodeTypes = {EffectsChainNodeTypeNone}};
+    if (strcmp(arguments, "none") != 0) {
+        const char* name = arguments;
+        unsigned int index = 0;
+        while (*name != '\0') {
+            const char* nameEnd = strchr(name, ' ');
+            if (nameEnd == NULL) {
+                nameEnd = &name[strlen(name)];
+            }
+            EffectsChainNodeType type;
+            for (type = EffectsChainNodeTypeNone + 1; type < EffectsChainNodeTypeNumberOfTypes; type++) {
+                const char* const typeName = EffectsChainNodeTypeToString(type);
+                if ((strlen(typeName) == (size_t) (nameEnd - name)) && (strncmp(name, typeName, nameEnd - name) == 0)) {
+                    break;
+                }
+            }
+            if ((type >= EffectsChainNodeTypeNumberOfTypes) || (index >= EFFECTS_CHAIN_MAXIMUM_NUMBER_OF_NODES)) {
+                Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+                return;
+            }
+            layout.nodeTypes[index++] = type;
+            name = (*nameEnd == ' ') ? nameEnd + 1 : nameEnd;
+        }
+    }
+    EffectsChainSetLayout(&layout);
+}
+
+/**
+ * @brief Sets envelope parameters.
+ * @param arguments See ParseEnvelope.
+ */
+static void Envelope(const char* const arguments) {
+    EnvelopeParameters envelopeParameters;
+    if (ParseEnvelope(arguments, &envelopeParameters) == false) {
+        Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        return;
+    }
+    UserInterfaceSetEnvelopeParameters(&envelopeParameters);
+}
+
+/**
+ * @brief Prints the modulation matrix or sets a route, LFO or the modulation
+ * envelope.
+ * @param arguments Empty to print the modulation matrix, or one of:
+ * - "<route> <source> <destination> <depth>" where route is 1 to
+ *   MODULATION_MATRIX_NUMBER_OF_ROUTES and depth is in the units of the
+ *   destination.
+ * - "<route> off".
+ * - "lfo <2|3> <waveform> <shape %> <frequency Hz>".
+ * - "env" followed by the arguments of ParseEnvelope.
+ */
+static void Modulation(const char* const arguments) {
+    ModulationMatrixParameters parameters;
+    SynthesiserGetModulationMatrix(&parameters);
+
+    // Print modulation matrix
+    if (*arguments == '\0') {
+        PrintModulationMatrix(&parameters);
+        return;
+    }
+
+    // Modulation envelope
+    if (strncmp(arguments, "env ", 4) == 0) {
+        if (ParseEnvelope(&arguments[4], &parameters.envelope) == false) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+            return;
+        }
+        SynthesiserSetModulationMatrix(&parameters);
+        return;
+    }
+
+    // LFO
+    if (strncmp(arguments, "lfo ", 4) == 0) {
+        char* end;
+        const long lfoNumber = strtol(&arguments[4], &end, 10);
+        if ((lfoNumber < 2) || (lfoNumber > (MODULATION_MATRIX_NUMBER_OF_LFOS + 1)) || (*end != ' ')) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+            return;
+        }
+        ModulationLfoParameters * const lfo = &parameters.lfos[lfoNumber - 2];
+        unsigned int waveform;
+        const char* argument = ParseName(end + 1, lfoWaveformNames, LfoWaveformNumberOfWaveforms, &waveform);
+        if (argument == NULL) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+            return;
+        }
+        const long shape = strtol(argument, &end, 10);
+        const float frequency = ((end != argument) && (*end == ' ')) ? strtof(end, &end) : -1.0f;
+        if ((shape < 0) || (shape > 100) || (frequency < 0.0f) || (*end != '\0')) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+            return;
+        }
+        lfo->waveform = waveform;
+        lfo->shape = (float) shape * 0.01f;
+        lfo->frequency = frequency;
+        SynthesiserSetModulationMatrix(&parameters);
+        return;
+    }
+
+    // Route
+    char* end;
+    const long routeNumber = strtol(arguments, &end, 10);
+    if ((end == arguments) || (routeNumber < 1) || (routeNumber > MODULATION_MATRIX_NUMBER_OF_ROUTES) || (*end != ' ')) {
+        Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        return;
+    }
+    ModulationRoute * const route = &parameters.routes[routeNumber - 1];
+    if (strcmp(end + 1, "off") == 0) {
+        route->depth = 0.0f;
+        SynthesiserSetModulationMatrix(&parameters);
+        return;
+    }
+    unsigned int source;
+    unsigned int destination;
+    const char* argument = ParseName(end + 1, modulationSourceNames, ModulationSourceNumberOfSources, &source);
+    if ((argument != NULL) && (*argument == ' ')) {
+        argument = ParseName(argument + 1, modulationDestinationNames, ModulationDestinationNumberOfDestinations, &destination);
+    } else {
+        argument = NULL;
+    }
+    if (argument == NULL) {
+        Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        return;
+    }
+    const float depth = strtof(argument, &end);
+    if ((end == argument) || (*end != '\0')) {
+        Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        return;
+    }
+    route->source = source;
+    route->destination = destination;
+    route->depth = depth;
+    SynthesiserSetModulationMatrix(&parameters);
+}
+
+/**
+ * @brief Prints modulation matrix parameters.
+ * @param parameters Modulation matrix parameters.
+ */
+static void PrintModulationMatrix(const ModulationMatrixParameters * const parameters) {
+    char string[96];
+    Uart1WriteStringIfReady("\r\nMODULATION ROUTES (source, destination, depth):\r\n");
+    unsigned int index;
+    for (index = 0; index < MODULATION_MATRIX_NUMBER_OF_ROUTES; index++) {
+        const ModulationRoute * const route = &parameters->routes[index];
+        if (route->depth == 0.0f) {
+            snprintf(string, sizeof (string), "%u off\r\n", index + 1);
+        } else {
+            snprintf(string, sizeof (string), "%u %-8s %-10s %f\r\n", index + 1,
+                    modulationSourceNames[route->source],
+                    modulationDestinationNames[route->destination],
+                    (double) route->depth);
+        }
+        Uart1WriteStringIfReady(string);
+    }
+    for (index = 0; index < MODULATION_MATRIX_NUMBER_OF_LFOS; index++) {
+        snprintf(string, sizeof (string), "lfo%u %s %d%% %f Hz\r\n", index + 2,
+                lfoWaveformNames[parameters->lfos[index].waveform],
+                (int) (parameters->lfos[index].shape * 100.0f),
+                (double) parameters->lfos[index].frequency);
+        Uart1WriteStringIfReady(string);
+    }
+    snprintf(string, sizeof (string), "modenv %s %d ms %d ms %d%% %d ms %s\r\n",
+            parameters->envelope.mode == EnvelopeModeAd ? "ad" : "adsr",
+            (int) (parameters->envelope.attack * 1000.0f),
+            (int) (parameters->envelope.decay * 1000.0f),
+            (int) (parameters->envelope.sustain * 100.0f),
+            (int) (parameters->envelope.release * 1000.0f),
+            parameters->envelope.retrigger == EnvelopeRetriggerReset ? "reset" : "analog");
+    Uart1WriteStringIfReady(string);
+}
+
+/**
+ * @brief Parses envelope parameters.  The mode defaults to "adsr" and the
+ * retrigger defaults to "analog".
+ * @param arguments Attack, decay and release times in milliseconds and sustain
+ * level in percent, followed by optional mode ("adsr" or "ad") and retrigger
+ * ("analog" or "reset") names.
+ * @param envelopeParameters Envelope parameters to be written to.
+ * @return True if successful.
+ */
+static bool ParseEnvelope(const char* const arguments, EnvelopeParameters * const envelopeParameters) {
+
+    // Parse times and sustain level
+    long values[4];
+    const char* argument = arguments;
+    unsigned int index;
+    for (index = 0; index < (sizeof (values) / sizeof (long)); index++) {
+        char* end;
+        values[index] = strtol(argument, &end, 10);
+        if ((end == argument) || (values[index] < 0) || ((*end != ' ') && (*end != '\0'))) {
+            return false;
+        }
+        argument = end;
+    }
+    if (values[2] > 100) {
+        return false;
+    }
+    envelopeParameters->mode = EnvelopeModeAdsr;
+    envelopeParameters->retrigger = EnvelopeRetriggerAnalog;
+    envelopeParameters->attack = (float) values[0] * 0.001f;
+    envelopeParameters->decay = (float) values[1] * 0.001f;
+    envelopeParameters->sustain = (float) values[2] * 0.01f;
+    envelopeParameters->release = (float) values[3] * 0.001f;
+
+    // Parse mode and retrigger names
+    static const char* const envelopeNames[] = {"adsr", "ad", "analog", "reset"};
+    while (*argument == ' ') {
+        unsigned int name;
+        argument = ParseName(argument + 1, envelopeNames, sizeof (envelopeNames) / sizeof (char*), &name);
+        if (argument == NULL) {
+            return false;
+        }
+        switch (name) {
+            case 0:
+                envelopeParameters->mode = EnvelopeModeAdsr;
+                break;
+            case 1:
+                envelopeParameters->mode = EnvelopeModeAd;
+                break;
+            case 2:
+                envelopeParameters->retrigger = EnvelopeRetriggerAnalog;
+                break;
+            default:
+                envelopeParameters->retrigger = EnvelopeRetriggerReset;
+                break;
+        }
+    }
+    return *argument == '\0';
+}
+
+/**
+ * @brief Matches the name at the start of the arguments with a list of names.
+ * @param arguments Arguments starting with the name.
+ * @param names Names.
+ * @param numberOfNames Number of names.
+ * @param index Index of the matched name.
+ * @return Arguments following the name, or NULL if there is no match.
+ */
+static const char* ParseName(const char* const arguments, const char* const * const names, const unsigned int numberOfNames, unsigned int * const index) {
+    const char* nameEnd = strchr(arguments, ' ');
+    if (nameEnd == NULL) {
+        nameEnd = &arguments[strlen(arguments)];
+    }
+    const size_t length = nameEnd - arguments;
+    for (*index = 0; *index < numberOfNames; (*index)++) {
+        if ((strlen(names[*index]) == length) && (strncmp(arguments, names[*index], length) == 0)) {
+            return nameEnd;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Sets VCO 2.  VCO 2 is not stored in presets.
+ * @param arguments "off", or the modulation ("mix", "fm", "sync" or "ring")
+ * followed by the waveform name, frequency ratio and amount.
+ */
+static void Vco2(const char* const arguments) {
+    if (strcmp(arguments, "off") == 0) {
+        SynthesiserSetVco2(&defaultVco2Parameters);
+        return;
+    }
+    unsigned int modulation;
+    unsigned int waveform;
+    const char* argument = ParseName(arguments, vcoModulationNames, VcoModulationNumberOfModulations, &modulation);
+    if ((argument != NULL) && (*argument == ' ')) {
+        argument = ParseName(argument + 1, vcoWaveformNames, VcoWaveformNumberOfWaveforms, &waveform);
+    } else {
+        argument = NULL;
+    }
+    if ((argument == NULL) || (*argument != ' ')) {
+        Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        return;
+    }
+    char* end;
+    const float ratio = strtof(argument, &end);
+    const float amount = ((end != argument) && (*end == ' ')) ? strtof(end, &end) : -1.0f;
+    if ((ratio <= 0.0f) || (amount < 0.0f) || (*end != '\0')) {
+        Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        return;
+    }
+    const Vco2Parameters vco2Parameters = {
+        .modulation = modulation,
+        .waveform = waveform,
+        .ratio = ratio,
+        .amount = amount,
+    };
+    SynthesiserSetVco2(&vco2Parameters);
+}
+
+/**
+ * @brief Sets unison.  Unison is not stored in presets.
+ * @param arguments "off", or the number of voices followed by the spread in
+ * cents and the mix of the detuned voices in percent.
+ */
+static void Unison(const char* const arguments) {
+    if (strcmp(arguments, "off") == 0) {
+        SynthesiserSetUnison(&defaultUnisonParameters);
+        return;
+    }
+    long values[3];
+    const char* argument = arguments;
+    unsigned int index;
+    for (index = 0; index < (sizeof (values) / sizeof (long)); index++) {
+        char* end;
+        values[index] = strtol(argument, &end, 10);
+        if ((end == argument) || (values[index] < 0) || ((*end != ' ') && (*end != '\0'))) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+            return;
+        }
+        argument = end;
+    }
+    if ((*argument != '\0') || (values[0] < 1) || (values[0] > UNISON_MAXIMUM_NUMBER_OF_VOICES) || (values[2] > 100)) {
+        Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        return;
+    }
+    const UnisonParameters unisonParameters = {
+        .numberOfVoices = (unsigned int) values[0],
+        .spread = (float) values[1],
+        .mix = (float) values[2] * 0.01f,
+    };
+    SynthesiserSetUnison(&unisonParameters);
+}
+
+/**
+ * @brief Prints or sets pitch glide, quantiser scale and tuning.  Pitch
+ * parameters are not stored in presets.
+ * @param arguments Empty to print, "glide" followed by the glide time in
+ * milliseconds, "scale" followed by the scale name, or "tune" followed by
+ * "default" or the reference frequency in Hz and the degrees in cents.  The
+ * last degree is the period, e.g. "tune 261.6256 100 200 ... 1200".
+ */
+static void Pitch(const char* const arguments) {
+    PitchParameters parameters;
+    SynthesiserGetPitch(&parameters);
+
+    // Print pitch
+    if (*arguments == '\0') {
+        PrintPitch(&parameters);
+        return;
+    }
+
+    // Glide
+    if (strncmp(arguments, "glide ", 6) == 0) {
+        char* end;
+        const long glideTime = strtol(&arguments[6], &end, 10);
+        if ((end == &arguments[6]) || (glideTime < 0) || (*end != '\0')) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+            return;
+        }
+        parameters.glideTime = (float) glideTime * 0.001f;
+        SynthesiserSetPitch(&parameters);
+        return;
+    }
+
+    // Scale
+    if (strncmp(arguments, "scale ", 6) == 0) {
+        unsigned int scale;
+        const char* const argument = ParseName(&arguments[6], pitchScaleNames, PitchScaleNumberOfScales, &scale);
+        if ((argument == NULL) || (*argument != '\0')) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+            return;
+        }
+        parameters.scale = scale;
+        SynthesiserSetPitch(&parameters);
+        return;
+    }
+
+    // Tuning
+    if (strcmp(arguments, "tune default") == 0) {
+        parameters.tuning = defaultPitchParameters.tuning;
+        SynthesiserSetPitch(&parameters);
+        return;
+    }
+    if (strncmp(arguments, "tune ", 5) == 0) {
+        const char* argument = &arguments[5];
+        char* end;
+        parameters.tuning.reference = strtof(argument, &end);
+        parameters.tuning.numberOfDegrees = 0;
+        while ((end != argument) && (*end == ' ') && (parameters.tuning.numberOfDegrees < PITCH_MAXIMUM_NUMBER_OF_DEGREES)) {
+            argument = end;
+            parameters.tuning.degrees[parameters.tuning.numberOfDegrees++] = strtof(argument, &end);
+        }
+        if ((end == argument) || (*end != '\0') || (SynthesiserSetPitch(&parameters) == false)) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        }
+        return;
+    }
+    Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+}
+
+/**
+ * @brief Prints pitch parameters.
+ * @param parameters Pitch parameters.
+ */
+static void PrintPitch(const PitchParameters * const parameters) {
+    char string[64];
+    snprintf(string, sizeof (string), "\r\nglide %d ms\r\nscale %s\r\ntune %f", (int) (parameters->glideTime * 1000.0f),
+            pitchScaleNames[parameters->scale],
+            (double) parameters->tuning.reference);
+    Uart1WriteStringIfReady(string);
+    unsigned int index;
+    for (index = 0; index < parameters->tuning.numberOfDegrees; index++) {
+        snprintf(string, sizeof (string), " %f", (double) parameters->tuning.degrees[index]);
+        Uart1WriteStringIfReady(string);
+    }
+    Uart1WriteStringIfReady("\r\n");
+}
+
+#ifdef MODULATION_EFFECTS_ENABLED
+
+/**
+ * @brief Sets modulation effect.
+ * @param arguments "off", "chorus", "flanger" or "phaser".
+ */
+static void ModulationEffects(const char* const arguments) {
+    static const char* const effectNames[ModulationEffectNumberOfEffects] = {
+        "off",
+        "chorus",
+        "flanger",
+        "phaser",
+    };
+    ModulationEffect effect;
+    for (effect = 0; effect < ModulationEffectNumberOfEffects; effect++) {
+        if (strcmp(arguments, effectNames[effect]) == 0) {
+            ModulationEffectsSetEffect(effect);
+            return;
+        }
+    }
+    Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+}
+
+#endif
+
+#ifdef REVERB_ENABLED
+
+/**
+ * @brief Sets reverb mix.
+ * @param arguments Mix as a percentage, 0 to 100.
+ */
+static void Reverb(const char* const arguments) {
+    char* end;
+    const long mix = strtol(arguments, &end, 10);
+    if ((end == arguments) || (*end != '\0') || (mix < 0) || (mix > 100)) {
+        Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        return;
+    }
+    ReverbSetMix((float) mix * 0.01f);
+}
+
+#endif
+
+#ifdef CONVOLUTION_ENABLED
+
+/**
+ * @brief Loads impulse response for convolution.  An impulse response is
+ * loaded as:
+ * - "ir begin <length>" where length is the number of taps.
+ * - "ir data <hex>" repeated until all taps are sent.  Each tap is four
+ *   hexadecimal characters representing a signed 16-bit Q15 value, e.g.
+ *   "7FFF" is 0.99997 and "C000" is -0.5.  Up to 60 taps may be sent per line.
+ * - "ir end" to enable convolution.
+ * "ir off" disables convolution and "ir" prints the current length.
+ * @param arguments Arguments.
+ */
+static void ImpulseResponse(const char* const arguments) {
+    char string[48];
+    if (*arguments == '\0') {
+        snprintf(string, sizeof (string), "\r\nIR LENGTH: %u\r\n", ConvolutionGetLength());
+        Uart1WriteStringIfReady(string);
+        return;
+    }
+    if (strncmp(arguments, "begin ", 6) == 0) {
+        char* end;
+        const long length = strtol(&arguments[6], &end, 10);
+        if ((end == &arguments[6]) || (*end != '\0') || (length <= 0) || (ConvolutionLoadBegin((unsigned int) length) == false)) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        }
+        return;
+    }
+    if (strncmp(arguments, "data ", 5) == 0) {
+        const char* const error = LoadHexSamples(&arguments[5], &ConvolutionLoadTap, "\r\nIR load failed\r\n");
+        if (error != NULL) {
+            Uart1WriteStringIfReady(error);
+        }
+        return;
+    }
+    if (strcmp(arguments, "end") == 0) {
+        if (ConvolutionLoadEnd() == false) {
+            Uart1WriteStringIfReady("\r\nIR load failed\r\n");
+            return;
+        }
+        snprintf(string, sizeof (string), "\r\nIR LOADED: %u taps\r\n", ConvolutionGetLength());
+        Uart1WriteStringIfReady(string);
+        return;
+    }
+    if (strcmp(arguments, "off") == 0) {
+        ConvolutionDisable();
+        return;
+    }
+    Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+}
+
+#endif
+
+#ifdef WAVETABLE_ENABLED
+
+/**
+ * @brief Sets the wavetable position or loads wavetables.  Tables are loaded
+ * as:
+ * - "wt begin <tables>" where tables is the number of tables.
+ * - "wt data <hex>" repeated until all samples are sent.  Each table is
+ *   WAVETABLE_LENGTH samples of one period in the same format as "ir data".
+ * - "wt end" to use the tables.
+ * "wt default" restores the default tables, "wt pos <0-100>" sets the position
+ * and "wt" prints the number of tables.
+ * @param arguments Arguments.
+ */
+static void Wavetable(const char* const arguments) {
+    char string[48];
+    if (*arguments == '\0') {
+        snprintf(string, sizeof (string), "\r\nWAVETABLES: %u\r\n", WavetableGetNumberOfTables());
+        Uart1WriteStringIfReady(string);
+        return;
+    }
+    if (strncmp(arguments, "pos ", 4) == 0) {
+        char* end;
+        const long position = strtol(&arguments[4], &end, 10);
+        if ((end == &arguments[4]) || (*end != '\0') || (position < 0) || (position > 100)) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+            return;
+        }
+        SynthesiserSetWavetablePosition((float) position * 0.01f);
+        return;
+    }
+    if (strncmp(arguments, "begin ", 6) == 0) {
+        char* end;
+        const long numberOfTables = strtol(&arguments[6], &end, 10);
+        if ((end == &arguments[6]) || (*end != '\0') || (numberOfTables <= 0) || (WavetableLoadBegin((unsigned int) numberOfTables) == false)) {
+            Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+        }
+        return;
+    }
+    if (strncmp(arguments, "data ", 5) == 0) {
+        const char* const error = LoadHexSamples(&arguments[5], &WavetableLoadSample, "\r\nWavetable load failed\r\n");
+        if (error != NULL) {
+            Uart1WriteStringIfReady(error);
+        }
+        return;
+    }
+    if (strcmp(arguments, "end") == 0) {
+        if (WavetableLoadEnd() == false) {
+            Uart1WriteStringIfReady("\r\nWavetable load failed\r\n");
+            return;
+        }
+        snprintf(string, sizeof (string), "\r\nWAVETABLES LOADED: %u\r\n", WavetableGetNumberOfTables());
+        Uart1WriteStringIfReady(string);
+        return;
+    }
+    if (strcmp(arguments, "default") == 0) {
+        WavetableLoadDefault();
+        return;
+    }
+    Uart1WriteStringIfReady("\r\nInvalid argument\r\n");
+}
+
+#endif
+
+#if defined(CONVOLUTION_ENABLED) || defined(WAVETABLE_ENABLED)
+
+/**
+ * @brief Loads samples from a string of hexadecimal characters.  Each sample
+ * is four hexadecimal characters representing a signed 16-bit Q15 value.
+ * @param hex Hexadecimal characters.
+ * @param loadSample Function called for each sample.  Returns false if the
+ * sample could not be loaded.
+ * @param loadFailedMessage Message returned if a sample could not be loaded.
+ * @return Message to be printed, or NULL if successful.
+ */
+static const char* LoadHexSamples(const char* hex, bool (*loadSample)(const float sample), const char* const loadFailedMessage) {
+    while (*hex != '\0') {
+        const int digit0 = HexToInt(hex[0]);
+        const int digit1 = (digit0 < 0) ? -1 : HexToInt(hex[1]);
+        const int digit2 = (digit1 < 0) ? -1 : HexToInt(hex[2]);
+        const int digit3 = (digit2 < 0) ? -1 : HexToInt(hex[3]);
+        if (digit3 < 0) {
+            return "\r\nInvalid argument\r\n";
+        }
+        const int16_t sample = (int16_t) ((digit0 << 12) | (digit1 << 8) | (digit2 << 4) | digit3);
+        if (loadSample((float) sample * (1.0f / 32768.0f)) == false) {
+            return loadFailedMessage;
+        }
+        hex += 4;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Converts hexadecimal character to integer.
+ * @param character Character.
+ * @return 0 to 15, or -1 if the character is not hexadecimal.
+ */
+static int HexToInt(const char character) {
+    if ((character >= '0') && (character <= '9')) {
+        return character - '0';
+    }
+    if ((character >= 'A') && (character <= 'F')) {
+        return character - 'A' + 10;
+    }
+    if ((character >= 'a') && (character <= 'f')) {
+        return character - 'a' + 10;
+    }
+    return -1;
+}
+
+#endif
+
+#ifdef TRACE_ENABLED
+
+/**
+ * @brief Dumps trace log.
+ * @param arguments Unused.
+ */
+static void Trace(const char* const arguments) {
+    TraceDump();
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,18 @@
+/**
+ * @file SerialInterface.h
+ * @author Seb Madgwick
+ * @brief Serial interface module.  Interprets text commands received by UART 1.
+ */
+
+#ifndef SERIAL_INTERFACE_H
+#define SERIAL_INTERFACE_H
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void SerialInterfaceTasks();
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
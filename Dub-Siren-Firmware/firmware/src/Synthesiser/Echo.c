@@ -0,0 +1,309 @@
+/**
+ * @file Echo.c
+ * @author Seb Madgwick
+ * @brief Tape and bucket brigade device (BBD) echo models for the delay
+ * feedback path.
+ *
+ * The tape model modulates the read head position with wow, flutter and random
+ * drift, saturates the record head and applies high-frequency loss and a head
+ * bump resonance on playback.  The modulation is centred on zero so that the
+ * average delay time matches the delay time parameter.  The modulators keep
+ * running when the model changes and the modulation depth is faded so that the
+ * delay time does not jump.
+ *
+ * The BBD model compands the signal with a 2:1 compressor on record and a 1:2
+ * expander on playback.  The playback signal is held at the BBD clock
+ * frequency, which aliases, and then low-pass filtered at a cutoff
+ * proportional to the clock frequency.  The clock frequency is inversely
+ * proportional to the delay time so longer delays are darker.
+ *
+ * Modulation and filter coefficients are updated at the control rate by
+ * EchoUpdate.  Modulation is ramped linearly between updates.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Dac/Dac.h" // SAMPLE_FREQUENCY
+#include "Echo.h"
+#include "FastMath/FastMath.h"
+#include <math.h> // fabsf, M_PI
+#include "MathHelpers.h"
+#include "Saturation/Saturation.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Tape wow frequency in Hz and depth in seconds.
+ */
+#define WOW_FREQUENCY (0.6f)
+#define WOW_DEPTH (0.0008f)
+
+/**
+ * @brief Tape flutter frequency in Hz and depth in seconds.
+ */
+#define FLUTTER_FREQUENCY (7.0f)
+#define FLUTTER_DEPTH (0.00003f)
+
+/**
+ * @brief Tape drift depth in seconds and smoothing coefficient per update.
+ */
+#define DRIFT_DEPTH (0.0005f)
+#define DRIFT_COEFFICIENT (0.002f)
+
+/**
+ * @brief Time in seconds to fade the tape modulation depth in or out when the
+ * model changes.
+ */
+#define MODULATION_FADE_TIME (0.5f)
+
+/**
+ * @brief Read head offset in samples below which a modulation fading out is
+ * considered to have ended.
+ */
+#define MODULATION_THRESHOLD (0.001f)
+
+/**
+ * @brief Tape record head drive.  Small signals have unity gain.
+ */
+#define TAPE_DRIVE (2.0f)
+
+/**
+ * @brief Tape playback high-frequency loss corner frequency in Hz.
+ */
+#define TAPE_LOW_PASS_FREQUENCY (7000.0f)
+
+/**
+ * @brief Tape head bump frequency in Hz, damping (1 / Q) and gain.  The
+ * resulting boost is approximately 3 dB.
+ */
+#define HEAD_BUMP_FREQUENCY (90.0f)
+#define HEAD_BUMP_DAMPING (0.67f)
+#define HEAD_BUMP_GAIN (0.3f)
+
+/**
+ * @brief Number of BBD stages.  Equivalent to an MN3005.
+ */
+#define BBD_STAGES (4096.0f)
+
+/**
+ * @brief BBD low-pass cutoff as a fraction of the clock frequency, and the
+ * maximum cutoff in Hz.
+ */
+#define BBD_CUTOFF_RATIO (0.45f)
+#define BBD_MAXIMUM_CUTOFF (15000.0f)
+
+/**
+ * @brief Minimum delay time in seconds used to calculate the BBD clock
+ * frequency.
+ */
+#define BBD_MINIMUM_DELAY_TIME (0.001f)
+
+/**
+ * @brief Compander envelope coefficient, equivalent to a 10 ms time constant.
+ */
+#define COMPANDER_COEFFICIENT (1.0f / (0.01f * SAMPLE_FREQUENCY))
+
+/**
+ * @brief Compander envelope floor.  Signals below this level have a fixed gain
+ * so that the compressor gain is bounded.
+ */
+#define COMPANDER_FLOOR (0.01f)
+
+/**
+ * @brief Expander envelope floor.  Square root of COMPANDER_FLOOR so that
+ * signals below the floor have unity gain through the compander.
+ */
+#define EXPANDER_FLOOR (0.1f)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void ResetState(Echo * const echo);
+static inline __attribute__((always_inline)) float OnePoleCoefficient(const float cornerFrequency);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises the echo structure for the specified model.  All state is
+ * reset.
+ * @param echo Echo structure.
+ * @param model Delay model.
+ */
+void EchoInitialise(Echo * const echo, const DelayModel model) {
+    *echo = (Echo){
+        .model = model,
+        .modulationDepth = model == DelayModelTape ? 1.0f : 0.0f,
+    };
+    RandomInitialise(&echo->random, 1);
+    ResetState(echo);
+}
+
+/**
+ * @brief Sets the model.  The record and playback state is reset but the
+ * modulators continue so that the delay time does not jump.
+ * @param echo Echo structure.
+ * @param model Delay model.
+ */
+void EchoSetModel(Echo * const echo, const DelayModel model) {
+    echo->model = model;
+    ResetState(echo);
+}
+
+/**
+ * @brief Resets the record and playback state of the current model.
+ * @param echo Echo structure.
+ */
+static void ResetState(Echo * const echo) {
+    echo->clockIncrement = 1.0f;
+    echo->lowPassCoefficient = echo->model == DelayModelTape ? OnePoleCoefficient(TAPE_LOW_PASS_FREQUENCY) : 1.0f;
+    echo->headBumpLowPass = 0.0f;
+    echo->headBumpBandPass = 0.0f;
+    echo->lowPass[0] = 0.0f;
+    echo->lowPass[1] = 0.0f;
+    echo->clockPhase = 0.0f;
+    echo->heldSample = 0.0f;
+    echo->recordEnvelope = COMPANDER_FLOOR;
+    echo->playbackEnvelope = EXPANDER_FLOOR;
+}
+
+/**
+ * @brief Updates control rate modulation and coefficients.  This function
+ * should be called once before each block of samples.
+ * @param echo Echo structure.
+ * @param delayTime Delay time in seconds.
+ * @param numberOfSamples Number of samples until the next update.
+ */
+void EchoUpdate(Echo * const echo, const float delayTime, const unsigned int numberOfSamples) {
+    const float updatePeriod = (float) numberOfSamples * (1.0f / SAMPLE_FREQUENCY);
+
+    // Tape modulation
+    echo->wowPhase += WOW_FREQUENCY * updatePeriod;
+    echo->wowPhase -= (float) FastMathFloorToInt(echo->wowPhase);
+    echo->flutterPhase += FLUTTER_FREQUENCY * updatePeriod;
+    echo->flutterPhase -= (float) FastMathFloorToInt(echo->flutterPhase);
+    echo->drift += ((DRIFT_DEPTH * SAMPLE_FREQUENCY) * RandomNextFloat(&echo->random) - echo->drift) * DRIFT_COEFFICIENT;
+    if (echo->model == DelayModelTape) {
+        echo->modulationDepth = MIN(echo->modulationDepth + updatePeriod * (1.0f / MODULATION_FADE_TIME), 1.0f);
+    } else {
+        echo->modulationDepth = MAX(echo->modulationDepth - updatePeriod * (1.0f / MODULATION_FADE_TIME), 0.0f);
+    }
+    if ((echo->modulationDepth == 0.0f) && (fabsf(echo->modulation) < MODULATION_THRESHOLD)) {
+        echo->modulation = 0.0f;
+        echo->modulationIncrement = 0.0f;
+    } else {
+        const float target = echo->modulationDepth * ((WOW_DEPTH * SAMPLE_FREQUENCY) * FastMathSinCycles(echo->wowPhase)
+                + (FLUTTER_DEPTH * SAMPLE_FREQUENCY) * FastMathSinCycles(echo->flutterPhase)
+                + echo->drift);
+        echo->modulationIncrement = (target - echo->modulation) * FastMathReciprocal((float) numberOfSamples);
+    }
+
+    // Model coefficients
+    switch (echo->model) {
+        case DelayModelBucketBrigade:
+        {
+            const float clockFrequency = BBD_STAGES * FastMathReciprocal(2.0f * MAX(delayTime, BBD_MINIMUM_DELAY_TIME));
+            echo->clockIncrement = clockFrequency * (1.0f / SAMPLE_FREQUENCY);
+            echo->lowPassCoefficient = OnePoleCoefficient(MIN(BBD_CUTOFF_RATIO * clockFrequency, BBD_MAXIMUM_CUTOFF));
+            break;
+        }
+        case DelayModelTape:
+        case DelayModelDigital:
+        case DelayModelNumberOfModels:
+            break;
+    }
+}
+
+/**
+ * @brief Returns true if the read head is modulated.  The read head remains
+ * modulated after the model changes from tape until the modulation has faded
+ * out.
+ * @param echo Echo structure.
+ * @return True if the read head is modulated.
+ */
+bool EchoIsModulated(const Echo * const echo) {
+    return (echo->modulation != 0.0f) || (echo->modulationIncrement != 0.0f);
+}
+
+/**
+ * @brief Returns the read head offset for the current sample.  This function
+ * should be called once per sample.
+ * @param echo Echo structure.
+ * @return Read head offset in samples to be added to the delay time.  May be
+ * negative.
+ */
+float EchoGetModulation(Echo * const echo) {
+    echo->modulation += echo->modulationIncrement;
+    return echo->modulation;
+}
+
+/**
+ * @brief Processes a sample written to the delay buffer.
+ * @param echo Echo structure.
+ * @param sample Sample.
+ * @return Processed sample.
+ */
+float EchoRecord(Echo * const echo, const float sample) {
+    switch (echo->model) {
+        case DelayModelTape:
+            return SaturationSoftClip(TAPE_DRIVE * sample) * (1.0f / TAPE_DRIVE);
+        case DelayModelBucketBrigade:
+            echo->recordEnvelope += (MAX(fabsf(sample), COMPANDER_FLOOR) - echo->recordEnvelope) * COMPANDER_COEFFICIENT;
+            return sample * FastMathReciprocalSquareRoot(echo->recordEnvelope);
+        case DelayModelDigital:
+        case DelayModelNumberOfModels:
+            break;
+    }
+    return sample;
+}
+
+/**
+ * @brief Processes a sample read from the delay buffer.
+ * @param echo Echo structure.
+ * @param sample Sample.
+ * @return Processed sample.
+ */
+float EchoPlayback(Echo * const echo, const float sample) {
+    switch (echo->model) {
+        case DelayModelTape:
+        {
+            echo->lowPass[0] += (sample - echo->lowPass[0]) * echo->lowPassCoefficient;
+            const float highPass = echo->lowPass[0] - echo->headBumpLowPass - HEAD_BUMP_DAMPING * echo->headBumpBandPass;
+            echo->headBumpBandPass += (float) (2.0 * M_PI * HEAD_BUMP_FREQUENCY / SAMPLE_FREQUENCY) * highPass;
+            echo->headBumpLowPass += (float) (2.0 * M_PI * HEAD_BUMP_FREQUENCY / SAMPLE_FREQUENCY) * echo->headBumpBandPass;
+            echo->headBumpLowPass = QUANTISE_TO_ZERO(echo->headBumpLowPass);
+            return echo->lowPass[0] + HEAD_BUMP_GAIN * echo->headBumpBandPass;
+        }
+        case DelayModelBucketBrigade:
+        {
+            echo->clockPhase += echo->clockIncrement;
+            if (echo->clockPhase >= 1.0f) {
+                echo->clockPhase -= (float) FastMathFloorToInt(echo->clockPhase);
+                echo->heldSample = sample;
+            }
+            echo->lowPass[0] += (echo->heldSample - echo->lowPass[0]) * echo->lowPassCoefficient;
+            echo->lowPass[1] += (echo->lowPass[0] - echo->lowPass[1]) * echo->lowPassCoefficient;
+            echo->lowPass[1] = QUANTISE_TO_ZERO(echo->lowPass[1]);
+            echo->playbackEnvelope += (MAX(fabsf(echo->lowPass[1]), EXPANDER_FLOOR) - echo->playbackEnvelope) * COMPANDER_COEFFICIENT;
+            return echo->lowPass[1] * echo->playbackEnvelope;
+        }
+        case DelayModelDigital:
+        case DelayModelNumberOfModels:
+            break;
+    }
+    return sample;
+}
+
+/**
+ * @brief Returns the coefficient of a one-pole low-pass filter.
+ * @param cornerFrequency Corner frequency in Hz.
+ * @return One-pole low-pass filter coefficient.
+ */
+static inline __attribute__((always_inline)) float OnePoleCoefficient(const float cornerFrequency) {
+    return 1.0f - FastMathExp2((float) (-2.0 * M_PI / M_LN2) * cornerFrequency * (1.0f / SAMPLE_FREQUENCY));
+}
+
+//------------------------------------------------------------------------------
+// End of file
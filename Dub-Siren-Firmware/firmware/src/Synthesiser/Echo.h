@@ -0,0 +1,63 @@
+/**
+ * @file Echo.h
+ * @author Seb Madgwick
+ * @brief Tape and bucket brigade device (BBD) echo models for the delay
+ * feedback path.
+ */
+
+#ifndef ECHO_H
+#define ECHO_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Random/Random.h"
+#include <stdbool.h>
+#include "Synthesiser.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Echo structure.  Structure members are used internally and should not
+ * be used by the user application.
+ */
+typedef struct {
+    DelayModel model;
+
+    // Control rate
+    float wowPhase; // cycles
+    float flutterPhase; // cycles
+    float drift; // samples
+    Random random;
+    float modulationDepth; // 0.0 to 1.0, faded when the model changes
+    float modulation; // read head offset in samples
+    float modulationIncrement; // per sample
+    float clockIncrement; // BBD clock cycles per sample
+    float lowPassCoefficient;
+
+    // Per sample
+    float headBumpLowPass;
+    float headBumpBandPass;
+    float lowPass[2];
+    float clockPhase;
+    float heldSample;
+    float recordEnvelope;
+    float playbackEnvelope;
+} Echo;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void EchoInitialise(Echo * const echo, const DelayModel model);
+void EchoSetModel(Echo * const echo, const DelayModel model);
+void EchoUpdate(Echo * const echo, const float delayTime, const unsigned int numberOfSamples);
+bool EchoIsModulated(const Echo * const echo);
+float EchoGetModulation(Echo * const echo);
+float EchoRecord(Echo * const echo, const float sample);
+float EchoPlayback(Echo * const echo, const float sample);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
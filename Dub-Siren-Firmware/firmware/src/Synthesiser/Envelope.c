@@ -0,0 +1,171 @@
+/**
+ * @file Envelope.c
+ * @author Seb Madgwick
+ * @brief ADSR or AD envelope with exponential segments.
+ *
+ * Each segment is a one-pole approach to a target so that each sample requires
+ * one multiply-add, as for an analogue envelope generator charging a capacitor.
+ * The attack targets a level above 1.0 so that it reaches 1.0 in the attack
+ * time with an analogue-like curve.  The decay to zero and the release target a
+ * level below 0.0 so that they reach zero and the envelope becomes idle.  The
+ * coefficients are calculated only when the parameters change.
+ *
+ * Stage transitions are made by EnvelopeUpdate, once per audio update.  The
+ * value is limited to 0.0 to 1.0 until the transition.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Envelope.h"
+#include "FastMath/FastMath.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Level above 1.0 targeted by the attack.  Larger values result in a
+ * more linear attack.
+ */
+#define ATTACK_OVERSHOOT (0.2f)
+
+/**
+ * @brief Level below 0.0 targeted by the decay to zero and the release.
+ * Equivalent to -60 dB so that decay and release times are the time to fall by
+ * 60 dB.
+ */
+#define RELEASE_UNDERSHOOT (0.001f)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static float CalculateCoefficient(const float time, const float ratio, const float sampleFrequency);
+static void SetStage(Envelope * const envelope, const EnvelopeStage stage);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises envelope structure.  EnvelopeSetParameters must be called
+ * before the envelope is triggered.
+ * @param envelope Envelope structure.
+ */
+void EnvelopeInitialise(Envelope * const envelope) {
+    envelope->value = 0.0f;
+    SetStage(envelope, EnvelopeStageIdle);
+}
+
+/**
+ * @brief Sets the envelope parameters.  The current stage continues with the
+ * new parameters.
+ * @param envelope Envelope structure.
+ * @param parameters Envelope parameters.
+ * @param sampleFrequency Sample frequency in Hz.
+ */
+void EnvelopeSetParameters(Envelope * const envelope, const EnvelopeParameters * const parameters, const float sampleFrequency) {
+    envelope->parameters = *parameters;
+    envelope->parameters.sustain = CLAMP(parameters->sustain, 0.0f, 1.0f);
+    envelope->attackCoefficient = CalculateCoefficient(parameters->attack, (1.0f + ATTACK_OVERSHOOT) / ATTACK_OVERSHOOT, sampleFrequency);
+    envelope->decayCoefficient = CalculateCoefficient(parameters->decay, (1.0f + RELEASE_UNDERSHOOT) / RELEASE_UNDERSHOOT, sampleFrequency);
+    envelope->releaseCoefficient = CalculateCoefficient(parameters->release, (1.0f + RELEASE_UNDERSHOOT) / RELEASE_UNDERSHOOT, sampleFrequency);
+    SetStage(envelope, envelope->stage);
+}
+
+/**
+ * @brief Calculates the coefficient of a one-pole approach to a target such
+ * that the difference between the value and the target reduces by a ratio in
+ * the specified time.
+ * @param time Time in seconds.
+ * @param ratio Ratio of the initial difference to the final difference.
+ * @param sampleFrequency Sample frequency in Hz.
+ * @return Coefficient.  0.0 if the time is zero so that the target is reached
+ * on the next sample.
+ */
+static float CalculateCoefficient(const float time, const float ratio, const float sampleFrequency) {
+    if (time <= 0.0f) {
+        return 0.0f;
+    }
+    return FastMathExp2(-FastMathLog2(ratio) / (time * sampleFrequency));
+}
+
+/**
+ * @brief Sets the stage coefficient and offset.
+ * @param envelope Envelope structure.
+ * @param stage Stage.
+ */
+static void SetStage(Envelope * const envelope, const EnvelopeStage stage) {
+    float target = 0.0f;
+    switch (stage) {
+        case EnvelopeStageIdle:
+            envelope->value = 0.0f;
+            envelope->coefficient = 0.0f;
+            break;
+        case EnvelopeStageAttack:
+            target = 1.0f + ATTACK_OVERSHOOT;
+            envelope->coefficient = envelope->attackCoefficient;
+            break;
+        case EnvelopeStageDecay:
+            target = envelope->parameters.mode == EnvelopeModeAdsr ? envelope->parameters.sustain : -RELEASE_UNDERSHOOT;
+            envelope->coefficient = envelope->decayCoefficient;
+            break;
+        case EnvelopeStageRelease:
+            target = -RELEASE_UNDERSHOOT;
+            envelope->coefficient = envelope->releaseCoefficient;
+            break;
+    }
+    envelope->offset = target * (1.0f - envelope->coefficient);
+    envelope->stage = stage;
+}
+
+/**
+ * @brief Starts the attack.  The attack starts from the current level or from
+ * zero depending on the retrigger parameter.
+ * @param envelope Envelope structure.
+ */
+void EnvelopeTrigger(Envelope * const envelope) {
+    if (envelope->parameters.retrigger == EnvelopeRetriggerReset) {
+        envelope->value = 0.0f;
+    }
+    SetStage(envelope, EnvelopeStageAttack);
+}
+
+/**
+ * @brief Starts the release.  Ignored in AD mode or if the envelope is idle.
+ * @param envelope Envelope structure.
+ */
+void EnvelopeRelease(Envelope * const envelope) {
+    if ((envelope->parameters.mode == EnvelopeModeAd) || (envelope->stage == EnvelopeStageIdle)) {
+        return;
+    }
+    SetStage(envelope, EnvelopeStageRelease);
+}
+
+/**
+ * @brief Makes stage transitions.  This function should be called once per
+ * audio update.
+ * @param envelope Envelope structure.
+ */
+void EnvelopeUpdate(Envelope * const envelope) {
+    switch (envelope->stage) {
+        case EnvelopeStageIdle:
+            break;
+        case EnvelopeStageAttack:
+            if (envelope->value >= 1.0f) {
+                SetStage(envelope, EnvelopeStageDecay);
+            }
+            break;
+        case EnvelopeStageDecay:
+            if ((envelope->parameters.mode == EnvelopeModeAd) && (envelope->value <= 0.0f)) {
+                SetStage(envelope, EnvelopeStageIdle);
+            }
+            break;
+        case EnvelopeStageRelease:
+            if (envelope->value <= 0.0f) {
+                SetStage(envelope, EnvelopeStageIdle);
+            }
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+// End of file
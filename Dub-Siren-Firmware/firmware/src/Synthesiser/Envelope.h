@@ -0,0 +1,80 @@
+/**
+ * @file Envelope.h
+ * @author Seb Madgwick
+ * @brief ADSR or AD envelope with exponential segments.
+ */
+
+#ifndef ENVELOPE_H
+#define ENVELOPE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "MathHelpers.h"
+#include <stdbool.h>
+#include "Synthesiser.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Envelope stage type.
+ */
+typedef enum {
+    EnvelopeStageIdle,
+    EnvelopeStageAttack,
+    EnvelopeStageDecay, // decays to the sustain level in ADSR mode or to zero in AD mode
+    EnvelopeStageRelease,
+} EnvelopeStage;
+
+/**
+ * @brief Envelope structure.  Structure members are used internally and should
+ * not be used by the user application.
+ */
+typedef struct {
+    EnvelopeParameters parameters;
+    EnvelopeStage stage;
+    float value;
+    float coefficient; // coefficient of current stage
+    float offset; // offset of current stage
+    float attackCoefficient;
+    float decayCoefficient;
+    float releaseCoefficient;
+} Envelope;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void EnvelopeInitialise(Envelope * const envelope);
+void EnvelopeSetParameters(Envelope * const envelope, const EnvelopeParameters * const parameters, const float sampleFrequency);
+void EnvelopeTrigger(Envelope * const envelope);
+void EnvelopeRelease(Envelope * const envelope);
+void EnvelopeUpdate(Envelope * const envelope);
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Returns true if the envelope is not idle.
+ * @param envelope Envelope structure.
+ * @return True if the envelope is not idle.
+ */
+static inline __attribute__((always_inline)) bool EnvelopeIsActive(const Envelope * const envelope) {
+    return envelope->stage != EnvelopeStageIdle;
+}
+
+/**
+ * @brief Returns the envelope value for the next sample.  Each sample requires
+ * one multiply-add.  Stage transitions are made by EnvelopeUpdate.
+ * @param envelope Envelope structure.
+ * @return Envelope value, 0.0 to 1.0.
+ */
+static inline __attribute__((always_inline)) float EnvelopeGetNext(Envelope * const envelope) {
+    envelope->value = CLAMP(envelope->value * envelope->coefficient + envelope->offset, 0.0f, 1.0f);
+    return envelope->value;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
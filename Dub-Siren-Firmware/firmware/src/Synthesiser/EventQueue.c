@@ -0,0 +1,96 @@
+/**
+ * @file EventQueue.c
+ * @author Seb Madgwick
+ * @brief Lock-free single-producer, single-consumer queue of timestamped
+ * synthesiser events.
+ *
+ * The producer (main program loop) only writes the in index and the consumer
+ * (audio update interrupt) only writes the out index.  Each index is published
+ * after the event data so that the other side never sees a partial event.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "EventQueue.h"
+#include <stddef.h> // NULL
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Event queue index mask.  This value is bitwise anded with the
+ * free-running indexes for optimised overflow calculations.
+ */
+#define EVENT_QUEUE_INDEX_BIT_MASK (EVENT_QUEUE_SIZE - 1)
+
+/**
+ * @brief Prevents the compiler reordering memory accesses across this point.
+ */
+#define COMPILER_BARRIER() __asm__ volatile("" : : : "memory")
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises event queue structure.
+ * @param eventQueue Event queue structure.
+ */
+void EventQueueInitialise(EventQueue * const eventQueue) {
+    eventQueue->inIndex = 0;
+    eventQueue->outIndex = 0;
+}
+
+/**
+ * @brief Returns the space available in the event queue in number of events.
+ * This function should only be called by the producer.
+ * @param eventQueue Event queue structure.
+ * @return Space available in the event queue in number of events.
+ */
+unsigned int EventQueueGetSpace(const EventQueue * const eventQueue) {
+    return EVENT_QUEUE_SIZE - (eventQueue->inIndex - eventQueue->outIndex);
+}
+
+/**
+ * @brief Pushes event to event queue.  This function should only be called by
+ * the producer.
+ * @param eventQueue Event queue structure.
+ * @param event Event to be pushed.
+ * @return True if successful, false if the event queue is full.
+ */
+bool EventQueuePush(EventQueue * const eventQueue, const SynthesiserEvent * const event) {
+    if (EventQueueGetSpace(eventQueue) == 0) {
+        return false;
+    }
+    eventQueue->events[eventQueue->inIndex & EVENT_QUEUE_INDEX_BIT_MASK] = *event;
+    COMPILER_BARRIER(); // event must be written before it is published
+    eventQueue->inIndex++;
+    return true;
+}
+
+/**
+ * @brief Returns the oldest event in the event queue without removing it.  This
+ * function should only be called by the consumer.
+ * @param eventQueue Event queue structure.
+ * @return Oldest event, or NULL if the event queue is empty.
+ */
+const SynthesiserEvent* EventQueuePeek(const EventQueue * const eventQueue) {
+    if (eventQueue->inIndex == eventQueue->outIndex) {
+        return NULL;
+    }
+    COMPILER_BARRIER(); // event must not be read before it is published
+    return &eventQueue->events[eventQueue->outIndex & EVENT_QUEUE_INDEX_BIT_MASK];
+}
+
+/**
+ * @brief Removes the oldest event from the event queue.  This function should
+ * only be called by the consumer after EventQueuePeek has returned an event.
+ * @param eventQueue Event queue structure.
+ */
+void EventQueuePop(EventQueue * const eventQueue) {
+    COMPILER_BARRIER(); // event must be read before it is released
+    eventQueue->outIndex++;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,47 @@
+/**
+ * @file EventQueue.h
+ * @author Seb Madgwick
+ * @brief Lock-free single-producer, single-consumer queue of timestamped
+ * synthesiser events.
+ */
+
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+#include "Synthesiser.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Event queue size in number of events.  Must be a 2^n number.
+ */
+#define EVENT_QUEUE_SIZE (32)
+
+/**
+ * @brief Event queue structure.  Structure members are used internally and
+ * should not be used by the user application.
+ */
+typedef struct {
+    SynthesiserEvent events[EVENT_QUEUE_SIZE];
+    volatile unsigned int inIndex; // only written to by producer
+    volatile unsigned int outIndex; // only written to by consumer
+} EventQueue;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void EventQueueInitialise(EventQueue * const eventQueue);
+unsigned int EventQueueGetSpace(const EventQueue * const eventQueue);
+bool EventQueuePush(EventQueue * const eventQueue, const SynthesiserEvent * const event);
+const SynthesiserEvent* EventQueuePeek(const EventQueue * const eventQueue);
+void EventQueuePop(EventQueue * const eventQueue);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,206 @@
+/**
+ * @file Lfo.c
+ * @author Seb Madgwick
+ * @brief LFO waveform with coefficients cached for the current shape.
+ *
+ * Shape-dependent coefficients are calculated only when the waveform or shape
+ * changes so that each sample requires only multiply-adds and, for stepped
+ * waveforms, a floor.
+ *
+ * Random waveforms draw a new value from the xorshift generator of each LFO
+ * once per step so that the generator is evaluated at the step rate rather than
+ * the sample rate.  The generator is owned by each LFO so that LFOs do not
+ * share a sequence.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "FastMath/FastMath.h"
+#include "Lfo.h"
+#include <math.h> // fabsf
+#include "MathHelpers.h"
+#include "Waveforms.h"
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void SetPiecewiseLinear(Lfo * const lfo, const float startValue, const float breakpointValue, const float endValue);
+static inline __attribute__((always_inline)) float PiecewiseLinear(const Lfo * const lfo, const float normalisedPeriod);
+static inline __attribute__((always_inline)) float UpdateRandom(Lfo * const lfo, const float normalisedPeriod);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises the LFO structure.
+ * @param lfo LFO structure.
+ * @param seed Seed of the random waveforms.  Each LFO should use a different
+ * seed.
+ */
+void LfoInitialise(Lfo * const lfo, const uint32_t seed) {
+    RandomInitialise(&lfo->random, seed);
+    lfo->step = 0;
+    lfo->normalisedPeriod = 0.0f;
+    lfo->randomValues[0] = 0.0f;
+    lfo->randomValues[1] = RandomNextFloat(&lfo->random);
+    lfo->waveform = LfoWaveformNumberOfWaveforms; // force calculation of coefficients
+    LfoSetShape(lfo, LfoWaveformSine, 0.5f);
+}
+
+/**
+ * @brief Sets the waveform and shape.  Coefficients are only recalculated if
+ * the waveform or shape has changed.
+ * @param lfo LFO structure.
+ * @param waveform Waveform.
+ * @param shape 0.0 to 1.0.  See LfoGetAmplitude for the effect on each
+ * waveform.
+ */
+void LfoSetShape(Lfo * const lfo, const LfoWaveform waveform, const float shape) {
+    if ((waveform == lfo->waveform) && (shape == lfo->shape)) {
+        return;
+    }
+    lfo->waveform = waveform;
+    lfo->shape = shape;
+    switch (waveform) {
+        case LfoWaveformSine:
+            SetPiecewiseLinear(lfo, -0.25f, 0.25f, 0.75f); // skewed normalised period offset by -0.25 so that the waveform starts at a minimum
+            break;
+        case LfoWaveformTriangle:
+            SetPiecewiseLinear(lfo, -1.0f, 1.0f, -1.0f);
+            break;
+        case LfoWaveformSawtooth:
+            lfo->gradientA = 2.0f * (1.0f + shape * shape * 10.0f);
+            break;
+        case LfoWaveformSquare:
+            lfo->breakpoint = shape;
+            break;
+        case LfoWaveformSteppedTriangle:
+        {
+            const float numberOfStepsMinusOne = (float) (2 + ROUND(shape * 29.0f));
+            lfo->steps = numberOfStepsMinusOne;
+            lfo->stepAmplitude = 2.0f / numberOfStepsMinusOne;
+            break;
+        }
+        case LfoWaveformSteppedSawtooth:
+        {
+            const float numberOfSteps = (float) (3 + ROUND(shape * 29.0f));
+            lfo->steps = numberOfSteps;
+            lfo->stepAmplitude = 2.0f / (numberOfSteps - 1.0f);
+            break;
+        }
+        case LfoWaveformSampleAndHold:
+        case LfoWaveformSmoothRandom:
+            lfo->steps = (float) (1 + ROUND(shape * 31.0f));
+            break;
+        case LfoWaveformNumberOfWaveforms:
+            break;
+    }
+}
+
+/**
+ * @brief Calculates the gradients and offsets of two linear segments that meet
+ * at a breakpoint equal to the shape.
+ * @param lfo LFO structure.
+ * @param startValue Value at normalised period 0.0.
+ * @param breakpointValue Value at the breakpoint.
+ * @param endValue Value at normalised period 1.0.
+ */
+static void SetPiecewiseLinear(Lfo * const lfo, const float startValue, const float breakpointValue, const float endValue) {
+    lfo->breakpoint = lfo->shape;
+    lfo->gradientA = lfo->shape > 0.0f ? (breakpointValue - startValue) / lfo->shape : 0.0f;
+    lfo->offsetA = startValue;
+    lfo->gradientB = lfo->shape < 1.0f ? (endValue - breakpointValue) / (1.0f - lfo->shape) : 0.0f;
+    lfo->offsetB = breakpointValue - lfo->shape * lfo->gradientB;
+}
+
+/**
+ * @brief Evaluates the two linear segments calculated by SetPiecewiseLinear.
+ * @param lfo LFO structure.
+ * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
+ * @return Value.
+ */
+static inline __attribute__((always_inline)) float PiecewiseLinear(const Lfo * const lfo, const float normalisedPeriod) {
+    if (normalisedPeriod < lfo->breakpoint) {
+        return normalisedPeriod * lfo->gradientA + lfo->offsetA;
+    } else {
+        return normalisedPeriod * lfo->gradientB + lfo->offsetB;
+    }
+}
+
+/**
+ * @brief Draws a new random value at the start of each step of the random
+ * waveforms.  The start of a step is detected as a change of step or a
+ * normalised period less than that of the previous evaluation.
+ * @param lfo LFO structure.
+ * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
+ * @return Fraction of the current step, 0.0 to 1.0.
+ */
+static inline __attribute__((always_inline)) float UpdateRandom(Lfo * const lfo, const float normalisedPeriod) {
+    const float position = normalisedPeriod * lfo->steps;
+    const int step = FastMathFloorToInt(position);
+    if ((step != lfo->step) || (normalisedPeriod < lfo->normalisedPeriod)) {
+        lfo->step = step;
+        lfo->randomValues[0] = lfo->randomValues[1];
+        lfo->randomValues[1] = RandomNextFloat(&lfo->random);
+    }
+    lfo->normalisedPeriod = normalisedPeriod;
+    return position - (float) step;
+}
+
+/**
+ * @brief Returns the LFO amplitude for a normalised period.  The effect of
+ * shape on each waveform is:
+ * - Sine: adjusts symmetry.  A value of 0.5 results in a symmetric sine wave.
+ * - Triangle: skews the triangle wave between a negative sawtooth and positive
+ *   sawtooth.  A value of 0.5 results in a triangle wave.
+ * - Sawtooth: adjusts the gradient from linear to exponential.
+ * - Square: adjusts duty cycle from 0% to 100%.  A value of 0.5 results in a
+ *   square wave.
+ * - Stepped triangle and stepped sawtooth: adjusts the number of steps between
+ *   3 and 32.
+ * - Sample and hold and smooth random: adjusts the number of random values per
+ *   period between 1 and 32.  Smooth random interpolates between values with a
+ *   smoothstep so that the waveform and its gradient are continuous.
+ * Random waveforms must be evaluated with a normalised period that increases
+ * between calls except when the period wraps.
+ * @param lfo LFO structure.
+ * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
+ * @return LFO amplitude.
+ */
+float LfoGetAmplitude(Lfo * const lfo, const float normalisedPeriod) {
+    switch (lfo->waveform) {
+        case LfoWaveformSine:
+        {
+            const float skewedNormalisedPeriod = PiecewiseLinear(lfo, normalisedPeriod); // -0.25 to 0.75
+            return WaveformsSine(skewedNormalisedPeriod < 0.0f ? skewedNormalisedPeriod + 1.0f : skewedNormalisedPeriod);
+        }
+        case LfoWaveformTriangle:
+            return PiecewiseLinear(lfo, normalisedPeriod);
+        case LfoWaveformSawtooth:
+            return MIN(normalisedPeriod * lfo->gradientA, 2.0f) - 1.0f;
+        case LfoWaveformSquare:
+            return normalisedPeriod < lfo->breakpoint ? -1.0f : 1.0f;
+        case LfoWaveformSteppedTriangle:
+        {
+            const float step = (float) FastMathFloorToInt((2.0f * normalisedPeriod - 1.0f) * lfo->steps); // negative in first half of period
+            return 1.0f - fabsf(step) * lfo->stepAmplitude;
+        }
+        case LfoWaveformSteppedSawtooth:
+            return (float) FastMathFloorToInt(normalisedPeriod * lfo->steps) * lfo->stepAmplitude - 1.0f;
+        case LfoWaveformSampleAndHold:
+            UpdateRandom(lfo, normalisedPeriod);
+            return lfo->randomValues[1];
+        case LfoWaveformSmoothRandom:
+        {
+            const float fraction = UpdateRandom(lfo, normalisedPeriod);
+            return lfo->randomValues[0] + (lfo->randomValues[1] - lfo->randomValues[0]) * fraction * fraction * (3.0f - 2.0f * fraction);
+        }
+        case LfoWaveformNumberOfWaveforms:
+            break;
+    }
+    return 0.0f;
+}
+
+//------------------------------------------------------------------------------
+// End of file
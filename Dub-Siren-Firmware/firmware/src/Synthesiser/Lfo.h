@@ -0,0 +1,49 @@
+/**
+ * @file Lfo.h
+ * @author Seb Madgwick
+ * @brief LFO waveform with coefficients cached for the current shape.
+ */
+
+#ifndef LFO_H
+#define LFO_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Random/Random.h"
+#include "Synthesiser.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief LFO structure.  Structure members are used internally and should not
+ * be used by the user application.
+ */
+typedef struct {
+    LfoWaveform waveform;
+    float shape;
+    float breakpoint; // normalised period at which the piecewise-linear waveforms change segment
+    float gradientA; // gradient of segment before breakpoint
+    float offsetA; // offset of segment before breakpoint
+    float gradientB; // gradient of segment after breakpoint
+    float offsetB; // offset of segment after breakpoint
+    float steps; // number of steps per period for stepped waveforms
+    float stepAmplitude; // amplitude of each step for stepped waveforms
+    Random random;
+    int step; // step of the previous evaluation for random waveforms
+    float normalisedPeriod; // normalised period of the previous evaluation for random waveforms
+    float randomValues[2]; // held value, or values at the start and end of the step for smooth random
+} Lfo;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void LfoInitialise(Lfo * const lfo, const uint32_t seed);
+void LfoSetShape(Lfo * const lfo, const LfoWaveform waveform, const float shape);
+float LfoGetAmplitude(Lfo * const lfo, const float normalisedPeriod);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,181 @@
+/**
+ * @file ModulationMatrix.c
+ * @author Seb Madgwick
+ * @brief Modulation matrix routing LFOs, envelopes and random sources to
+ * synthesiser parameters.
+ *
+ * Sources are evaluated once per update (control rate).  The modulation of
+ * each destination is the sum of the source multiplied by the depth of each
+ * route to that destination.  Inactive routes are removed when the parameters
+ * are set so that the processing required scales with the number of active
+ * routes rather than the size of the matrix.  Pitch and cutoff modulation are
+ * in octaves and converted to a frequency ratio once per update.  Each
+ * destination is then ramped linearly across the update to avoid zipper noise.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "FastMath/FastMath.h"
+#include "ModulationMatrix.h"
+#include <string.h> // memset
+#include "Waveforms.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Seed of the random source.
+ */
+#define RANDOM_SEED (0x9E3779B9)
+
+/**
+ * @brief Seed of the random waveforms of the first LFO.  The seed of each
+ * subsequent LFO is incremented by RANDOM_SEED so that the sequences are
+ * uncorrelated.
+ */
+#define LFO_RANDOM_SEED (0xBB67AE85)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static inline __attribute__((always_inline)) bool IsRatio(const ModulationDestination destination);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises modulation matrix structure with no active routes.
+ * @param modulationMatrix Modulation matrix structure.
+ * @param updateFrequency Rate at which ModulationMatrixUpdate is called in Hz.
+ */
+void ModulationMatrixInitialise(ModulationMatrix * const modulationMatrix, const float updateFrequency) {
+    memset(modulationMatrix, 0, sizeof (ModulationMatrix));
+    modulationMatrix->updateFrequency = updateFrequency;
+    unsigned int index;
+    for (index = 0; index < MODULATION_MATRIX_NUMBER_OF_LFOS; index++) {
+        LfoInitialise(&modulationMatrix->lfos[index], LFO_RANDOM_SEED + (index * RANDOM_SEED));
+    }
+    EnvelopeInitialise(&modulationMatrix->envelope);
+    RandomInitialise(&modulationMatrix->random, RANDOM_SEED);
+}
+
+/**
+ * @brief Sets the modulation matrix parameters.  Routes with a depth of zero
+ * or an invalid source or destination are ignored.  A destination that
+ * becomes active is ramped from no modulation.
+ * @param modulationMatrix Modulation matrix structure.
+ * @param parameters Modulation matrix parameters.
+ */
+void ModulationMatrixSetParameters(ModulationMatrix * const modulationMatrix, const ModulationMatrixParameters * const parameters) {
+
+    // Copy active routes
+    bool destinationActive[ModulationDestinationNumberOfDestinations] = {false};
+    modulationMatrix->numberOfRoutes = 0;
+    unsigned int index;
+    for (index = 0; index < MODULATION_MATRIX_NUMBER_OF_ROUTES; index++) {
+        const ModulationRoute * const route = &parameters->routes[index];
+        if ((route->depth == 0.0f) || (route->source >= ModulationSourceNumberOfSources) || (route->destination >= ModulationDestinationNumberOfDestinations)) {
+            continue;
+        }
+        modulationMatrix->routes[modulationMatrix->numberOfRoutes++] = *route;
+        destinationActive[route->destination] = true;
+    }
+
+    // Reset ramps of newly active destinations
+    ModulationDestination destination;
+    for (destination = 0; destination < ModulationDestinationNumberOfDestinations; destination++) {
+        if ((destinationActive[destination] == true) && (modulationMatrix->destinationActive[destination] == false)) {
+            const float noModulation = IsRatio(destination) ? 1.0f : 0.0f;
+            modulationMatrix->ramps[destination].value = noModulation;
+            modulationMatrix->ramps[destination].increment = 0.0f;
+            modulationMatrix->ramps[destination].target = noModulation;
+        }
+        modulationMatrix->destinationActive[destination] = destinationActive[destination];
+    }
+
+    // LFOs and envelope
+    for (index = 0; index < MODULATION_MATRIX_NUMBER_OF_LFOS; index++) {
+        LfoSetShape(&modulationMatrix->lfos[index], parameters->lfos[index].waveform, parameters->lfos[index].shape);
+        modulationMatrix->lfoFrequencies[index] = parameters->lfos[index].frequency;
+    }
+    EnvelopeSetParameters(&modulationMatrix->envelope, &parameters->envelope, modulationMatrix->updateFrequency);
+}
+
+/**
+ * @brief Triggers the modulation envelope and selects a new value of the
+ * random source.  The LFOs are free-running.
+ * @param modulationMatrix Modulation matrix structure.
+ */
+void ModulationMatrixTrigger(ModulationMatrix * const modulationMatrix) {
+    EnvelopeTrigger(&modulationMatrix->envelope);
+    modulationMatrix->randomValue = RandomNextFloat(&modulationMatrix->random);
+}
+
+/**
+ * @brief Releases the modulation envelope.
+ * @param modulationMatrix Modulation matrix structure.
+ */
+void ModulationMatrixRelease(ModulationMatrix * const modulationMatrix) {
+    EnvelopeRelease(&modulationMatrix->envelope);
+}
+
+/**
+ * @brief Evaluates the sources and calculates the ramp of each active
+ * destination for the next update.  This function should be called once per
+ * update, before the first call of ModulationMatrixGetNext.
+ * @param modulationMatrix Modulation matrix structure.
+ * @param lfo Synthesiser LFO amplitude.
+ * @param envelope Amplitude envelope value.
+ * @param numberOfSamples Number of samples in the update.
+ */
+void ModulationMatrixUpdate(ModulationMatrix * const modulationMatrix, const float lfo, const float envelope, const unsigned int numberOfSamples) {
+
+    // Evaluate sources
+    float sources[ModulationSourceNumberOfSources];
+    sources[ModulationSourceLfo1] = lfo;
+    unsigned int index;
+    for (index = 0; index < MODULATION_MATRIX_NUMBER_OF_LFOS; index++) {
+        float * const lfoPeriodClock = &modulationMatrix->lfoPeriodClocks[index];
+        sources[ModulationSourceLfo2 + index] = LfoGetAmplitude(&modulationMatrix->lfos[index], *lfoPeriodClock);
+        *lfoPeriodClock = WaveformsLimitNormalisedPeriod(*lfoPeriodClock + modulationMatrix->lfoFrequencies[index] / modulationMatrix->updateFrequency);
+    }
+    sources[ModulationSourceEnvelope] = envelope;
+    EnvelopeUpdate(&modulationMatrix->envelope);
+    sources[ModulationSourceModulationEnvelope] = EnvelopeGetNext(&modulationMatrix->envelope);
+    sources[ModulationSourceRandom] = modulationMatrix->randomValue;
+
+    // Sum active routes
+    float sums[ModulationDestinationNumberOfDestinations] = {0.0f};
+    for (index = 0; index < modulationMatrix->numberOfRoutes; index++) {
+        const ModulationRoute * const route = &modulationMatrix->routes[index];
+        sums[route->destination] += route->depth * sources[route->source];
+    }
+
+    // Calculate ramps
+    const float reciprocalNumberOfSamples = 1.0f / (float) numberOfSamples;
+    ModulationDestination destination;
+    for (destination = 0; destination < ModulationDestinationNumberOfDestinations; destination++) {
+        if (modulationMatrix->destinationActive[destination] == false) {
+            continue;
+        }
+        ModulationRamp * const ramp = &modulationMatrix->ramps[destination];
+        const float target = IsRatio(destination) ? FastMathExp2(sums[destination]) : sums[destination];
+        ramp->value = ramp->target;
+        ramp->increment = (target - ramp->value) * reciprocalNumberOfSamples;
+        ramp->target = target;
+    }
+}
+
+/**
+ * @brief Returns true if the modulation of the destination is in octaves and
+ * applied as a frequency ratio.
+ * @param destination Destination.
+ * @return True if the modulation is a frequency ratio.
+ */
+static inline __attribute__((always_inline)) bool IsRatio(const ModulationDestination destination) {
+    return (destination == ModulationDestinationVcoPitch) || (destination == ModulationDestinationFilterCutoff);
+}
+
+//------------------------------------------------------------------------------
+// End of file
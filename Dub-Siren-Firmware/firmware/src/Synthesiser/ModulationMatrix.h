@@ -0,0 +1,101 @@
+/**
+ * @file ModulationMatrix.h
+ * @author Seb Madgwick
+ * @brief Modulation matrix routing LFOs, envelopes and random sources to
+ * synthesiser parameters.
+ */
+
+#ifndef MODULATION_MATRIX_H
+#define MODULATION_MATRIX_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Envelope.h"
+#include "Lfo.h"
+#include "Random/Random.h"
+#include <stdbool.h>
+#include "Synthesiser.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Modulation destination ramp structure.  The value is ramped linearly
+ * from the previous target to the current target across each update.
+ */
+typedef struct {
+    float value;
+    float increment;
+    float target;
+} ModulationRamp;
+
+/**
+ * @brief Modulation matrix structure.  Structure members are used internally
+ * and should not be used by the user application.
+ */
+typedef struct {
+    ModulationRoute routes[MODULATION_MATRIX_NUMBER_OF_ROUTES]; // active routes only
+    unsigned int numberOfRoutes;
+    bool destinationActive[ModulationDestinationNumberOfDestinations];
+    ModulationRamp ramps[ModulationDestinationNumberOfDestinations];
+    float updateFrequency;
+    Lfo lfos[MODULATION_MATRIX_NUMBER_OF_LFOS];
+    float lfoFrequencies[MODULATION_MATRIX_NUMBER_OF_LFOS];
+    float lfoPeriodClocks[MODULATION_MATRIX_NUMBER_OF_LFOS];
+    Envelope envelope;
+    Random random;
+    float randomValue;
+} ModulationMatrix;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void ModulationMatrixInitialise(ModulationMatrix * const modulationMatrix, const float updateFrequency);
+void ModulationMatrixSetParameters(ModulationMatrix * const modulationMatrix, const ModulationMatrixParameters * const parameters);
+void ModulationMatrixTrigger(ModulationMatrix * const modulationMatrix);
+void ModulationMatrixRelease(ModulationMatrix * const modulationMatrix);
+void ModulationMatrixUpdate(ModulationMatrix * const modulationMatrix, const float lfo, const float envelope, const unsigned int numberOfSamples);
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Returns true if any route modulates the destination.
+ * @param modulationMatrix Modulation matrix structure.
+ * @param destination Destination.
+ * @return True if any route modulates the destination.
+ */
+static inline __attribute__((always_inline)) bool ModulationMatrixIsActive(const ModulationMatrix * const modulationMatrix, const ModulationDestination destination) {
+    return modulationMatrix->destinationActive[destination];
+}
+
+/**
+ * @brief Returns the ramped modulation of a destination for the next sample.
+ * This function should be called once per sample for each active destination.
+ * @param modulationMatrix Modulation matrix structure.
+ * @param destination Destination.
+ * @return Modulation.  A frequency ratio for the VCO pitch and filter cutoff
+ * destinations, else an offset in the units of the route depth.
+ */
+static inline __attribute__((always_inline)) float ModulationMatrixGetNext(ModulationMatrix * const modulationMatrix, const ModulationDestination destination) {
+    ModulationRamp * const ramp = &modulationMatrix->ramps[destination];
+    ramp->value += ramp->increment;
+    return ramp->value;
+}
+
+/**
+ * @brief Returns the modulation of a destination at the end of the current
+ * update.  For destinations applied once per update.
+ * @param modulationMatrix Modulation matrix structure.
+ * @param destination Destination.
+ * @return Modulation.  See ModulationMatrixGetNext.
+ */
+static inline __attribute__((always_inline)) float ModulationMatrixGetTarget(const ModulationMatrix * const modulationMatrix, const ModulationDestination destination) {
+    return modulationMatrix->ramps[destination].target;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
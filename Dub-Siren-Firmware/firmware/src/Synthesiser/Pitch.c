@@ -0,0 +1,229 @@
+/**
+ * @file Pitch.c
+ * @author Seb Madgwick
+ * @brief Pitch processing of the VCO frequency: scale quantiser and glide.
+ *
+ * The quantiser rounds the VCO frequency to the nearest note of a note table.
+ * The table is built from the tuning and scale before the parameters are set
+ * and so quantising is a binary search of the table thresholds.  Each threshold
+ * is the geometric mean of a note and the next note so that frequencies are
+ * rounded in pitch rather than in Hz.  Building the table requires an exp2 and
+ * a square root per note and so should not be done within the audio update.
+ *
+ * Glide is a one-pole low-pass filter of the pitch in octaves so that the glide
+ * time is independent of the interval and the pitch approaches the target at a
+ * constant musical rate.  The filter state is the offset from the target in
+ * octaves, which decays exponentially to zero without the loss of precision of
+ * filtering the absolute pitch.  The glide is updated at control rate and the
+ * offset converted to a frequency once per update.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <float.h> // FLT_MAX
+#include "FastMath/FastMath.h"
+#include <math.h> // expf, fabsf, sqrtf
+#include "MathHelpers.h"
+#include "Pitch.h"
+#include <string.h> // memset
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Frequency range of the note table in Hz.
+ */
+#define MINIMUM_NOTE_FREQUENCY (2.0f)
+#define MAXIMUM_NOTE_FREQUENCY (10000.0f)
+
+/**
+ * @brief Glide ends when the pitch is within this threshold of the target in
+ * octaves.  Equivalent to 0.01 cents.
+ */
+#define GLIDE_THRESHOLD (0.01f / 1200.0f)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static uint32_t GetScaleMask(const PitchScale scale, const unsigned int numberOfDegrees);
+static float Quantise(const PitchNoteTable * const noteTable, const float frequency);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises pitch structure with the quantiser off and no glide.
+ * @param pitch Pitch structure.
+ * @param updateFrequency Rate at which PitchUpdate is called in Hz.
+ */
+void PitchInitialise(Pitch * const pitch, const float updateFrequency) {
+    memset(pitch, 0, sizeof (Pitch));
+    pitch->updateFrequency = updateFrequency;
+}
+
+/**
+ * @brief Returns true if the tuning is valid.  The reference must be positive
+ * and the degrees must be positive and ascending.
+ * @param tuning Tuning.
+ * @return True if the tuning is valid.
+ */
+bool PitchIsTuningValid(const PitchTuning * const tuning) {
+    if ((tuning->reference <= 0.0f) || (tuning->numberOfDegrees == 0) || (tuning->numberOfDegrees > PITCH_MAXIMUM_NUMBER_OF_DEGREES)) {
+        return false;
+    }
+    float previousDegree = 0.0f;
+    unsigned int index;
+    for (index = 0; index < tuning->numberOfDegrees; index++) {
+        if (tuning->degrees[index] <= previousDegree) {
+            return false;
+        }
+        previousDegree = tuning->degrees[index];
+    }
+    return true;
+}
+
+/**
+ * @brief Sets pitch parameters.  The current glide continues towards the
+ * previous target until the next call to PitchSetTarget.
+ * @param pitch Pitch structure.
+ * @param parameters Pitch parameters.
+ * @param noteTable Note table built by PitchBuildNoteTable for the parameters.
+ * The note table must not be modified while used by the pitch structure.
+ */
+void PitchSetParameters(Pitch * const pitch, const PitchParameters * const parameters, const PitchNoteTable * const noteTable) {
+    pitch->glideCoefficient = parameters->glideTime > 0.0f ? expf(-1.0f / (parameters->glideTime * pitch->updateFrequency)) : 0.0f;
+    pitch->noteTable = noteTable->numberOfNotes > 0 ? noteTable : NULL;
+}
+
+/**
+ * @brief Returns the degrees of a 12 degree tuning selected by a scale as a
+ * bit mask.  Bit 0 corresponds to the reference.
+ * @param scale Scale.
+ * @param numberOfDegrees Number of degrees of the tuning.
+ * @return Bit mask.
+ */
+static uint32_t GetScaleMask(const PitchScale scale, const unsigned int numberOfDegrees) {
+    if (numberOfDegrees == 12) {
+        switch (scale) {
+            case PitchScaleMajor:
+                return 0xAB5; // 0, 2, 4, 5, 7, 9, 11
+            case PitchScaleMinor:
+                return 0x5AD; // 0, 2, 3, 5, 7, 8, 10
+            case PitchScaleMajorPentatonic:
+                return 0x295; // 0, 2, 4, 7, 9
+            case PitchScaleMinorPentatonic:
+                return 0x4A9; // 0, 3, 5, 7, 10
+            default:
+                break;
+        }
+    }
+    return (1 << numberOfDegrees) - 1;
+}
+
+/**
+ * @brief Builds the note table of the tuning and scale of pitch parameters.
+ * Notes are generated from the first period below MINIMUM_NOTE_FREQUENCY until
+ * the table is full or a note exceeds MAXIMUM_NOTE_FREQUENCY.  The quantiser is
+ * off if the scale is off or no notes are within this range.
+ * @param noteTable Note table.
+ * @param parameters Pitch parameters.  The tuning must be valid.
+ */
+void PitchBuildNoteTable(PitchNoteTable * const noteTable, const PitchParameters * const parameters) {
+    if (parameters->scale == PitchScaleOff) {
+        noteTable->numberOfNotes = 0;
+        return;
+    }
+    const PitchScale scale = parameters->scale;
+    const PitchTuning * const tuning = &parameters->tuning;
+    const uint32_t mask = GetScaleMask(scale, tuning->numberOfDegrees);
+    const float periodOctaves = tuning->degrees[tuning->numberOfDegrees - 1] * (1.0f / 1200.0f);
+    int period = FastMathFloorToInt(FastMathLog2(MINIMUM_NOTE_FREQUENCY / tuning->reference) / periodOctaves);
+    unsigned int numberOfNotes = 0;
+    bool complete = false;
+    while (complete == false) {
+        unsigned int degree;
+        for (degree = 0; degree < tuning->numberOfDegrees; degree++) {
+            if ((mask & (1 << degree)) == 0) {
+                continue;
+            }
+            const float octaves = (float) period * periodOctaves + (degree == 0 ? 0.0f : tuning->degrees[degree - 1] * (1.0f / 1200.0f));
+            const float frequency = tuning->reference * FastMathExp2(octaves);
+            if (frequency < MINIMUM_NOTE_FREQUENCY) {
+                continue;
+            }
+            if ((frequency > MAXIMUM_NOTE_FREQUENCY) || (numberOfNotes >= PITCH_MAXIMUM_NUMBER_OF_NOTES)) {
+                complete = true;
+                break;
+            }
+            noteTable->noteFrequencies[numberOfNotes++] = frequency;
+        }
+        period++;
+    }
+    noteTable->numberOfNotes = numberOfNotes;
+    if (numberOfNotes == 0) {
+        return; // period exceeds note table frequency range
+    }
+    unsigned int index;
+    for (index = 0; index < (numberOfNotes - 1); index++) {
+        noteTable->noteThresholds[index] = sqrtf(noteTable->noteFrequencies[index] * noteTable->noteFrequencies[index + 1]);
+    }
+    noteTable->noteThresholds[numberOfNotes - 1] = FLT_MAX;
+}
+
+/**
+ * @brief Sets the target frequency.  The frequency is quantised if the
+ * quantiser is on.  The frequency is set immediately if there is no glide.
+ * @param pitch Pitch structure.
+ * @param frequency Frequency in Hz.
+ */
+void PitchSetTarget(Pitch * const pitch, const float frequency) {
+    pitch->targetFrequency = MAX(pitch->noteTable != NULL ? Quantise(pitch->noteTable, frequency) : frequency, MINIMUM_NOTE_FREQUENCY);
+    if ((pitch->glideCoefficient == 0.0f) || (pitch->frequency == 0.0f)) {
+        pitch->glideOctaves = 0.0f;
+        pitch->frequency = pitch->targetFrequency;
+    } else {
+        pitch->glideOctaves = FastMathLog2(pitch->frequency / pitch->targetFrequency);
+    }
+}
+
+/**
+ * @brief Returns the note nearest to a frequency.
+ * @param noteTable Note table.  Must contain at least one note.
+ * @param frequency Frequency in Hz.
+ * @return Note frequency in Hz.
+ */
+static float Quantise(const PitchNoteTable * const noteTable, const float frequency) {
+    unsigned int low = 0;
+    unsigned int high = noteTable->numberOfNotes - 1;
+    while (low < high) {
+        const unsigned int middle = (low + high) >> 1;
+        if (frequency < noteTable->noteThresholds[middle]) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return noteTable->noteFrequencies[low];
+}
+
+/**
+ * @brief Updates the glide.  This function should be called at the update
+ * frequency.
+ * @param pitch Pitch structure.
+ */
+void PitchUpdate(Pitch * const pitch) {
+    if (pitch->glideOctaves == 0.0f) {
+        return;
+    }
+    pitch->glideOctaves *= pitch->glideCoefficient;
+    if (fabsf(pitch->glideOctaves) < GLIDE_THRESHOLD) {
+        pitch->glideOctaves = 0.0f;
+        pitch->frequency = pitch->targetFrequency;
+        return;
+    }
+    pitch->frequency = pitch->targetFrequency * FastMathExp2(pitch->glideOctaves);
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,72 @@
+/**
+ * @file Pitch.h
+ * @author Seb Madgwick
+ * @brief Pitch processing of the VCO frequency: scale quantiser and glide.
+ */
+
+#ifndef PITCH_H
+#define PITCH_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+#include "Synthesiser.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum number of notes of the quantiser note table.
+ */
+#define PITCH_MAXIMUM_NUMBER_OF_NOTES (256)
+
+/**
+ * @brief Note table structure.  Structure members are used internally and
+ * should not be used by the user application.
+ */
+typedef struct {
+    float noteFrequencies[PITCH_MAXIMUM_NUMBER_OF_NOTES]; // ascending
+    float noteThresholds[PITCH_MAXIMUM_NUMBER_OF_NOTES]; // geometric mean of each note and the next
+    unsigned int numberOfNotes; // 0 if quantiser is off
+} PitchNoteTable;
+
+/**
+ * @brief Pitch structure.  Structure members are used internally and should not
+ * be used by the user application.
+ */
+typedef struct {
+    const PitchNoteTable* noteTable; // NULL if quantiser is off
+    float updateFrequency;
+    float glideCoefficient;
+    float targetFrequency;
+    float glideOctaves; // offset from the target
+    float frequency;
+} Pitch;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void PitchInitialise(Pitch * const pitch, const float updateFrequency);
+bool PitchIsTuningValid(const PitchTuning * const tuning);
+void PitchBuildNoteTable(PitchNoteTable * const noteTable, const PitchParameters * const parameters);
+void PitchSetParameters(Pitch * const pitch, const PitchParameters * const parameters, const PitchNoteTable * const noteTable);
+void PitchSetTarget(Pitch * const pitch, const float frequency);
+void PitchUpdate(Pitch * const pitch);
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Returns the processed VCO frequency.
+ * @param pitch Pitch structure.
+ * @return Frequency in Hz.
+ */
+static inline __attribute__((always_inline)) float PitchGetFrequency(const Pitch * const pitch) {
+    return pitch->frequency;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
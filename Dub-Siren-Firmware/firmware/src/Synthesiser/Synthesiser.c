@@ -7,34 +7,191 @@
 //------------------------------------------------------------------------------
 // Includes
 
+#include "Benchmark/Benchmark.h" // BENCHMARK_RAM_SIZE
+#include "Convolution/Convolution.h" // CONVOLUTION_RAM_SIZE
+#include "Echo.h"
+#include "EffectsChain/EffectsChain.h"
+#include "Envelope.h"
+#include "EventQueue.h"
+#include "FastMath/FastMath.h"
 #include "Filters/CascadeFilter.h"
+#include "Filters/CascadeFilterQ31.h"
 #include "Filters/FirstOrderFilter.h"
+#include "FixedPoint/Q31.h"
+#include "Lfo.h"
 #include "MathHelpers.h"
+#include "ModulationEffects/ModulationEffects.h" // MODULATION_EFFECTS_RAM_SIZE
+#include "ModulationMatrix.h"
+#include "Pitch.h"
+#include "Reverb/Reverb.h" // REVERB_RAM_SIZE
+#include "Saturation/Saturation.h"
+#include "Scheduler/Scheduler.h" // SCHEDULER_RAM_SIZE
+#include <string.h> // memcmp, memset
 #include "Synthesiser.h"
+#include "Trace/Trace.h" // TRACE_RAM_SIZE
+#include "Vco.h"
 #include "Waveforms.h"
+#include "Wavetable.h" // WAVETABLE_RAM_SIZE
 
 //------------------------------------------------------------------------------
 // Definitions
 
 /**
- * @brief The period (in seconds) between the gate opening and the LFO period
- * elapsing when LFO gate control is enabled.
+ * @brief The period (in seconds) between the envelope release ending and the
+ * LFO period elapsing when LFO gate control is enabled.
  */
 #define PREEMPTIVE_GATE_PERIOD (0.01f)
 
 /**
- * @brief Delay buffer size.
+ * @brief Seed of the LFO random waveforms.
  */
-#define DELAY_BUFFER_SIZE (128000)
+#define LFO_RANDOM_SEED (0x3C6EF372)
+
+/**
+ * @brief RAM used by the pitch note tables and the event queue in bytes.
+ */
+#define PITCH_NOTE_TABLES_RAM_SIZE (2 * sizeof (PitchNoteTable))
+#define EVENT_QUEUE_RAM_SIZE (sizeof (EventQueue) + (NUMBER_OF_EVENT_PARAMETERS * sizeof (SynthesiserParameters)))
+
+/**
+ * @brief RAM used by the smaller variables of modules added since the delay
+ * buffer size was chosen, such as the serial interface, modulation matrix and
+ * effects chain nodes.  Keeps the original room for the stack.
+ */
+#define MODULE_VARIABLES_RAM_SIZE (4096)
+
+/**
+ * @brief Delay buffer size.  The delay buffer occupies most of the RAM so it is
+ * reduced to make room for the effects chain arena, pitch note tables, event
+ * queue, scheduler task table and module variables, and the modulation effects
+ * buffer, reverb arena, convolution spectra, wavetable bank, benchmark buffers
+ * and trace buffer, if enabled.  Each sample is 4 bytes.
+ */
+#define DELAY_BUFFER_SIZE (128000 - (EFFECTS_CHAIN_ARENA_SIZE / 4) - (PITCH_NOTE_TABLES_RAM_SIZE / 4) - (EVENT_QUEUE_RAM_SIZE / 4) - (SCHEDULER_RAM_SIZE / 4) - (MODULE_VARIABLES_RAM_SIZE / 4) - (MODULATION_EFFECTS_RAM_SIZE / 4) - (REVERB_RAM_SIZE / 4) - (CONVOLUTION_RAM_SIZE / 4) - (WAVETABLE_RAM_SIZE / 4) - (BENCHMARK_RAM_SIZE / 4) - (TRACE_RAM_SIZE / 4))
+
+/**
+ * @brief Delay buffer sample amplitude below which the delay is considered
+ * silent.  The delay is idle once every sample in the delay buffer is silent.
+ */
+#define DELAY_SILENCE_THRESHOLD (1e-6f)
+
+/**
+ * @brief Delay silence threshold in Q31.
+ */
+#define DELAY_SILENCE_THRESHOLD_Q31 ((q31) (DELAY_SILENCE_THRESHOLD * 2147483648.0f))
+
+/**
+ * @brief Number of delay buffer samples cleared per audio update while the
+ * delay is idle.
+ */
+#define DELAY_CLEAR_SAMPLES_PER_UPDATE (64)
+
+/**
+ * @brief Delay (in samples) between an event being posted without a timestamp
+ * and the event being applied.  A constant latency replaces the jitter of the
+ * main program loop.  Equivalent to 1 ms.  Must be at least DAC_BLOCK_SIZE
+ * because the sample count runs up to one block ahead of the DAC output.
+ */
+#define EVENT_LATENCY (96)
+
+/**
+ * @brief Number of event queue spaces reserved for trigger, gate and preset
+ * events.  Parameter events are not posted if the space is less than this.
+ */
+#define RESERVED_EVENT_QUEUE_SPACE (8)
+
+/**
+ * @brief Number of parameters held for parameters and preset events that have
+ * been posted but not yet applied.  Must be a 2^n number.
+ */
+#define NUMBER_OF_EVENT_PARAMETERS (4)
+
+/**
+ * @brief Number of event parameters reserved for preset events.  Parameters
+ * events are not posted if fewer than this number are free.
+ */
+#define RESERVED_EVENT_PARAMETERS (1)
+
+/**
+ * @brief Output limiter threshold.  Equivalent to -0.9 dBFS.
+ */
+#define OUTPUT_LIMITER_THRESHOLD (0.9f)
+
+/**
+ * @brief Output limiter release time constant in seconds.
+ */
+#define OUTPUT_LIMITER_RELEASE_TIME (0.1f)
+
+/**
+ * @brief Delay feedback soft clip knee threshold.  Feedback below this level is
+ * not coloured by the soft clip.
+ */
+#define DELAY_SOFT_CLIP_THRESHOLD (0.5f)
+
+/**
+ * @brief Minimum and maximum length of delay mode crossfade windows in
+ * samples.  Equivalent to 1 ms and 10 ms.
+ */
+#define MINIMUM_CROSSFADE_LENGTH (96)
+#define MAXIMUM_CROSSFADE_LENGTH (960)
+
+/**
+ * @brief Feedback leakage range of the hold delay mode.  The feedback is
+ * 1.0 - (1.0 - delayFeedback) * HOLD_LEAKAGE so that 100% delay feedback holds
+ * indefinitely.
+ */
+#define HOLD_LEAKAGE (0.02f)
+
+/**
+ * @brief Sample type of the delay and output.
+ */
+#ifdef FIXED_POINT_ENABLED
+typedef q31 Sample;
+#define SAMPLE_UNITY (Q31_MAX)
+#else
+typedef float Sample;
+#define SAMPLE_UNITY (1.0f)
+#endif
+
+/**
+ * @brief Delay mode crossfade state.
+ */
+typedef enum {
+    DelayModeFadeNone,
+    DelayModeFadeOut,
+    DelayModeFadeIn,
+} DelayModeFade;
 
 //------------------------------------------------------------------------------
 // Function prototypes
 
+static unsigned int GetFreeEventParameters();
+static void PostParametersEvent(const SynthesiserEventType type, const SynthesiserParameters * const newSynthesiserParameters);
+static void ProcessEvents();
+static void ApplyParameters(const SynthesiserParameters * const newSynthesiserParameters);
+static void TriggerEnvelopes();
+static void ReleaseEnvelopes();
+static void UpdateModulationMatrix();
+static void SetDelayFilterCornerFrequency();
 static void AudioUpdate();
-static void WriteToDelayBuffer(const float sample);
-static float ReadFromDelayBuffer(float delay);
-static void MixToDelayBuffer(const float sample);
+static inline __attribute__((always_inline)) Sample RenderSample();
+static Sample UpdateDelayMode(const float delayTime);
+static void StartDelayMode(const float delayTime);
+static Sample ReadDelay(const DelayMode delayMode, const float delayTime);
+static Sample ReadFrozenLoop();
+static Sample ReadReverse(const float delayTime);
+static inline __attribute__((always_inline)) Sample Crossfade(const Sample sampleOut, const Sample sampleIn, const unsigned int index);
+static inline __attribute__((always_inline)) Sample CrossfadeWindow(const unsigned int index);
+static inline __attribute__((always_inline)) Sample MultiplySample(const Sample sampleA, const Sample sampleB);
+static inline __attribute__((always_inline)) unsigned int WrapDelayBufferIndex(const int index);
+static void WriteToDelayBuffer(const Sample sample);
+static Sample ReadFromDelayBuffer(const float delayTime);
+#ifndef FIXED_POINT_ENABLED
+static float ReadFromDelayBufferInterpolated(const float delay);
+#endif
+static void MixToDelayBuffer(const Sample sample);
 static void IncrementDelayBufferIndex();
+static void ClearDelayBuffer();
 
 //------------------------------------------------------------------------------
 // Variables
@@ -51,17 +208,122 @@ const SynthesiserParameters defaultSynthesiserParameters = {
     .delayFeedback = 0.0f,
     .delayFilterType = DelayFilterTypeNone,
     .delayFilterFrequency = 1.0f,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005f,
+        .decay = 0.1f,
+        .sustain = 1.0f,
+        .release = 0.01f,
+    },
+};
+const ModulationMatrixParameters defaultModulationMatrixParameters = {
+    .lfos = {
+        {
+            .waveform = LfoWaveformSine,
+            .shape = 0.5f,
+            .frequency = 0.5f,
+        },
+        {
+            .waveform = LfoWaveformTriangle,
+            .shape = 0.5f,
+            .frequency = 5.0f,
+        },
+    },
+    .envelope = {
+        .mode = EnvelopeModeAd,
+        .retrigger = EnvelopeRetriggerReset,
+        .attack = 0.01f,
+        .decay = 1.0f,
+        .sustain = 0.0f,
+        .release = 0.1f,
+    },
+};
+const Vco2Parameters defaultVco2Parameters = {
+    .modulation = VcoModulationMix,
+    .waveform = VcoWaveformSine,
+    .ratio = 1.0f,
+    .amount = 0.0f,
 };
+const UnisonParameters defaultUnisonParameters = {
+    .numberOfVoices = 1,
+    .spread = 20.0f,
+    .mix = 0.5f,
+};
+const PitchParameters defaultPitchParameters = {
+    .glideTime = 0.0f,
+    .scale = PitchScaleOff,
+    .tuning = {
+        .reference = 261.6256f, // C4
+        .numberOfDegrees = 12,
+        .degrees = {100.0f, 200.0f, 300.0f, 400.0f, 500.0f, 600.0f, 700.0f, 800.0f, 900.0f, 1000.0f, 1100.0f, 1200.0f},
+    },
+};
+static EventQueue eventQueue;
+static SynthesiserParameters eventParameters[NUMBER_OF_EVENT_PARAMETERS];
+static unsigned int eventParametersPosted; // only written to by main program loop
+static volatile unsigned int eventParametersApplied; // only written to by audio update
+static uint32_t latestPostedSampleCount;
+static SynthesiserParameters latestPostedParameters;
+static volatile uint32_t sampleCount;
 static SynthesiserParameters synthesiserParameters;
-static SynthesiserParameters pendingSynthesiserParameters;
-static bool newSynthesiserParametersPending;
-static bool trigger;
-static bool gate;
-static FirstOrderFilter gateGainLowPassFilter;
-static float delayBuffer[DELAY_BUFFER_SIZE];
+static volatile bool gate;
+static Lfo lfo;
+static float lfoPeriodClock = 0.0f;
+static Envelope envelope;
+static float lfoGateControlPeriod; // normalised period before the end of the LFO period at which the gate closes
+static ModulationMatrix modulationMatrix;
+static ModulationMatrixParameters modulationMatrixParameters;
+static volatile bool modulationMatrixChanged;
+static Vco vco;
+static Vco2Parameters vco2Parameters;
+static volatile bool vco2ParametersChanged;
+static UnisonParameters requestedUnisonParameters;
+static UnisonParameters unisonParameters; // requested parameters with number of voices limited by quality
+static volatile bool unisonParametersChanged;
+static unsigned int maximumNumberOfUnisonVoices = UNISON_MAXIMUM_NUMBER_OF_VOICES;
+static Pitch pitch;
+static PitchParameters pitchParameters;
+static PitchNoteTable pitchNoteTables[2]; // built in the main context while the audio update uses the other
+static volatile unsigned int pitchNoteTableIndex; // table used by the audio update
+static volatile bool pitchParametersChanged;
+static volatile float wavetablePosition;
+static volatile unsigned int delayFilterOrder = MAXIMUM_NUMBER_OF_CASCADED_FILTERS;
+static volatile bool delayFilterOrderChanged;
+static Sample delayBuffer[DELAY_BUFFER_SIZE];
 static unsigned int delayBufferIndex = 0;
+static unsigned int delaySilentSampleCount = 0;
+static unsigned int delayClearIndex = 0;
+static bool delayIdle = false;
+static volatile DelayMode requestedDelayMode = DelayModeNormal;
+static DelayMode activeDelayMode = DelayModeNormal;
+static DelayModeFade delayModeFade;
+static unsigned int delayModeFadeIndex;
+static unsigned int crossfadeLength;
+static float crossfadeWindowStep; // cycles per sample of crossfade window
+static unsigned int freezeStart;
+static unsigned int freezeLength;
+static unsigned int freezePhase;
+static unsigned int reverseStart;
+static unsigned int reverseNextStart;
+static unsigned int reverseLength;
+static unsigned int reversePhase;
+static Sample holdFeedback;
 static FirstOrderFilter delayTimeLowPassFilter;
+#ifdef FIXED_POINT_ENABLED
+static q31 delayFeedback;
+static CascadeFilterQ31 delayFilter;
+#else
 static CascadeFilter delayFilter;
+static volatile bool oversamplingEnabled = true;
+static SaturationOversampler delaySaturationOversampler;
+static SaturationLimiter outputLimiter;
+static volatile DelayModel delayModel = DelayModelDigital;
+static volatile bool delayModelChanged;
+static DelayModel activeDelayModel = DelayModelDigital;
+static Echo echo;
+static float smoothedDelayTime;
+#endif
 
 //------------------------------------------------------------------------------
 // Functions
@@ -73,33 +335,111 @@ static CascadeFilter delayFilter;
 void SynthesiserInitialise() {
 
     // Initialise variables
-    pendingSynthesiserParameters = defaultSynthesiserParameters;
-    newSynthesiserParametersPending = true;
+    EventQueueInitialise(&eventQueue);
+    latestPostedParameters = defaultSynthesiserParameters;
     gate = true;
+    LfoInitialise(&lfo, LFO_RANDOM_SEED);
+    EnvelopeInitialise(&envelope);
+    ModulationMatrixInitialise(&modulationMatrix, SAMPLE_FREQUENCY / DAC_BLOCK_SIZE);
+    modulationMatrixParameters = defaultModulationMatrixParameters;
+    ModulationMatrixSetParameters(&modulationMatrix, &modulationMatrixParameters);
+    VcoInitialise(&vco);
+    vco2Parameters = defaultVco2Parameters;
+    VcoSetVco2Parameters(&vco, &vco2Parameters);
+    requestedUnisonParameters = defaultUnisonParameters;
+    unisonParameters = defaultUnisonParameters;
+    PitchInitialise(&pitch, SAMPLE_FREQUENCY / DAC_BLOCK_SIZE);
+    pitchParameters = defaultPitchParameters;
+    pitchNoteTableIndex = 0;
+    PitchBuildNoteTable(&pitchNoteTables[pitchNoteTableIndex], &pitchParameters);
+    PitchSetParameters(&pitch, &pitchParameters, &pitchNoteTables[pitchNoteTableIndex]);
+#ifdef WAVETABLE_ENABLED
+    WavetableInitialise();
+#endif
 
     // Initialise fixed filters
-    FirstOrderFilterSetCornerFrequency(&gateGainLowPassFilter, 100.0f, SAMPLE_FREQUENCY, false);
     FirstOrderFilterSetCornerFrequency(&delayTimeLowPassFilter, 1.0f, SAMPLE_FREQUENCY, false);
+#ifndef FIXED_POINT_ENABLED
+    SaturationOversamplerInitialise(&delaySaturationOversampler, DELAY_SOFT_CLIP_THRESHOLD);
+    SaturationLimiterInitialise(&outputLimiter, OUTPUT_LIMITER_THRESHOLD, OUTPUT_LIMITER_RELEASE_TIME, SAMPLE_FREQUENCY);
+    EchoInitialise(&echo, activeDelayModel);
+    EffectsChainInitialise();
+#endif
+
+    // Apply default parameters
+    ApplyParameters(&defaultSynthesiserParameters);
+    StartDelayMode(synthesiserParameters.delayTime);
+    TriggerEnvelopes();
 
     // Initialise DAC
     DacInitialise(&AudioUpdate);
 }
 
 /**
- * @brief Sets new synthesiser parameters.
+ * @brief Returns the number of samples since the audio started.  This value is
+ * used to timestamp events.
+ * @return Sample count.
+ */
+uint32_t SynthesiserGetSampleCount() {
+    return sampleCount;
+}
+
+/**
+ * @brief Posts a timestamped event to be applied by the audio update.  Events
+ * must be posted in timestamp order; an event timestamped earlier than the
+ * previous event is applied with the previous event.  This function must only
+ * be called from the main program loop.
+ * @param event Event.
+ * @return True if successful, false if the event queue is full.
+ */
+bool SynthesiserPostEvent(const SynthesiserEvent * const event) {
+    SynthesiserEvent orderedEvent = *event;
+    if ((int32_t) (orderedEvent.sampleCount - latestPostedSampleCount) < 0) {
+        orderedEvent.sampleCount = latestPostedSampleCount;
+    }
+    if (EventQueuePush(&eventQueue, &orderedEvent) == false) {
+        return false;
+    }
+    latestPostedSampleCount = orderedEvent.sampleCount;
+    return true;
+}
+
+/**
+ * @brief Sets new synthesiser parameters.  Unchanged parameters are ignored so
+ * that this function may be called repeatedly.
  * @param newSynthesiserParameters New synthesiser parameters.
  */
 void SynthesiserSetParameters(const SynthesiserParameters * const newSynthesiserParameters) {
-    newSynthesiserParametersPending = false;
-    pendingSynthesiserParameters = *newSynthesiserParameters;
-    newSynthesiserParametersPending = true;
+    if (memcmp(newSynthesiserParameters, &latestPostedParameters, sizeof (SynthesiserParameters)) == 0) {
+        return;
+    }
+    if ((EventQueueGetSpace(&eventQueue) < RESERVED_EVENT_QUEUE_SPACE) || (GetFreeEventParameters() <= RESERVED_EVENT_PARAMETERS)) {
+        return; // try again on next call
+    }
+    PostParametersEvent(SynthesiserEventTypeParameters, newSynthesiserParameters);
+}
+
+/**
+ * @brief Sets new synthesiser parameters and triggers synthesiser on the same
+ * sample.
+ * @param presetSynthesiserParameters Preset synthesiser parameters.
+ */
+void SynthesiserLoadPreset(const SynthesiserParameters * const presetSynthesiserParameters) {
+    if (GetFreeEventParameters() == 0) {
+        return;
+    }
+    PostParametersEvent(SynthesiserEventTypePreset, presetSynthesiserParameters);
 }
 
 /**
  * @brief Triggers synthesiser.
  */
 void SynthesiserTrigger() {
-    trigger = true;
+    const SynthesiserEvent event = {
+        .sampleCount = SynthesiserGetSampleCount() + EVENT_LATENCY,
+        .type = SynthesiserEventTypeTrigger,
+    };
+    SynthesiserPostEvent(&event);
 }
 
 /**
@@ -107,7 +447,12 @@ void SynthesiserTrigger() {
  * @param state Gate state.
  */
 void SynthesiserSetGate(const bool state) {
-    gate = state;
+    SynthesiserEvent event = {
+        .sampleCount = SynthesiserGetSampleCount() + EVENT_LATENCY,
+        .type = SynthesiserEventTypeGate,
+    };
+    event.gate = state;
+    SynthesiserPostEvent(&event);
 }
 
 /**
@@ -119,136 +464,730 @@ bool SynthesiserGetGate() {
 }
 
 /**
- * @brief Updates audio calculations and writes output to DAC buffer.
+ * @brief Sets synthesiser quality.  Medium quality limits the number of unison
+ * voices and reduces the delay filter order.  Low quality also removes unison,
+ * disables oversampling of the delay feedback saturation and disables waveform
+ * table interpolation.
+ * @param quality Synthesiser quality.
  */
-static void AudioUpdate() {
-
-    // Must write to DAC buffer immediately
-    static float output = 0.0f;
-    DacWriteBuffer(output);
-
-    // Update synthesiser parameters
-    if (newSynthesiserParametersPending == true) {
-        synthesiserParameters = pendingSynthesiserParameters;
-        CascadeFilterSetCornerFrequency(&delayFilter,
-                synthesiserParameters.delayFilterFrequency,
-                SAMPLE_FREQUENCY,
-                synthesiserParameters.delayFilterType == DelayFilterTypeHighPass,
-                3);
-        newSynthesiserParametersPending = false;
-    }
-
-    // LFO
-    static float lfoPeriodClock = 0.0f;
-    if (trigger == true) {
-        trigger = false;
-        lfoPeriodClock = 0.0f;
-        gate = true;
-    }
-    float lfoWaveform = 0.0f;
-    switch (synthesiserParameters.lfoWaveform) {
-        case LfoWaveformSine:
-            lfoWaveform = WaveformsAsymmetricSine(lfoPeriodClock, synthesiserParameters.lfoShape);
-            break;
-        case LfoWaveformTriangle:
-            lfoWaveform = WaveformsTriangle(lfoPeriodClock, synthesiserParameters.lfoShape);
-            break;
-        case LfoWaveformSawtooth:
-            lfoWaveform = WaveformsSawtooth(lfoPeriodClock, synthesiserParameters.lfoShape);
-            break;
-        case LfoWaveformSquare:
-            lfoWaveform = WaveformsSquare(lfoPeriodClock, synthesiserParameters.lfoShape);
+void SynthesiserSetQuality(const SynthesiserQuality quality) {
+    switch (quality) {
+        case SynthesiserQualityHigh:
+            maximumNumberOfUnisonVoices = UNISON_MAXIMUM_NUMBER_OF_VOICES;
+            WaveformsSetInterpolation(true);
+#ifndef FIXED_POINT_ENABLED
+            oversamplingEnabled = true;
+#endif
+            delayFilterOrder = 3;
             break;
-        case LfoWaveformSteppedTriangle:
-            lfoWaveform = WaveformsSteppedTriangle(lfoPeriodClock, synthesiserParameters.lfoShape);
+        case SynthesiserQualityMedium:
+            maximumNumberOfUnisonVoices = 2;
+            WaveformsSetInterpolation(true);
+#ifndef FIXED_POINT_ENABLED
+            oversamplingEnabled = true;
+#endif
+            delayFilterOrder = 2;
             break;
-        case LfoWaveformSteppedSawtooth:
-            lfoWaveform = WaveformsSteppedSawtooth(lfoPeriodClock, synthesiserParameters.lfoShape);
-            break;
-        case LfoWaveformNumberOfWaveforms:
+        case SynthesiserQualityLow:
+            maximumNumberOfUnisonVoices = 1;
+            WaveformsSetInterpolation(false);
+#ifndef FIXED_POINT_ENABLED
+            oversamplingEnabled = false;
+#endif
+            delayFilterOrder = 1;
             break;
+        case SynthesiserQualityNumberOfQualities:
+            return;
     }
-    lfoPeriodClock += (1.0f / SAMPLE_FREQUENCY) * synthesiserParameters.lfoFrequency;
-    if ((synthesiserParameters.lfoGateControl == true) && (lfoPeriodClock >= (1.0f - (PREEMPTIVE_GATE_PERIOD * synthesiserParameters.lfoFrequency)))) {
-        gate = false;
+    delayFilterOrderChanged = true;
+    SynthesiserSetUnison(&requestedUnisonParameters); // apply limit on number of voices
+}
+
+/**
+ * @brief Sets the delay model.  The model is not stored in presets.  This
+ * function has no effect if FIXED_POINT_ENABLED is defined.
+ * @param newDelayModel Delay model.
+ */
+void SynthesiserSetDelayModel(const DelayModel newDelayModel) {
+#ifndef FIXED_POINT_ENABLED
+    if (newDelayModel >= DelayModelNumberOfModels) {
+        return;
     }
-    lfoPeriodClock = WaveformsLimitNormalisedPeriod(lfoPeriodClock);
-    const float vcoModulatedFrequency = synthesiserParameters.vcoFrequency + synthesiserParameters.lfoAmplitude * lfoWaveform;
+    delayModel = newDelayModel;
+    delayModelChanged = true;
+#endif
+}
 
-    // VCO
-    static float vcoPeriodClock = 0.0f;
-    switch (synthesiserParameters.vcoWaveform) {
-        case VcoWaveformSine:
-            output = WaveformsSine(vcoPeriodClock);
-            break;
-        case VcoWaveformTriangle:
-            output = WaveformsBandwidthLimitedTriangle(vcoPeriodClock, vcoModulatedFrequency);
-            break;
-        case VcoWaveformSawtooth:
-            output = WaveformsBandwidthLimitedSawtooth(vcoPeriodClock, vcoModulatedFrequency);
+/**
+ * @brief Sets the delay mode.  The delay output is faded out and back in
+ * around the change to avoid clicks.  The mode is not stored in presets.
+ * @param delayMode Delay mode.
+ */
+void SynthesiserSetDelayMode(const DelayMode delayMode) {
+    if (delayMode >= DelayModeNumberOfModes) {
+        return;
+    }
+    requestedDelayMode = delayMode;
+}
+
+/**
+ * @brief Sets the modulation matrix parameters.  The parameters are applied at
+ * the start of the next audio update.  The modulation matrix is not stored in
+ * presets.
+ * @param newModulationMatrixParameters Modulation matrix parameters.
+ */
+void SynthesiserSetModulationMatrix(const ModulationMatrixParameters * const newModulationMatrixParameters) {
+    modulationMatrixChanged = false; // prevent partially written parameters being applied
+    modulationMatrixParameters = *newModulationMatrixParameters;
+    modulationMatrixChanged = true;
+}
+
+/**
+ * @brief Gets the modulation matrix parameters.
+ * @param currentModulationMatrixParameters Modulation matrix parameters.
+ */
+void SynthesiserGetModulationMatrix(ModulationMatrixParameters * const currentModulationMatrixParameters) {
+    *currentModulationMatrixParameters = modulationMatrixParameters;
+}
+
+/**
+ * @brief Sets VCO 2 parameters.  The parameters are applied at the start of the
+ * next audio update.  VCO 2 is not stored in presets.
+ * @param newVco2Parameters VCO 2 parameters.
+ */
+void SynthesiserSetVco2(const Vco2Parameters * const newVco2Parameters) {
+    if (newVco2Parameters->modulation >= VcoModulationNumberOfModulations) {
+        return;
+    }
+    vco2ParametersChanged = false; // prevent partially written parameters being applied
+    vco2Parameters = *newVco2Parameters;
+    vco2ParametersChanged = true;
+}
+
+/**
+ * @brief Sets unison parameters.  The parameters are applied at the start of
+ * the next audio update.  The number of voices is limited by the synthesiser
+ * quality and restored when the quality increases.  Unison is not stored in
+ * presets.
+ * @param newUnisonParameters Unison parameters.
+ */
+void SynthesiserSetUnison(const UnisonParameters * const newUnisonParameters) {
+    if ((newUnisonParameters->numberOfVoices == 0) || (newUnisonParameters->numberOfVoices > UNISON_MAXIMUM_NUMBER_OF_VOICES)) {
+        return;
+    }
+    requestedUnisonParameters = *newUnisonParameters;
+    unisonParametersChanged = false; // prevent partially written parameters being applied
+    unisonParameters = requestedUnisonParameters;
+    unisonParameters.numberOfVoices = MIN(requestedUnisonParameters.numberOfVoices, maximumNumberOfUnisonVoices);
+    unisonParametersChanged = true;
+}
+
+/**
+ * @brief Sets pitch parameters.  The note table is built into the table not
+ * used by the audio update and the parameters are applied at the start of the
+ * next audio update.  Pitch parameters are not stored in presets.
+ * @param newPitchParameters Pitch parameters.
+ * @return True if the parameters are valid.
+ */
+bool SynthesiserSetPitch(const PitchParameters * const newPitchParameters) {
+    if ((newPitchParameters->glideTime < 0.0f) || (newPitchParameters->scale >= PitchScaleNumberOfScales) || (PitchIsTuningValid(&newPitchParameters->tuning) == false)) {
+        return false;
+    }
+    pitchParametersChanged = false; // prevent partially written parameters being applied
+    pitchParameters = *newPitchParameters;
+    PitchBuildNoteTable(&pitchNoteTables[pitchNoteTableIndex == 0 ? 1 : 0], &pitchParameters);
+    pitchParametersChanged = true;
+    return true;
+}
+
+/**
+ * @brief Gets the pitch parameters.
+ * @param currentPitchParameters Pitch parameters.
+ */
+void SynthesiserGetPitch(PitchParameters * const currentPitchParameters) {
+    *currentPitchParameters = pitchParameters;
+}
+
+/**
+ * @brief Sets the wavetable position.  The position is modulated by the
+ * modulation matrix.  The wavetable position is not stored in presets.
+ * @param position Position.  0.0 to 1.0 corresponding to the first to the last
+ * table.
+ */
+void SynthesiserSetWavetablePosition(const float position) {
+    wavetablePosition = position;
+}
+
+/**
+ * @brief Returns the number of event parameters not held by a posted event.
+ * @return Number of free event parameters.
+ */
+static unsigned int GetFreeEventParameters() {
+    return NUMBER_OF_EVENT_PARAMETERS - (eventParametersPosted - eventParametersApplied);
+}
+
+/**
+ * @brief Posts a parameters or preset event.  The parameters are copied to the
+ * next event parameters, which must be free.
+ * @param type Parameters or preset event type.
+ * @param newSynthesiserParameters New synthesiser parameters.
+ */
+static void PostParametersEvent(const SynthesiserEventType type, const SynthesiserParameters * const newSynthesiserParameters) {
+    SynthesiserEvent event = {
+        .sampleCount = SynthesiserGetSampleCount() + EVENT_LATENCY,
+        .type = type,
+    };
+    event.parametersIndex = eventParametersPosted & (NUMBER_OF_EVENT_PARAMETERS - 1);
+    eventParameters[event.parametersIndex] = *newSynthesiserParameters;
+    if (SynthesiserPostEvent(&event) == true) {
+        eventParametersPosted++;
+        latestPostedParameters = *newSynthesiserParameters;
+        TRACE(TraceEventParametersPosted, event.sampleCount);
+    }
+}
+
+/**
+ * @brief Applies all events due on the current sample.
+ */
+static void ProcessEvents() {
+    const SynthesiserEvent* event;
+    while ((event = EventQueuePeek(&eventQueue)) != NULL) {
+        if ((int32_t) (event->sampleCount - sampleCount) > 0) {
+            break; // event not yet due
+        }
+        switch (event->type) {
+            case SynthesiserEventTypeTrigger:
+                lfoPeriodClock = 0.0f;
+                gate = true;
+                TriggerEnvelopes();
+                break;
+            case SynthesiserEventTypeGate:
+                if (event->gate == gate) {
+                    break;
+                }
+                gate = event->gate;
+                if (gate == true) {
+                    TriggerEnvelopes();
+                } else {
+                    ReleaseEnvelopes();
+                }
+                break;
+            case SynthesiserEventTypeParameters:
+                ApplyParameters(&eventParameters[event->parametersIndex]);
+                eventParametersApplied++;
+                TRACE(TraceEventParametersApplied, sampleCount);
+                break;
+            case SynthesiserEventTypePreset:
+                ApplyParameters(&eventParameters[event->parametersIndex]);
+                eventParametersApplied++;
+                TRACE(TraceEventParametersApplied, sampleCount);
+                lfoPeriodClock = 0.0f;
+                gate = true;
+                TriggerEnvelopes();
+                break;
+        }
+        EventQueuePop(&eventQueue);
+    }
+}
+
+/**
+ * @brief Applies new synthesiser parameters.
+ * @param newSynthesiserParameters New synthesiser parameters.
+ */
+static void ApplyParameters(const SynthesiserParameters * const newSynthesiserParameters) {
+    synthesiserParameters = *newSynthesiserParameters;
+    PitchSetTarget(&pitch, synthesiserParameters.vcoFrequency);
+    LfoSetShape(&lfo, synthesiserParameters.lfoWaveform, synthesiserParameters.lfoShape);
+    EnvelopeSetParameters(&envelope, &synthesiserParameters.envelope, SAMPLE_FREQUENCY);
+    lfoGateControlPeriod = (PREEMPTIVE_GATE_PERIOD + (synthesiserParameters.envelope.mode == EnvelopeModeAdsr ? synthesiserParameters.envelope.release : 0.0f)) * synthesiserParameters.lfoFrequency;
+#ifdef FIXED_POINT_ENABLED
+    delayFeedback = Q31FromFloat(synthesiserParameters.delayFeedback);
+    holdFeedback = Q31FromFloat(1.0f - (1.0f - synthesiserParameters.delayFeedback) * HOLD_LEAKAGE);
+#else
+    holdFeedback = 1.0f - (1.0f - synthesiserParameters.delayFeedback) * HOLD_LEAKAGE;
+#endif
+    SetDelayFilterCornerFrequency();
+}
+
+/**
+ * @brief Sets the delay filter corner frequency, including any modulation of
+ * the filter cutoff by the modulation matrix.
+ */
+static void SetDelayFilterCornerFrequency() {
+    float cornerFrequency = synthesiserParameters.delayFilterFrequency;
+    if (ModulationMatrixIsActive(&modulationMatrix, ModulationDestinationFilterCutoff) == true) {
+        cornerFrequency = MIN(cornerFrequency * ModulationMatrixGetTarget(&modulationMatrix, ModulationDestinationFilterCutoff), 0.45f * SAMPLE_FREQUENCY); // limit to below Nyquist frequency
+    }
+#ifdef FIXED_POINT_ENABLED
+    CascadeFilterQ31SetCornerFrequency(&delayFilter,
+            cornerFrequency,
+            SAMPLE_FREQUENCY,
+            synthesiserParameters.delayFilterType == DelayFilterTypeHighPass,
+            delayFilterOrder);
+#else
+    CascadeFilterSetCornerFrequency(&delayFilter,
+            cornerFrequency,
+            SAMPLE_FREQUENCY,
+            synthesiserParameters.delayFilterType == DelayFilterTypeHighPass,
+            delayFilterOrder);
+#endif
+}
+
+/**
+ * @brief Triggers the amplitude envelope and modulation matrix, and randomises
+ * the phases of the unison voices.
+ */
+static void TriggerEnvelopes() {
+    EnvelopeTrigger(&envelope);
+    ModulationMatrixTrigger(&modulationMatrix);
+    VcoTrigger(&vco);
+}
+
+/**
+ * @brief Releases the amplitude envelope and modulation matrix.
+ */
+static void ReleaseEnvelopes() {
+    EnvelopeRelease(&envelope);
+    ModulationMatrixRelease(&modulationMatrix);
+}
+
+/**
+ * @brief Applies changes to the modulation matrix parameters and updates the
+ * modulation for the next block.  The delay filter cutoff is modulated once per
+ * block.
+ */
+static void UpdateModulationMatrix() {
+    const bool filterCutoffWasActive = ModulationMatrixIsActive(&modulationMatrix, ModulationDestinationFilterCutoff);
+    if (modulationMatrixChanged == true) {
+        modulationMatrixChanged = false;
+        ModulationMatrixSetParameters(&modulationMatrix, &modulationMatrixParameters);
+    }
+    ModulationMatrixUpdate(&modulationMatrix, LfoGetAmplitude(&lfo, lfoPeriodClock), envelope.value, DAC_BLOCK_SIZE);
+    if ((filterCutoffWasActive == true) || (ModulationMatrixIsActive(&modulationMatrix, ModulationDestinationFilterCutoff) == true)) {
+        SetDelayFilterCornerFrequency(); // also restores unmodulated cutoff when route removed
+    }
+}
+
+/**
+ * @brief Renders a block of samples and writes the block to the DAC.  Events
+ * are still applied on the sample that they are due.
+ */
+static void AudioUpdate() {
+    if (vco2ParametersChanged == true) {
+        vco2ParametersChanged = false;
+        VcoSetVco2Parameters(&vco, &vco2Parameters);
+    }
+    if (unisonParametersChanged == true) {
+        unisonParametersChanged = false;
+        VcoSetUnisonParameters(&vco, &unisonParameters);
+    }
+    if (pitchParametersChanged == true) {
+        pitchParametersChanged = false;
+        pitchNoteTableIndex = pitchNoteTableIndex == 0 ? 1 : 0;
+        PitchSetParameters(&pitch, &pitchParameters, &pitchNoteTables[pitchNoteTableIndex]);
+        PitchSetTarget(&pitch, synthesiserParameters.vcoFrequency);
+    }
+    PitchUpdate(&pitch);
+    EnvelopeUpdate(&envelope);
+    UpdateModulationMatrix();
+#ifndef FIXED_POINT_ENABLED
+    if (delayModelChanged == true) {
+        delayModelChanged = false;
+        activeDelayModel = delayModel;
+        EchoSetModel(&echo, activeDelayModel);
+    }
+    EchoUpdate(&echo, smoothedDelayTime, DAC_BLOCK_SIZE);
+#endif
+    static Sample block[DAC_BLOCK_SIZE];
+    unsigned int index;
+    for (index = 0; index < DAC_BLOCK_SIZE; index++) {
+        block[index] = RenderSample();
+    }
+    if (delayIdle == true) {
+        ClearDelayBuffer();
+    }
+#ifdef FIXED_POINT_ENABLED
+    DacWriteBlockQ31(block);
+#else
+    EffectsChainProcess(block, DAC_BLOCK_SIZE);
+    SaturationLimiterProcess(&outputLimiter, block, DAC_BLOCK_SIZE);
+    DacWriteBlock(block);
+#endif
+}
+
+/**
+ * @brief Updates audio calculations for one sample.
+ * @return Output sample.
+ */
+static inline __attribute__((always_inline)) Sample RenderSample() {
+
+    // Apply events due on this sample
+    sampleCount++;
+    ProcessEvents();
+    if (delayFilterOrderChanged == true) {
+        delayFilterOrderChanged = false;
+        ApplyParameters(&synthesiserParameters);
+    }
+
+    // Skip oscillators if envelope idle
+    const bool oscillatorsActive = EnvelopeIsActive(&envelope);
+    float oscillator = 0.0f;
+    if (oscillatorsActive == false) {
+        lfoPeriodClock = WaveformsLimitNormalisedPeriod(lfoPeriodClock + (1.0f / SAMPLE_FREQUENCY) * synthesiserParameters.lfoFrequency); // maintain LFO phase
+    } else {
+
+        // LFO
+        const float lfoWaveform = LfoGetAmplitude(&lfo, lfoPeriodClock);
+        lfoPeriodClock += (1.0f / SAMPLE_FREQUENCY) * synthesiserParameters.lfoFrequency;
+        if ((synthesiserParameters.lfoGateControl == true) && (gate == true) && (lfoPeriodClock >= (1.0f - lfoGateControlPeriod))) {
+            gate = false;
+            ReleaseEnvelopes();
+        }
+        lfoPeriodClock = WaveformsLimitNormalisedPeriod(lfoPeriodClock);
+        float vcoModulatedFrequency = PitchGetFrequency(&pitch) + synthesiserParameters.lfoAmplitude * lfoWaveform;
+        if (ModulationMatrixIsActive(&modulationMatrix, ModulationDestinationVcoPitch) == true) {
+            vcoModulatedFrequency *= ModulationMatrixGetNext(&modulationMatrix, ModulationDestinationVcoPitch);
+        }
+
+        // VCOs
+        float pulseWidthOffset = 0.0f;
+        if (ModulationMatrixIsActive(&modulationMatrix, ModulationDestinationPulseWidth) == true) {
+            pulseWidthOffset = ModulationMatrixGetNext(&modulationMatrix, ModulationDestinationPulseWidth);
+        }
+        float modulatedWavetablePosition = wavetablePosition;
+        if (ModulationMatrixIsActive(&modulationMatrix, ModulationDestinationWavetablePosition) == true) {
+            modulatedWavetablePosition += ModulationMatrixGetNext(&modulationMatrix, ModulationDestinationWavetablePosition);
+        }
+        oscillator = VcoUpdate(&vco, synthesiserParameters.vcoWaveform, vcoModulatedFrequency, pulseWidthOffset, modulatedWavetablePosition);
+
+        // Envelope
+        oscillator *= EnvelopeGetNext(&envelope);
+
+        // Attenuate output
+        oscillator *= 0.25f;
+    }
+#ifdef FIXED_POINT_ENABLED
+    Sample output = Q31FromFloat(oscillator);
+#else
+    Sample output = oscillator;
+#endif
+
+    // Skip delay if oscillators inactive and delay buffer is silent
+    float delayTime = FirstOrderFilterUpdate(&delayTimeLowPassFilter, synthesiserParameters.delayTime); // filter out sudden changes to avoid distortion
+    if (ModulationMatrixIsActive(&modulationMatrix, ModulationDestinationDelayTime) == true) {
+        delayTime = MAX(delayTime + ModulationMatrixGetNext(&modulationMatrix, ModulationDestinationDelayTime), 0.0f);
+    }
+#ifndef FIXED_POINT_ENABLED
+    smoothedDelayTime = delayTime;
+#endif
+    if ((oscillatorsActive == false) && (delaySilentSampleCount >= DELAY_BUFFER_SIZE) && (activeDelayMode != DelayModeFreeze)) {
+        delayIdle = true;
+        return output;
+    }
+    delayIdle = false;
+    delayClearIndex = 0;
+
+    // Delay
+    const Sample delayModeGain = UpdateDelayMode(delayTime);
+    const DelayMode delayMode = activeDelayMode;
+    if (delayMode != DelayModeFreeze) {
+        WriteToDelayBuffer(delayMode == DelayModeHold ? 0 : output);
+    }
+#ifdef FIXED_POINT_ENABLED
+    q31 feedback = delayFeedback;
+    if (ModulationMatrixIsActive(&modulationMatrix, ModulationDestinationDelayFeedback) == true) {
+        feedback = Q31FromFloat(CLAMP(synthesiserParameters.delayFeedback + ModulationMatrixGetNext(&modulationMatrix, ModulationDestinationDelayFeedback), 0.0f, 1.0f));
+    }
+#else
+    float feedback = synthesiserParameters.delayFeedback;
+    if (ModulationMatrixIsActive(&modulationMatrix, ModulationDestinationDelayFeedback) == true) {
+        feedback = CLAMP(feedback + ModulationMatrixGetNext(&modulationMatrix, ModulationDestinationDelayFeedback), 0.0f, 1.0f);
+    }
+#endif
+    if (delayMode == DelayModeFreeze) {
+        feedback = SAMPLE_UNITY;
+    } else if (delayMode == DelayModeHold) {
+        feedback = holdFeedback;
+    }
+#ifdef FIXED_POINT_ENABLED
+    q31 delaySample = Q31Multiply(feedback, ReadDelay(delayMode, delayTime));
+    if (synthesiserParameters.delayFilterType != DelayFilterTypeNone) {
+        delaySample = CascadeFilterQ31Update(&delayFilter, delaySample);
+    }
+    output = Q31Add(output, Q31Multiply(delaySample, delayModeGain)); // mode fade applied to output only so that it is not recorded in the feedback
+#else
+    const bool oversampled = oversamplingEnabled;
+    const float readDelayTime = oversampled == true ? MAX(delayTime - (SATURATION_OVERSAMPLED_LATENCY / SAMPLE_FREQUENCY), 0.0f) : delayTime; // compensate for oversampler latency so that the delay time is independent of quality
+    float delaySample = feedback * ReadDelay(delayMode, readDelayTime);
+    if (synthesiserParameters.delayFilterType != DelayFilterTypeNone) {
+        delaySample = CascadeFilterUpdate(&delayFilter, delaySample);
+    }
+    if (oversampled == true) {
+        delaySample = SaturationOversampledSoftClip(&delaySaturationOversampler, delaySample);
+    } else {
+        delaySample = SaturationSoftKnee(delaySample, DELAY_SOFT_CLIP_THRESHOLD);
+    }
+    output += delaySample * delayModeGain; // mode fade applied to output only so that it is not recorded in the feedback
+#endif
+    if (delayMode != DelayModeFreeze) {
+        MixToDelayBuffer(delaySample);
+    }
+    IncrementDelayBufferIndex();
+    return output;
+}
+
+/**
+ * @brief Updates the delay mode crossfade.  A change of mode fades the delay
+ * output out, switches mode and then fades the delay output back in.
+ * @param delayTime Delay time in seconds.
+ * @return Delay output gain.
+ */
+static Sample UpdateDelayMode(const float delayTime) {
+    Sample gain = SAMPLE_UNITY;
+    switch (delayModeFade) {
+        case DelayModeFadeNone:
+            if (requestedDelayMode == activeDelayMode) {
+                break;
+            }
+            delayModeFade = DelayModeFadeOut;
+            delayModeFadeIndex = 0;
+            // fall through
+        case DelayModeFadeOut:
+            gain = CrossfadeWindow(crossfadeLength - 1 - delayModeFadeIndex);
+            if (++delayModeFadeIndex >= crossfadeLength) {
+                activeDelayMode = requestedDelayMode;
+                StartDelayMode(delayTime);
+                delayModeFade = DelayModeFadeIn;
+                delayModeFadeIndex = 0;
+            }
             break;
-        case VcoWaveformSquare:
-            output = WaveformsBandwidthLimitedSquare(vcoPeriodClock, vcoModulatedFrequency);
+        case DelayModeFadeIn:
+            gain = CrossfadeWindow(delayModeFadeIndex);
+            if (++delayModeFadeIndex >= crossfadeLength) {
+                delayModeFade = DelayModeFadeNone;
+            }
             break;
-        case VcoWaveformPulse:
-            output = WaveformsBandwidthLimitedPulse(vcoPeriodClock, vcoModulatedFrequency);
+    }
+    return gain;
+}
+
+/**
+ * @brief Starts the active delay mode.  The crossfade length is set once here
+ * to one eighth of the delay time, and is used by the mode and the next change
+ * of mode.
+ * @param delayTime Delay time in seconds.
+ */
+static void StartDelayMode(const float delayTime) {
+
+    // Set crossfade length
+    const unsigned int delayLength = (unsigned int) CLAMP(delayTime * SAMPLE_FREQUENCY, 0.0f, (float) DELAY_BUFFER_SIZE);
+    crossfadeLength = CLAMP(delayLength / 8, MINIMUM_CROSSFADE_LENGTH, MAXIMUM_CROSSFADE_LENGTH);
+    crossfadeWindowStep = 0.25f / (float) crossfadeLength;
+
+    // Initialise mode
+    switch (activeDelayMode) {
+        case DelayModeFreeze:
+            freezeLength = CLAMP(delayLength, 2 * crossfadeLength, DELAY_BUFFER_SIZE - crossfadeLength);
+            freezeStart = WrapDelayBufferIndex((int) delayBufferIndex - (int) freezeLength);
+            freezePhase = 0;
             break;
-        case VcoWaveformOneBitNoise:
-            output = WaveformsOneBitNoise(vcoModulatedFrequency, SAMPLE_FREQUENCY);
+        case DelayModeReverse:
+            reverseLength = CLAMP(delayLength, 2 * crossfadeLength, DELAY_BUFFER_SIZE / 2);
+            reverseStart = delayBufferIndex;
+            reversePhase = 0;
             break;
-        case VcoWaveformNumberOfWaveforms:
+        case DelayModeNormal:
+        case DelayModeHold:
+        case DelayModeNumberOfModes:
             break;
     }
-    vcoPeriodClock += (1.0f / SAMPLE_FREQUENCY) * vcoModulatedFrequency;
-    vcoPeriodClock = WaveformsLimitNormalisedPeriod(vcoPeriodClock);
+}
 
-    // Gate
-    static float gateGain = 0.0f;
-    gateGain = FirstOrderFilterUpdate(&gateGainLowPassFilter, gate == true ? 1.0f : 0.0f);
-    output *= gateGain;
+/**
+ * @brief Returns sample read from delay buffer for the delay mode.  Samples
+ * are processed by the playback stage of the echo model for all modes so that
+ * the level and tone are consistent between modes.
+ * @param delayMode Delay mode.
+ * @param delayTime Delay time in seconds.
+ * @return Sample read from delay buffer.
+ */
+static Sample ReadDelay(const DelayMode delayMode, const float delayTime) {
+    if ((delayMode != DelayModeFreeze) && (delayMode != DelayModeReverse)) {
+#ifndef FIXED_POINT_ENABLED
+        if ((activeDelayModel != DelayModelDigital) || (EchoIsModulated(&echo) == true)) {
+            return EchoPlayback(&echo, ReadFromDelayBufferInterpolated(delayTime * SAMPLE_FREQUENCY + EchoGetModulation(&echo)));
+        }
+#endif
+        return ReadFromDelayBuffer(delayTime);
+    }
+    const Sample sample = delayMode == DelayModeFreeze ? ReadFrozenLoop() : ReadReverse(delayTime);
+#ifndef FIXED_POINT_ENABLED
+    if (activeDelayModel != DelayModelDigital) {
+        return EchoPlayback(&echo, sample);
+    }
+#endif
+    return sample;
+}
 
-    // Attenuate output
-    output *= 0.25f;
+/**
+ * @brief Returns the next sample of the frozen loop.  The end of the loop is
+ * crossfaded with the samples that preceded the start of the loop so that the
+ * loop point is continuous.
+ * @return Sample read from delay buffer.
+ */
+static Sample ReadFrozenLoop() {
+    Sample sample = delayBuffer[WrapDelayBufferIndex(freezeStart + freezePhase)];
+    if (freezePhase >= (freezeLength - crossfadeLength)) {
+        const unsigned int index = freezePhase - (freezeLength - crossfadeLength);
+        sample = Crossfade(sample, delayBuffer[WrapDelayBufferIndex((int) freezeStart - (int) crossfadeLength + (int) index)], index);
+    }
+    if (++freezePhase >= freezeLength) {
+        freezePhase = 0;
+    }
+    return sample;
+}
 
-    // Delay
-    WriteToDelayBuffer(output);
-    float delaySample = synthesiserParameters.delayFeedback * ReadFromDelayBuffer(synthesiserParameters.delayTime);
-    if (synthesiserParameters.delayFilterType != DelayFilterTypeNone) {
-        delaySample = CascadeFilterUpdate(&delayFilter, delaySample);
+/**
+ * @brief Returns the next sample read backwards from the delay buffer.  Each
+ * window starts at the most recent sample and reads backwards for the window
+ * length.  The end of each window is crossfaded with the start of the next.
+ * @param delayTime Delay time in seconds.  Sets the length of the next window.
+ * @return Sample read from delay buffer.
+ */
+static Sample ReadReverse(const float delayTime) {
+    Sample sample = delayBuffer[WrapDelayBufferIndex((int) reverseStart - (int) reversePhase)];
+    if (reversePhase >= (reverseLength - crossfadeLength)) {
+        const unsigned int index = reversePhase - (reverseLength - crossfadeLength);
+        if (index == 0) {
+            reverseNextStart = delayBufferIndex;
+        }
+        sample = Crossfade(sample, delayBuffer[WrapDelayBufferIndex((int) reverseNextStart - (int) index)], index);
     }
-    MixToDelayBuffer(delaySample);
-    IncrementDelayBufferIndex();
-    output += delaySample;
+    if (++reversePhase >= reverseLength) {
+        reverseStart = reverseNextStart;
+        reversePhase = crossfadeLength;
+        reverseLength = CLAMP((unsigned int) (delayTime * SAMPLE_FREQUENCY), 2 * crossfadeLength, DELAY_BUFFER_SIZE / 2);
+    }
+    return sample;
+}
+
+/**
+ * @brief Equal-power crossfade between two samples.
+ * @param sampleOut Sample fading out.
+ * @param sampleIn Sample fading in.
+ * @param index Crossfade window index.
+ * @return Crossfaded sample.
+ */
+static inline __attribute__((always_inline)) Sample Crossfade(const Sample sampleOut, const Sample sampleIn, const unsigned int index) {
+    const Sample crossfaded = MultiplySample(sampleOut, CrossfadeWindow(crossfadeLength - 1 - index));
+#ifdef FIXED_POINT_ENABLED
+    return Q31Add(crossfaded, MultiplySample(sampleIn, CrossfadeWindow(index)));
+#else
+    return crossfaded + MultiplySample(sampleIn, CrossfadeWindow(index));
+#endif
+}
+
+/**
+ * @brief Returns the equal-power crossfade window, the first quarter cycle of
+ * a sine wave over the crossfade length.  Calculated on the fly rather than
+ * stored to save RAM.
+ * @param index Crossfade window index.
+ * @return Crossfade window gain.
+ */
+static inline __attribute__((always_inline)) Sample CrossfadeWindow(const unsigned int index) {
+    const float window = FastMathSinCycles(crossfadeWindowStep * ((float) index + 0.5f));
+#ifdef FIXED_POINT_ENABLED
+    return Q31FromFloat(window);
+#else
+    return window;
+#endif
+}
+
+/**
+ * @brief Multiplies two samples.
+ * @param sampleA Sample A.
+ * @param sampleB Sample B.
+ * @return Product.
+ */
+static inline __attribute__((always_inline)) Sample MultiplySample(const Sample sampleA, const Sample sampleB) {
+#ifdef FIXED_POINT_ENABLED
+    return Q31Multiply(sampleA, sampleB);
+#else
+    return sampleA * sampleB;
+#endif
+}
+
+/**
+ * @brief Wraps-around delay buffer index.
+ * @param index Index between -DELAY_BUFFER_SIZE and 2 * DELAY_BUFFER_SIZE.
+ * @return Index between 0 and DELAY_BUFFER_SIZE - 1.
+ */
+static inline __attribute__((always_inline)) unsigned int WrapDelayBufferIndex(const int index) {
+    if (index < 0) {
+        return index + DELAY_BUFFER_SIZE; // handle index underflow
+    }
+    if (index >= DELAY_BUFFER_SIZE) {
+        return index - DELAY_BUFFER_SIZE; // handle index overflow
+    }
+    return index;
 }
 
 /**
  * @brief Writes sample to delay buffer.
  * @param sample Sample to be written to delay buffer.
  */
-static void WriteToDelayBuffer(const float sample) {
+static void WriteToDelayBuffer(const Sample sample) {
     delayBuffer[delayBufferIndex] = sample;
 }
 
 /**
  * @brief Returns sample read from delay buffer with specified delay time.
- * @param delay Delay time between 0.0 and 1.0.
+ * @param delayTime Delay time in seconds.
  * @return Returns sample read from delay buffer.
  */
-static float ReadFromDelayBuffer(float delayTime) {
-    delayTime = FirstOrderFilterUpdate(&delayTimeLowPassFilter, delayTime); // filter out sudden changes to avoid distortion
-    int readIndex = delayBufferIndex - CLAMP((int) (delayTime * SAMPLE_FREQUENCY), 0, DELAY_BUFFER_SIZE);
-    if (readIndex < 0) {
-        readIndex = DELAY_BUFFER_SIZE + readIndex; // handle index underflow
-    }
-    return delayBuffer[readIndex];
+static Sample ReadFromDelayBuffer(const float delayTime) {
+    return delayBuffer[WrapDelayBufferIndex((int) delayBufferIndex - CLAMP((int) (delayTime * SAMPLE_FREQUENCY), 0, DELAY_BUFFER_SIZE))];
+}
+
+#ifndef FIXED_POINT_ENABLED
+
+/**
+ * @brief Returns sample read from delay buffer with a fractional delay using
+ * linear interpolation.
+ * @param delay Delay in samples.
+ * @return Returns sample read from delay buffer.
+ */
+static float ReadFromDelayBufferInterpolated(const float delay) {
+    const float clampedDelay = CLAMP(delay, 0.0f, (float) (DELAY_BUFFER_SIZE - 2));
+    const int delayFloor = (int) clampedDelay; // truncation is floor because delay is not negative
+    const float fraction = clampedDelay - (float) delayFloor;
+    const unsigned int readIndex = WrapDelayBufferIndex((int) delayBufferIndex - delayFloor);
+    const float sample = delayBuffer[readIndex];
+    return sample + fraction * (delayBuffer[WrapDelayBufferIndex((int) readIndex - 1)] - sample);
 }
 
+#endif
+
 /**
- * @brief Mixes sample to delay buffer.
+ * @brief Mixes sample to delay buffer and counts consecutive silent samples.
  * @param sample Sample to be mixed to delay buffer.
  */
-static void MixToDelayBuffer(const float sample) {
-    delayBuffer[delayBufferIndex] += CLAMP(sample, -1.0f, 1.0f);
+static void MixToDelayBuffer(const Sample sample) {
+#ifdef FIXED_POINT_ENABLED
+    const q31 mixedSample = Q31Add(delayBuffer[delayBufferIndex], sample);
+    const bool silent = (mixedSample < DELAY_SILENCE_THRESHOLD_Q31) && (mixedSample > -DELAY_SILENCE_THRESHOLD_Q31);
+#else
+    const float mixedSample = QUANTISE_TO_ZERO(EchoRecord(&echo, delayBuffer[delayBufferIndex] + sample)); // prevent subnormal values as feedback decays
+    const bool silent = fabsf(mixedSample) < DELAY_SILENCE_THRESHOLD;
+#endif
+    delayBuffer[delayBufferIndex] = mixedSample;
+    if (silent == true) {
+        if (delaySilentSampleCount < DELAY_BUFFER_SIZE) {
+            delaySilentSampleCount++;
+        }
+    } else {
+        delaySilentSampleCount = 0;
+    }
 }
 
 /**
@@ -260,5 +1199,20 @@ static void IncrementDelayBufferIndex() {
     }
 }
 
+/**
+ * @brief Clears part of the delay buffer while the delay is idle so that
+ * residual samples below the silence threshold are not heard when the delay
+ * resumes.  This function should be called once per audio update.  Successive
+ * calls clear the entire buffer.
+ */
+static void ClearDelayBuffer() {
+    if (delayClearIndex >= DELAY_BUFFER_SIZE) {
+        return;
+    }
+    const unsigned int numberOfSamples = MIN(DELAY_CLEAR_SAMPLES_PER_UPDATE, DELAY_BUFFER_SIZE - delayClearIndex);
+    memset(&delayBuffer[delayClearIndex], 0, numberOfSamples * sizeof (Sample));
+    delayClearIndex += numberOfSamples;
+}
+
 //------------------------------------------------------------------------------
 // End of file
@@ -12,10 +12,18 @@
 
 #include "Dac/Dac.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 //------------------------------------------------------------------------------
 // Definitions
 
+/**
+ * @brief Uncomment this definition to process the delay, delay filter and
+ * output in saturating Q31 fixed-point arithmetic.  The oscillators remain
+ * float.
+ */
+//#define FIXED_POINT_ENABLED
+
 /**
  * @brief LFO waveforms type.
  */
@@ -26,6 +34,8 @@ typedef enum {
     LfoWaveformSquare,
     LfoWaveformSteppedTriangle,
     LfoWaveformSteppedSawtooth,
+    LfoWaveformSampleAndHold,
+    LfoWaveformSmoothRandom,
     LfoWaveformNumberOfWaveforms,
 } LfoWaveform;
 
@@ -39,9 +49,86 @@ typedef enum {
     VcoWaveformSquare,
     VcoWaveformPulse,
     VcoWaveformOneBitNoise,
+    VcoWaveformWavetable, // sine wave if WAVETABLE_ENABLED is not defined
     VcoWaveformNumberOfWaveforms,
 } VcoWaveform;
 
+/**
+ * @brief VCO 2 modulation type.  Determines how VCO 2 is combined with VCO 1.
+ */
+typedef enum {
+    VcoModulationMix, // VCO 2 mixed with VCO 1
+    VcoModulationFrequency, // through-zero linear frequency modulation of VCO 1 by VCO 2
+    VcoModulationSync, // VCO 2 hard synced to VCO 1, VCO 2 output only
+    VcoModulationRing, // VCO 1 multiplied by VCO 2
+    VcoModulationNumberOfModulations,
+} VcoModulation;
+
+/**
+ * @brief VCO 2 parameters structure.  VCO 2 is not rendered if the modulation
+ * is VcoModulationMix and the amount is zero.
+ */
+typedef struct {
+    VcoModulation modulation;
+    VcoWaveform waveform;
+    float ratio; // frequency as a ratio of the VCO 1 frequency
+    float amount; // mix of VCO 2 or ring modulation 0.0 to 1.0, or FM index (peak deviation as a ratio of the VCO 1 frequency), unused for sync
+} Vco2Parameters;
+
+/**
+ * @brief Maximum number of unison voices.
+ */
+#define UNISON_MAXIMUM_NUMBER_OF_VOICES (8)
+
+/**
+ * @brief Unison parameters structure.  VCO 1 is a stack of detuned voices if
+ * the number of voices is greater than 1.
+ */
+typedef struct {
+    unsigned int numberOfVoices; // 1 to UNISON_MAXIMUM_NUMBER_OF_VOICES
+    float spread; // detune of the outermost voices in cents
+    float mix; // level of the detuned voices relative to the centre voices, 0.0 to 1.0
+} UnisonParameters;
+
+/**
+ * @brief Maximum number of degrees of a pitch tuning.
+ */
+#define PITCH_MAXIMUM_NUMBER_OF_DEGREES (16)
+
+/**
+ * @brief Pitch quantiser scale.  Scales other than chromatic select degrees of
+ * a 12 degree tuning and are chromatic for other tunings.
+ */
+typedef enum {
+    PitchScaleOff,
+    PitchScaleChromatic,
+    PitchScaleMajor,
+    PitchScaleMinor,
+    PitchScaleMajorPentatonic,
+    PitchScaleMinorPentatonic,
+    PitchScaleNumberOfScales,
+} PitchScale;
+
+/**
+ * @brief Pitch tuning structure.  Degrees are in cents above the reference in
+ * ascending order, as in the Scala scale format.  The last degree is the period
+ * at which the tuning repeats.
+ */
+typedef struct {
+    float reference; // frequency of the first note of each period in Hz
+    unsigned int numberOfDegrees; // 1 to PITCH_MAXIMUM_NUMBER_OF_DEGREES
+    float degrees[PITCH_MAXIMUM_NUMBER_OF_DEGREES]; // cents
+} PitchTuning;
+
+/**
+ * @brief Pitch parameters structure.
+ */
+typedef struct {
+    float glideTime; // time constant in seconds, 0.0 for no glide
+    PitchScale scale;
+    PitchTuning tuning;
+} PitchParameters;
+
 /**
  * @brief Delay filter type.
  */
@@ -51,6 +138,134 @@ typedef enum {
     DelayFilterTypeHighPass,
 } DelayFilterType;
 
+/**
+ * @brief Envelope mode type.
+ */
+typedef enum {
+    EnvelopeModeAdsr, // release starts when the gate closes
+    EnvelopeModeAd, // decays to zero regardless of the gate
+} EnvelopeMode;
+
+/**
+ * @brief Envelope retrigger type.  Determines the level from which the attack
+ * starts when triggered while the envelope is active.
+ */
+typedef enum {
+    EnvelopeRetriggerAnalog, // attack starts from the current level
+    EnvelopeRetriggerReset, // attack starts from zero
+} EnvelopeRetrigger;
+
+/**
+ * @brief Envelope parameters structure.  Decay and release times are the
+ * time to fall by 60 dB.
+ */
+typedef struct {
+    EnvelopeMode mode;
+    EnvelopeRetrigger retrigger;
+    float attack; // seconds from zero to full level
+    float decay; // seconds
+    float sustain; // 0.0 to 1.0, unused in AD mode
+    float release; // seconds
+} EnvelopeParameters;
+
+/**
+ * @brief Number of modulation matrix routes.
+ */
+#define MODULATION_MATRIX_NUMBER_OF_ROUTES (8)
+
+/**
+ * @brief Number of modulation matrix LFOs in addition to the synthesiser LFO.
+ */
+#define MODULATION_MATRIX_NUMBER_OF_LFOS (2)
+
+/**
+ * @brief Modulation source type.  LFO and random sources are -1.0 to 1.0.
+ * Envelope sources are 0.0 to 1.0.
+ */
+typedef enum {
+    ModulationSourceLfo1, // synthesiser LFO
+    ModulationSourceLfo2,
+    ModulationSourceLfo3,
+    ModulationSourceEnvelope, // amplitude envelope
+    ModulationSourceModulationEnvelope,
+    ModulationSourceRandom, // new value on each trigger
+    ModulationSourceNumberOfSources,
+} ModulationSource;
+
+/**
+ * @brief Modulation destination type.  The comment of each destination
+ * describes the units of the route depth.
+ */
+typedef enum {
+    ModulationDestinationVcoPitch, // octaves
+    ModulationDestinationPulseWidth, // duty cycle, 0.0 to 1.0 corresponding to 0% to 100%
+    ModulationDestinationDelayTime, // seconds
+    ModulationDestinationDelayFeedback, // 0.0 to 1.0 corresponding to 0% to 100%
+    ModulationDestinationFilterCutoff, // octaves
+    ModulationDestinationWavetablePosition, // 0.0 to 1.0 corresponding to the first to the last table
+    ModulationDestinationNumberOfDestinations,
+} ModulationDestination;
+
+/**
+ * @brief Modulation route structure.  A route with a depth of zero is
+ * inactive.
+ */
+typedef struct {
+    ModulationSource source;
+    ModulationDestination destination;
+    float depth;
+} ModulationRoute;
+
+/**
+ * @brief Modulation matrix LFO parameters structure.
+ */
+typedef struct {
+    LfoWaveform waveform;
+    float shape; // 0.0 to 1.0
+    float frequency; // Hz
+} ModulationLfoParameters;
+
+/**
+ * @brief Modulation matrix parameters structure.
+ */
+typedef struct {
+    ModulationRoute routes[MODULATION_MATRIX_NUMBER_OF_ROUTES];
+    ModulationLfoParameters lfos[MODULATION_MATRIX_NUMBER_OF_LFOS];
+    EnvelopeParameters envelope;
+} ModulationMatrixParameters;
+
+/**
+ * @brief Delay model type.
+ */
+typedef enum {
+    DelayModelDigital,
+    DelayModelTape,
+    DelayModelBucketBrigade,
+    DelayModelNumberOfModels,
+} DelayModel;
+
+/**
+ * @brief Delay mode type.
+ */
+typedef enum {
+    DelayModeNormal,
+    DelayModeFreeze, // stop writing and loop the current contents
+    DelayModeReverse, // read backwards in crossfaded windows
+    DelayModeHold, // feedback pinned to unity, feedback parameter sets leakage
+    DelayModeNumberOfModes,
+} DelayMode;
+
+/**
+ * @brief Synthesiser quality type.  Lower qualities reduce the processing
+ * required per sample.
+ */
+typedef enum {
+    SynthesiserQualityHigh,
+    SynthesiserQualityMedium,
+    SynthesiserQualityLow,
+    SynthesiserQualityNumberOfQualities,
+} SynthesiserQuality;
+
 /**
  * @brief Synthesiser parameter structure.
  */
@@ -66,21 +281,65 @@ typedef struct {
     float delayFeedback; // 0.0 to 1.0 corresponding to 0% to 100%
     DelayFilterType delayFilterType;
     float delayFilterFrequency; // Hz
+    EnvelopeParameters envelope;
 } SynthesiserParameters;
 
+/**
+ * @brief Synthesiser event types.
+ */
+typedef enum {
+    SynthesiserEventTypeTrigger,
+    SynthesiserEventTypeGate,
+    SynthesiserEventTypeParameters,
+    SynthesiserEventTypePreset, // parameters and trigger
+} SynthesiserEventType;
+
+/**
+ * @brief Synthesiser event structure.  The event is applied at the start of the
+ * sample with the specified sample count.  The parameters of parameters and
+ * preset events are held by the synthesiser and referenced by index so that
+ * each queued event is small.
+ */
+typedef struct {
+    uint32_t sampleCount;
+    SynthesiserEventType type;
+
+    union {
+        bool gate;
+        unsigned int parametersIndex; // used internally
+    };
+} SynthesiserEvent;
+
 //------------------------------------------------------------------------------
 // Variable declarations
 
 extern const SynthesiserParameters defaultSynthesiserParameters;
+extern const ModulationMatrixParameters defaultModulationMatrixParameters;
+extern const Vco2Parameters defaultVco2Parameters;
+extern const UnisonParameters defaultUnisonParameters;
+extern const PitchParameters defaultPitchParameters;
 
 //------------------------------------------------------------------------------
 // Function prototypes
 
 void SynthesiserInitialise();
+uint32_t SynthesiserGetSampleCount();
+bool SynthesiserPostEvent(const SynthesiserEvent * const event);
 void SynthesiserSetParameters(const SynthesiserParameters * const newSynthesiserParameters);
+void SynthesiserLoadPreset(const SynthesiserParameters * const presetSynthesiserParameters);
 void SynthesiserTrigger();
 void SynthesiserSetGate(const bool state);
 bool SynthesiserGetGate();
+void SynthesiserSetQuality(const SynthesiserQuality quality);
+void SynthesiserSetDelayModel(const DelayModel delayModel);
+void SynthesiserSetDelayMode(const DelayMode delayMode);
+void SynthesiserSetModulationMatrix(const ModulationMatrixParameters * const modulationMatrixParameters);
+void SynthesiserGetModulationMatrix(ModulationMatrixParameters * const modulationMatrixParameters);
+void SynthesiserSetVco2(const Vco2Parameters * const vco2Parameters);
+void SynthesiserSetWavetablePosition(const float position);
+void SynthesiserSetUnison(const UnisonParameters * const unisonParameters);
+bool SynthesiserSetPitch(const PitchParameters * const pitchParameters);
+void SynthesiserGetPitch(PitchParameters * const pitchParameters);
 
 #endif
 
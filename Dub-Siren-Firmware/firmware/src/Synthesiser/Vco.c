@@ -0,0 +1,293 @@
+/**
+ * @file Vco.c
+ * @author Seb Madgwick
+ * @brief Two VCOs with mix, frequency modulation, hard sync and ring
+ * modulation.
+ *
+ * Both VCOs use the bandwidth-limited waveforms.  For frequency modulation,
+ * the waveform of VCO 1 is selected for the instantaneous frequency so that
+ * aliasing remains limited while modulated.  The frequency modulation is
+ * linear and through-zero: the VCO 1 period clock runs backwards while the
+ * instantaneous frequency is negative so that the pitch remains stable for
+ * large modulation indexes.
+ *
+ * For hard sync, VCO 2 is reset each time the VCO 1 period elapses.  The
+ * discontinuity of the reset is band-limited with a two-sample polynomial
+ * BLEP.  The reset may be found within the sample and so the VCO 2 output is
+ * delayed by one sample so that the correction can be applied to the sample
+ * before the reset.
+ *
+ * In unison, VCO 1 is a stack of voices detuned symmetrically across the
+ * spread.  The phase, frequency ratio and gain of each voice are stored as
+ * separate arrays and all voices are rendered in one loop.  The waveform of
+ * each voice is selected for the VCO 1 frequency because the bandwidth-limited
+ * waveforms are limited well below the Nyquist frequency.  Unison applies to
+ * the mix and ring modulations only.  One-bit noise is not stacked.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Dac/Dac.h" // SAMPLE_FREQUENCY
+#include "FastMath/FastMath.h"
+#include <math.h> // fabsf, sqrtf
+#include "MathHelpers.h"
+#include "Vco.h"
+#include "Waveforms.h"
+#include "Wavetable.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Seed of the unison phase randomisation.
+ */
+#define UNISON_RANDOM_SEED (0x6A09E667)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static inline __attribute__((always_inline)) float GetWaveform(const VcoWaveform waveform, const float periodClock, const float frequency, const float pulseWidthOffset, const float wavetablePosition);
+static inline __attribute__((always_inline)) float AdvancePeriodClock(float * const periodClock, const float frequency);
+static inline __attribute__((always_inline)) float UpdateVco1(Vco * const vco, const VcoWaveform waveform, const float frequency, const float pulseWidthOffset, const float wavetablePosition);
+static float UpdateUnison(Vco * const vco, const VcoWaveform waveform, const float frequency, const float pulseWidthOffset, const float wavetablePosition);
+static float UpdateSync(Vco * const vco, const float frequency, const float wavetablePosition);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises VCO structure with the default VCO 2 and unison
+ * parameters.
+ * @param vco VCO structure.
+ */
+void VcoInitialise(Vco * const vco) {
+    VcoSetVco2Parameters(vco, &defaultVco2Parameters);
+    VcoSetUnisonParameters(vco, &defaultUnisonParameters);
+    vco->periodClocks[0] = 0.0f;
+    vco->periodClocks[1] = 0.0f;
+    RandomInitialise(&vco->random, UNISON_RANDOM_SEED);
+    VcoTrigger(vco);
+}
+
+/**
+ * @brief Sets VCO 2 parameters.
+ * @param vco VCO structure.
+ * @param vco2Parameters VCO 2 parameters.
+ */
+void VcoSetVco2Parameters(Vco * const vco, const Vco2Parameters * const vco2Parameters) {
+    vco->vco2Parameters = *vco2Parameters;
+    vco->syncSample = 0.0f;
+}
+
+/**
+ * @brief Sets unison parameters.  The voices are detuned linearly in cents
+ * between plus and minus the spread.  The gains are normalised so that the
+ * power of the stack is independent of the number of voices.
+ * @param vco VCO structure.
+ * @param unisonParameters Unison parameters.
+ */
+void VcoSetUnisonParameters(Vco * const vco, const UnisonParameters * const unisonParameters) {
+    const unsigned int numberOfVoices = CLAMP(unisonParameters->numberOfVoices, 1, UNISON_MAXIMUM_NUMBER_OF_VOICES);
+    const float mix = CLAMP(unisonParameters->mix, 0.0f, 1.0f);
+    float power = 0.0f;
+    unsigned int voice;
+    for (voice = 0; voice < numberOfVoices; voice++) {
+        const float detune = numberOfVoices == 1 ? 0.0f : unisonParameters->spread * (((2.0f * (float) voice) / (float) (numberOfVoices - 1)) - 1.0f);
+        vco->unisonRatios[voice] = FastMathExp2(detune * (1.0f / 1200.0f));
+        const bool centre = (2 * voice == (numberOfVoices - 1)) || (2 * voice == numberOfVoices) || (2 * (voice + 1) == numberOfVoices); // middle voice or middle pair of voices
+        vco->unisonGains[voice] = centre ? 1.0f : mix;
+        power += vco->unisonGains[voice] * vco->unisonGains[voice];
+    }
+    const float normalisation = 1.0f / sqrtf(power);
+    for (voice = 0; voice < numberOfVoices; voice++) {
+        vco->unisonGains[voice] *= normalisation;
+    }
+    vco->numberOfUnisonVoices = numberOfVoices;
+}
+
+/**
+ * @brief Randomises the phase of each unison voice so that the stack does not
+ * start with the same phase relationship on every trigger.
+ * @param vco VCO structure.
+ */
+void VcoTrigger(Vco * const vco) {
+    unsigned int voice;
+    for (voice = 0; voice < UNISON_MAXIMUM_NUMBER_OF_VOICES; voice++) {
+        vco->unisonPeriodClocks[voice] = 0.5f * (RandomNextFloat(&vco->random) + 1.0f);
+    }
+}
+
+/**
+ * @brief Returns VCO waveform amplitude.
+ * @param waveform Waveform.
+ * @param periodClock Normalised period.
+ * @param frequency Frequency in Hz.  Must not be negative.
+ * @param pulseWidthOffset Pulse width offset.  See
+ * WaveformsBandwidthLimitedVariablePulse.
+ * @param wavetablePosition Wavetable position.  See WavetableGetAmplitude.
+ * @return Waveform amplitude.
+ */
+static inline __attribute__((always_inline)) float GetWaveform(const VcoWaveform waveform, const float periodClock, const float frequency, const float pulseWidthOffset, const float wavetablePosition) {
+    switch (waveform) {
+        case VcoWaveformSine:
+            return WaveformsSine(periodClock);
+        case VcoWaveformTriangle:
+            return WaveformsBandwidthLimitedTriangle(periodClock, frequency);
+        case VcoWaveformSawtooth:
+            return WaveformsBandwidthLimitedSawtooth(periodClock, frequency);
+        case VcoWaveformSquare:
+            return WaveformsBandwidthLimitedSquare(periodClock, frequency);
+        case VcoWaveformPulse:
+            if (pulseWidthOffset != 0.0f) {
+                return WaveformsBandwidthLimitedVariablePulse(periodClock, frequency, pulseWidthOffset);
+            }
+            return WaveformsBandwidthLimitedPulse(periodClock, frequency);
+        case VcoWaveformOneBitNoise:
+            return WaveformsOneBitNoise(frequency, SAMPLE_FREQUENCY);
+        case VcoWaveformWavetable:
+#ifdef WAVETABLE_ENABLED
+            return WavetableGetAmplitude(periodClock, frequency, wavetablePosition);
+#else
+            return WaveformsSine(periodClock);
+#endif
+        case VcoWaveformNumberOfWaveforms:
+            break;
+    }
+    return 0.0f;
+}
+
+/**
+ * @brief Advances a period clock by one sample.
+ * @param periodClock Normalised period.
+ * @param frequency Frequency in Hz.  May be negative.
+ * @return Normalised period before the increment.
+ */
+static inline __attribute__((always_inline)) float AdvancePeriodClock(float * const periodClock, const float frequency) {
+    const float previousPeriodClock = *periodClock;
+    *periodClock = WaveformsLimitNormalisedPeriod(previousPeriodClock + (1.0f / SAMPLE_FREQUENCY) * frequency);
+    return previousPeriodClock;
+}
+
+/**
+ * @brief Updates the VCOs for one sample.
+ * @param vco VCO structure.
+ * @param waveform VCO 1 waveform.
+ * @param frequency VCO 1 frequency in Hz.
+ * @param pulseWidthOffset Pulse width offset of VCO 1.  See
+ * WaveformsBandwidthLimitedVariablePulse.
+ * @param wavetablePosition Wavetable position of both VCOs.  See
+ * WavetableGetAmplitude.
+ * @return Output.
+ */
+float VcoUpdate(Vco * const vco, const VcoWaveform waveform, const float frequency, const float pulseWidthOffset, const float wavetablePosition) {
+    const Vco2Parameters * const vco2Parameters = &vco->vco2Parameters;
+    const float vco2Frequency = frequency * vco2Parameters->ratio;
+    switch (vco2Parameters->modulation) {
+        case VcoModulationMix:
+        {
+            const float vco1 = UpdateVco1(vco, waveform, frequency, pulseWidthOffset, wavetablePosition);
+            if (vco2Parameters->amount == 0.0f) {
+                return vco1;
+            }
+            const float vco2 = GetWaveform(vco2Parameters->waveform, AdvancePeriodClock(&vco->periodClocks[1], vco2Frequency), vco2Frequency, 0.0f, wavetablePosition);
+            return vco1 + vco2Parameters->amount * (vco2 - vco1);
+        }
+        case VcoModulationFrequency:
+        {
+            const float modulator = GetWaveform(vco2Parameters->waveform, AdvancePeriodClock(&vco->periodClocks[1], vco2Frequency), vco2Frequency, 0.0f, wavetablePosition);
+            const float instantaneousFrequency = frequency * (1.0f + vco2Parameters->amount * modulator);
+            return GetWaveform(waveform, AdvancePeriodClock(&vco->periodClocks[0], instantaneousFrequency), fabsf(instantaneousFrequency), pulseWidthOffset, wavetablePosition);
+        }
+        case VcoModulationSync:
+            return UpdateSync(vco, frequency, wavetablePosition);
+        case VcoModulationRing:
+        {
+            const float vco1 = UpdateVco1(vco, waveform, frequency, pulseWidthOffset, wavetablePosition);
+            const float vco2 = GetWaveform(vco2Parameters->waveform, AdvancePeriodClock(&vco->periodClocks[1], vco2Frequency), vco2Frequency, 0.0f, wavetablePosition);
+            return vco1 + vco2Parameters->amount * (vco1 * vco2 - vco1);
+        }
+        case VcoModulationNumberOfModulations:
+            break;
+    }
+    return 0.0f;
+}
+
+/**
+ * @brief Updates VCO 1 for one sample, in unison if enabled.
+ * @param vco VCO structure.
+ * @param waveform Waveform.
+ * @param frequency Frequency in Hz.
+ * @param pulseWidthOffset Pulse width offset.  See
+ * WaveformsBandwidthLimitedVariablePulse.
+ * @param wavetablePosition Wavetable position.  See WavetableGetAmplitude.
+ * @return VCO 1 output.
+ */
+static inline __attribute__((always_inline)) float UpdateVco1(Vco * const vco, const VcoWaveform waveform, const float frequency, const float pulseWidthOffset, const float wavetablePosition) {
+    if ((vco->numberOfUnisonVoices > 1) && (waveform != VcoWaveformOneBitNoise)) {
+        return UpdateUnison(vco, waveform, frequency, pulseWidthOffset, wavetablePosition);
+    }
+    return GetWaveform(waveform, AdvancePeriodClock(&vco->periodClocks[0], frequency), frequency, pulseWidthOffset, wavetablePosition);
+}
+
+/**
+ * @brief Updates the unison voices for one sample.
+ * @param vco VCO structure.
+ * @param waveform Waveform.
+ * @param frequency Frequency in Hz of the undetuned voice.
+ * @param pulseWidthOffset Pulse width offset.  See
+ * WaveformsBandwidthLimitedVariablePulse.
+ * @param wavetablePosition Wavetable position.  See WavetableGetAmplitude.
+ * @return Sum of the voices.
+ */
+static float UpdateUnison(Vco * const vco, const VcoWaveform waveform, const float frequency, const float pulseWidthOffset, const float wavetablePosition) {
+    const float increment = (1.0f / SAMPLE_FREQUENCY) * frequency;
+    float sum = 0.0f;
+    unsigned int voice;
+    for (voice = 0; voice < vco->numberOfUnisonVoices; voice++) {
+        const float periodClock = vco->unisonPeriodClocks[voice];
+        sum += vco->unisonGains[voice] * GetWaveform(waveform, periodClock, frequency, pulseWidthOffset, wavetablePosition);
+        vco->unisonPeriodClocks[voice] = WaveformsLimitNormalisedPeriod(periodClock + increment * vco->unisonRatios[voice]);
+    }
+    return sum;
+}
+
+/**
+ * @brief Updates VCO 2 hard synced to VCO 1 for one sample.
+ * @param vco VCO structure.
+ * @param frequency VCO 1 frequency in Hz.
+ * @param wavetablePosition Wavetable position.  See WavetableGetAmplitude.
+ * @return VCO 2 output delayed by one sample.
+ */
+static float UpdateSync(Vco * const vco, const float frequency, const float wavetablePosition) {
+    const VcoWaveform waveform = vco->vco2Parameters.waveform;
+    const float vco2Frequency = frequency * vco->vco2Parameters.ratio;
+    const float increment = (1.0f / SAMPLE_FREQUENCY) * frequency;
+    const float vco2Increment = (1.0f / SAMPLE_FREQUENCY) * vco2Frequency;
+    float output = vco->syncSample;
+
+    // Advance VCO 1
+    vco->periodClocks[0] += increment;
+    if ((vco->periodClocks[0] < 1.0f) || (increment <= 0.0f)) {
+        vco->periodClocks[0] = WaveformsLimitNormalisedPeriod(vco->periodClocks[0]);
+        vco->periodClocks[1] = WaveformsLimitNormalisedPeriod(vco->periodClocks[1] + vco2Increment);
+        vco->syncSample = GetWaveform(waveform, vco->periodClocks[1], vco2Frequency, 0.0f, wavetablePosition);
+        return output;
+    }
+
+    // Reset VCO 2 at fraction of sample since VCO 1 period elapsed
+    vco->periodClocks[0] -= 1.0f;
+    const float fraction = vco->periodClocks[0] / increment; // 0.0 to 1.0
+    const float resetPeriodClock = WaveformsLimitNormalisedPeriod(vco->periodClocks[1] + (1.0f - fraction) * vco2Increment);
+    const float step = GetWaveform(waveform, 0.0f, vco2Frequency, 0.0f, wavetablePosition) - GetWaveform(waveform, resetPeriodClock, vco2Frequency, 0.0f, wavetablePosition);
+    vco->periodClocks[1] = WaveformsLimitNormalisedPeriod(fraction * vco2Increment);
+
+    // Apply polynomial BLEP to samples before and after the reset
+    output += step * 0.5f * fraction * fraction;
+    const float oneMinusFraction = 1.0f - fraction;
+    vco->syncSample = GetWaveform(waveform, vco->periodClocks[1], vco2Frequency, 0.0f, wavetablePosition) - step * 0.5f * oneMinusFraction * oneMinusFraction;
+    return output;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,47 @@
+/**
+ * @file Vco.h
+ * @author Seb Madgwick
+ * @brief Two VCOs with mix, frequency modulation, hard sync and ring
+ * modulation.
+ */
+
+#ifndef VCO_H
+#define VCO_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Random/Random.h"
+#include "Synthesiser.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief VCO structure.  Structure members are used internally and should not
+ * be used by the user application.
+ */
+typedef struct {
+    Vco2Parameters vco2Parameters;
+    float periodClocks[2]; // normalised period of VCO 1 and VCO 2
+    float syncSample; // VCO 2 sample delayed by one sample for the band-limited sync reset
+    unsigned int numberOfUnisonVoices;
+    float unisonPeriodClocks[UNISON_MAXIMUM_NUMBER_OF_VOICES];
+    float unisonRatios[UNISON_MAXIMUM_NUMBER_OF_VOICES]; // frequency as a ratio of the VCO 1 frequency
+    float unisonGains[UNISON_MAXIMUM_NUMBER_OF_VOICES];
+    Random random;
+} Vco;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void VcoInitialise(Vco * const vco);
+void VcoSetVco2Parameters(Vco * const vco, const Vco2Parameters * const vco2Parameters);
+void VcoSetUnisonParameters(Vco * const vco, const UnisonParameters * const unisonParameters);
+void VcoTrigger(Vco * const vco);
+float VcoUpdate(Vco * const vco, const VcoWaveform waveform, const float frequency, const float pulseWidthOffset, const float wavetablePosition);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -7,7 +7,6 @@
 //------------------------------------------------------------------------------
 // Includes
 
-#include <math.h> // ceilf, floorf
 #include "MathHelpers.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -19,9 +18,24 @@
 
 static inline __attribute__((always_inline)) float InterpolateWaveformTable(const float* const waveformTable, const float normalisedPeriod);
 
+//------------------------------------------------------------------------------
+// Variables
+
+static bool interpolationEnabled = true;
+
 //------------------------------------------------------------------------------
 // Functions
 
+/**
+ * @breif Enables or disables linear interpolation of waveform tables.  If
+ * disabled then the nearest table value is used, which requires less
+ * processing at the cost of increased distortion.
+ * @param enabled True to enable interpolation.
+ */
+void WaveformsSetInterpolation(const bool enabled) {
+    interpolationEnabled = enabled;
+}
+
 /**
  * @breif Wraps-around normalised period to limit range to 0.0 to 1.0.
  * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
@@ -45,14 +59,13 @@ float WaveformsLimitNormalisedPeriod(float normalisedPeriod) {
  */
 static inline __attribute__((always_inline)) float InterpolateWaveformTable(const float* const waveformTable, const float normalisedPeriod) {
     const float index = (normalisedPeriod * (float) (WAVEFORM_TABLE_LENGTH - 1));
-    const float indexFloor = floor(index);
-    const float indexCeil = ceil(index);
-    if (indexFloor == indexCeil) {
-        return waveformTable[(unsigned int) index];
+    if (interpolationEnabled == false) {
+        return waveformTable[(unsigned int) (index + 0.5f)];
     }
-    const float amplitudeFloor = waveformTable[(unsigned int) indexFloor];
-    const float amplitudeCeil = waveformTable[(unsigned int) indexCeil];
-    return MAP(index, indexFloor, indexCeil, amplitudeFloor, amplitudeCeil);
+    const unsigned int indexFloor = MIN((unsigned int) index, WAVEFORM_TABLE_LENGTH - 2); // truncation is floor because index is not negative
+    const float fraction = index - (float) indexFloor; // 1.0 for last index
+    const float amplitudeFloor = waveformTable[indexFloor];
+    return amplitudeFloor + fraction * (waveformTable[indexFloor + 1] - amplitudeFloor);
 }
 
 /**
@@ -171,6 +184,24 @@ float WaveformsBandwidthLimitedPulse(const float normalisedPeriod, const float f
     return InterpolateWaveformTable(pulseTable[wavefromIndex], normalisedPeriod);
 }
 
+/**
+ * @breif Returns bandwidth-limited pulse wave amplitude for a normalised period
+ * with a variable duty cycle.  The pulse is the difference of two
+ * bandwidth-limited sawtooth waves offset by the duty cycle, so this requires
+ * twice the processing of WaveformsBandwidthLimitedPulse.
+ * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
+ * @param frequency Frequency of pulse wave.
+ * @param dutyCycleOffset Offset added to the duty cycle of
+ * WaveformsBandwidthLimitedPulse.  0.0 to 1.0 corresponding to 0% to 100%.
+ * @return Pulse wave amplitude.
+ */
+float WaveformsBandwidthLimitedVariablePulse(const float normalisedPeriod, const float frequency, const float dutyCycleOffset) {
+    const float dutyCycle = CLAMP((2.0f * HALF_PULSE_DUTY_CYCLE) + dutyCycleOffset, 0.01f, 0.99f);
+    const float leading = WaveformsLimitNormalisedPeriod(normalisedPeriod + 0.5f * dutyCycle);
+    const float trailing = WaveformsLimitNormalisedPeriod(normalisedPeriod - 0.5f * dutyCycle);
+    return WaveformsBandwidthLimitedSawtooth(leading, frequency) - WaveformsBandwidthLimitedSawtooth(trailing, frequency) + (2.0f * dutyCycle) - 1.0f;
+}
+
 /**
  * @breif Returns one-bit noise amplitude of a specified frequency.  Random bit
  * generated using a linear-feedback shift register.
@@ -204,90 +235,5 @@ float WaveformsOneBitNoise(const float frequency, const float sampleFrequency) {
     return returnValue;
 }
 
-/**
- * @breif Returns asymmetric sine wave amplitude for a normalised period.
- * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
- * @param shape 0.0 to 1.0 adjusts adjusts symmetry.  A value of 0.5 results in
- * a symmetric sine wave.
- * @return Asymmetric sine wave amplitude.
- */
-float WaveformsAsymmetricSine(const float normalisedPeriod, const float shape) {
-    float skewedNormalisedPeriod;
-    if (normalisedPeriod < shape) {
-        skewedNormalisedPeriod = MAP(normalisedPeriod, 0.0f, shape, 0.0f, 0.5f);
-    } else {
-        skewedNormalisedPeriod = MAP(normalisedPeriod, shape, 1.0f, 0.5f, 01.0f);
-    }
-    return InterpolateWaveformTable(sineTable, WaveformsLimitNormalisedPeriod(skewedNormalisedPeriod - 0.25f));
-}
-
-/**
- * @breif Returns triangle wave amplitude for a normalised period.
- * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
- * @param shape 0.0 to 1.0 skews the triangle wave between a negative sawtooth
- * and positive sawtooth.  A value of 0.5 results in a triangle wave.
- * @return Triangle wave amplitude.
- */
-float WaveformsTriangle(const float normalisedPeriod, const float shape) {
-    if (normalisedPeriod < shape) {
-        return MAP(normalisedPeriod, 0.0f, shape, -1.0f, 1.0f);
-    } else {
-        return MAP(normalisedPeriod, shape, 1.0f, 1.0f, -1.0f);
-    }
-}
-
-/**
- * @breif Returns sawtooth wave amplitude for a normalised period.
- * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
- * @param shape 0.0 to 1.0 adjusts adjusts the gradient from linear to
- * exponential.
- * @return Sawtooth wave amplitude.
- */
-float WaveformsSawtooth(const float normalisedPeriod, const float shape) {
-    const float normalisedWaveform = CLAMP((1.0f + shape * shape * 10.0f) * normalisedPeriod, 0.0f, 1.0f);
-    return 2.0f * (normalisedWaveform - 0.5f);
-}
-
-/**
- * @breif Returns square wave amplitude for a normalised period.
- * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
- * @param shape 0.0 to 1.0 adjusts duty cycle from 0% to 100%.  A value of 0.5
- * results in a square wave.
- * @return Square wave amplitude.
- */
-float WaveformsSquare(const float normalisedPeriod, const float shape) {
-    return normalisedPeriod < shape ? -1.0f : 1.0f;
-}
-
-/**
- * @breif Returns stepped triangle wave amplitude for a normalised period.
- * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
- * @param shape 0.0 to 1.0 adjusts the number of steps between 3 and 32.
- * @return Stepped triangle amplitude.
- */
-float WaveformsSteppedTriangle(const float normalisedPeriod, const float shape) {
-    const unsigned int numberOfSteps = 3 + ROUND(shape * 29.0f);
-    const float numberOfStepsMinusOne = (float) (numberOfSteps - 1);
-    float normalisedWaveform;
-    if (normalisedPeriod > 0.5f) {
-        normalisedWaveform = floorf((2.0f * normalisedPeriod - 1.0f) * numberOfStepsMinusOne) * (1.0f / numberOfStepsMinusOne);
-    } else {
-        normalisedWaveform = ceilf((-2.0f * normalisedPeriod + 1.0f) * numberOfStepsMinusOne) * (1.0f / numberOfStepsMinusOne);
-    }
-    return -2.0f * (normalisedWaveform - 0.5f);
-}
-
-/**
- * @breif Returns stepped sawtooth wave amplitude for a normalised period.
- * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
- * @param shape 0.0 to 1.0 adjusts the number of steps between 3 and 32.
- * @return Stepped sawtooth amplitude.
- */
-float WaveformsSteppedSawtooth(const float normalisedPeriod, const float shape) {
-    const unsigned int numberOfSteps = 3 + ROUND(shape * 29.0f);
-    const float normalisedWaveform = floorf(normalisedPeriod * numberOfSteps) * (1.0f / (numberOfSteps - 1.0f));
-    return 2.0f * (normalisedWaveform - 0.5f);
-}
-
 //------------------------------------------------------------------------------
 // End of file
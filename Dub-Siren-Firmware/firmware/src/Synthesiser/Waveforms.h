@@ -7,22 +7,23 @@
 #ifndef WAVEFORMS_H
 #define WAVEFORMS_H
 
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+
 //------------------------------------------------------------------------------
 // Function prototypes
 
+void WaveformsSetInterpolation(const bool enabled);
 float WaveformsLimitNormalisedPeriod(float normalisedPeriod);
 float WaveformsSine(const float normalisedPeriod);
 float WaveformsBandwidthLimitedTriangle(const float normalisedPeriod, const float frequency);
 float WaveformsBandwidthLimitedSawtooth(const float normalisedPeriod, const float frequency);
 float WaveformsBandwidthLimitedSquare(const float normalisedPeriod, const float frequency);
 float WaveformsBandwidthLimitedPulse(const float normalisedPeriod, const float frequency);
+float WaveformsBandwidthLimitedVariablePulse(const float normalisedPeriod, const float frequency, const float dutyCycleOffset);
 float WaveformsOneBitNoise(const float frequency, const float sampleFrequency);
-float WaveformsAsymmetricSine(const float normalisedPeriod, const float shape);
-float WaveformsTriangle(const float normalisedPeriod, const float shape);
-float WaveformsSawtooth(const float normalisedPeriod, const float shape);
-float WaveformsSquare(const float normalisedPeriod, const float shape);
-float WaveformsSteppedTriangle(const float normalisedPeriod, const float shape);
-float WaveformsSteppedSawtooth(const float normalisedPeriod, const float shape);
 
 #endif
 
@@ -0,0 +1,326 @@
+/**
+ * @file Wavetable.c
+ * @author Seb Madgwick
+ * @brief Morphing wavetable oscillator with a RAM table bank.
+ *
+ * Each table is stored as WAVETABLE_NUMBER_OF_LEVELS bandwidth-limited levels.
+ * The levels are synthesised from the harmonics of the table when it is loaded
+ * so that the waveform at each level is free of aliasing up to the maximum
+ * harmonic frequency.  The bank is arranged by level so that the same level of
+ * adjacent tables is contiguous.  Each sample interpolates within and between
+ * two adjacent tables of one level and so touches 2 * (WAVETABLE_LENGTH + 1)
+ * consecutive floats.
+ *
+ * Loading a table requires a discrete Fourier transform and the synthesis of
+ * each level.  This is done by the caller of WavetableLoadSample as each table
+ * is completed.  The oscillator is a sine wave while tables are being loaded.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <math.h> // M_PI, sinf
+#include "MathHelpers.h"
+#include <stdbool.h>
+#include "Waveforms.h"
+#include "Wavetable.h"
+
+#ifdef WAVETABLE_ENABLED
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum harmonic frequency in Hz.  Equal to MAXIMUM_FREQUENCY of
+ * WaveformTables.h.
+ */
+#define MAXIMUM_HARMONIC_FREQUENCY (20000.0f)
+
+/**
+ * @brief Number of harmonics of the first level.
+ */
+#define MAXIMUM_NUMBER_OF_HARMONICS (WAVETABLE_LENGTH / 2)
+
+/**
+ * @brief Duty cycle of the default pulse table.
+ */
+#define DEFAULT_PULSE_DUTY_CYCLE (0.25f)
+
+/**
+ * @brief Default table.  The default bank morphs through the tables in this
+ * order.
+ */
+typedef enum {
+    DefaultTableSine,
+    DefaultTableTriangle,
+    DefaultTableSawtooth,
+    DefaultTableSquare,
+    DefaultTablePulse,
+    DefaultTableNumberOfTables,
+} DefaultTable;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void AnalyseLoadBuffer();
+static void BuildTable(const unsigned int table);
+static inline __attribute__((always_inline)) unsigned int GetLevel(const float frequency);
+static inline __attribute__((always_inline)) float InterpolateTable(const float* const table, const unsigned int index, const float fraction);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static float bank[WAVETABLE_NUMBER_OF_LEVELS][WAVETABLE_NUMBER_OF_TABLES][WAVETABLE_LENGTH + 1]; // extra sample equal to first sample for interpolation
+static volatile unsigned int numberOfTables;
+static float sineTable[WAVETABLE_LENGTH]; // one period
+static float cosineCoefficients[MAXIMUM_NUMBER_OF_HARMONICS + 1];
+static float sineCoefficients[MAXIMUM_NUMBER_OF_HARMONICS + 1];
+static float loadBuffer[WAVETABLE_LENGTH];
+static bool loading;
+static unsigned int loadNumberOfTables;
+static unsigned int loadIndex;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises module and loads the default tables.  This function
+ * should be called once, on system start up.
+ */
+void WavetableInitialise() {
+    unsigned int index;
+    for (index = 0; index < WAVETABLE_LENGTH; index++) {
+        sineTable[index] = sinf((float) (2.0 * M_PI) * (float) index / (float) WAVETABLE_LENGTH);
+    }
+    WavetableLoadDefault();
+}
+
+/**
+ * @brief Loads the default tables: sine, triangle, sawtooth, square and pulse.
+ * Any load in progress is abandoned.
+ */
+void WavetableLoadDefault() {
+    loading = false;
+    numberOfTables = 0;
+    DefaultTable table;
+    for (table = 0; table < DefaultTableNumberOfTables; table++) {
+        unsigned int harmonic;
+        for (harmonic = 1; harmonic <= MAXIMUM_NUMBER_OF_HARMONICS; harmonic++) {
+            const bool odd = (harmonic % 2) != 0;
+            cosineCoefficients[harmonic] = 0.0f;
+            sineCoefficients[harmonic] = 0.0f;
+            switch (table) {
+                case DefaultTableSine:
+                    sineCoefficients[harmonic] = harmonic == 1 ? 1.0f : 0.0f;
+                    break;
+                case DefaultTableTriangle:
+                    cosineCoefficients[harmonic] = odd ? 1.0f / (float) (harmonic * harmonic) : 0.0f;
+                    break;
+                case DefaultTableSawtooth:
+                    sineCoefficients[harmonic] = 1.0f / (float) harmonic;
+                    break;
+                case DefaultTableSquare:
+                    sineCoefficients[harmonic] = odd ? 1.0f / (float) harmonic : 0.0f;
+                    break;
+                case DefaultTablePulse:
+                    cosineCoefficients[harmonic] = sinf((float) M_PI * (float) harmonic * DEFAULT_PULSE_DUTY_CYCLE) / (float) harmonic;
+                    break;
+                case DefaultTableNumberOfTables:
+                    break;
+            }
+        }
+        BuildTable(table);
+    }
+    numberOfTables = DefaultTableNumberOfTables;
+}
+
+/**
+ * @brief Begins loading of tables.  The oscillator is a sine wave until
+ * WavetableLoadEnd is called.
+ * @param newNumberOfTables Number of tables.
+ * @return True if successful.
+ */
+bool WavetableLoadBegin(const unsigned int newNumberOfTables) {
+    if ((newNumberOfTables == 0) || (newNumberOfTables > WAVETABLE_NUMBER_OF_TABLES)) {
+        return false;
+    }
+    numberOfTables = 0;
+    loading = true;
+    loadNumberOfTables = newNumberOfTables;
+    loadIndex = 0;
+    return true;
+}
+
+/**
+ * @brief Loads the next sample of the tables.  Each table is WAVETABLE_LENGTH
+ * samples of one period.  The levels of each table are synthesised as the
+ * table is completed.
+ * @param sample Sample.
+ * @return True if successful.
+ */
+bool WavetableLoadSample(const float sample) {
+    if ((loading == false) || (loadIndex >= (loadNumberOfTables * WAVETABLE_LENGTH))) {
+        return false;
+    }
+    loadBuffer[loadIndex % WAVETABLE_LENGTH] = sample;
+    loadIndex++;
+    if ((loadIndex % WAVETABLE_LENGTH) == 0) {
+        AnalyseLoadBuffer();
+        BuildTable((loadIndex / WAVETABLE_LENGTH) - 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Completes loading of the tables.
+ * @return True if successful.  False if the number of samples loaded does not
+ * match the number of tables specified by WavetableLoadBegin, in which case
+ * the default tables are loaded.
+ */
+bool WavetableLoadEnd() {
+    if ((loading == false) || (loadIndex != (loadNumberOfTables * WAVETABLE_LENGTH))) {
+        WavetableLoadDefault();
+        return false;
+    }
+    loading = false;
+    numberOfTables = loadNumberOfTables;
+    return true;
+}
+
+/**
+ * @brief Returns the number of tables in the bank.
+ * @return Number of tables.  0 while tables are being loaded.
+ */
+unsigned int WavetableGetNumberOfTables() {
+    return numberOfTables;
+}
+
+/**
+ * @brief Calculates the harmonics of the load buffer using a discrete Fourier
+ * transform.  The DC component is discarded.
+ */
+static void AnalyseLoadBuffer() {
+    unsigned int harmonic;
+    for (harmonic = 1; harmonic <= MAXIMUM_NUMBER_OF_HARMONICS; harmonic++) {
+        float cosineSum = 0.0f;
+        float sineSum = 0.0f;
+        unsigned int phase = 0;
+        unsigned int index;
+        for (index = 0; index < WAVETABLE_LENGTH; index++) {
+            cosineSum += loadBuffer[index] * sineTable[(phase + (WAVETABLE_LENGTH / 4)) & (WAVETABLE_LENGTH - 1)];
+            sineSum += loadBuffer[index] * sineTable[phase];
+            phase = (phase + harmonic) & (WAVETABLE_LENGTH - 1);
+        }
+        const float scale = (harmonic == MAXIMUM_NUMBER_OF_HARMONICS) ? (1.0f / (float) WAVETABLE_LENGTH) : (2.0f / (float) WAVETABLE_LENGTH);
+        cosineCoefficients[harmonic] = scale * cosineSum;
+        sineCoefficients[harmonic] = scale * sineSum;
+    }
+}
+
+/**
+ * @brief Synthesises each level of a table from the harmonic coefficients.
+ * All levels are normalised by the peak amplitude of the first level.
+ * @param table Table index.
+ */
+static void BuildTable(const unsigned int table) {
+
+    // Synthesise levels
+    unsigned int level;
+    for (level = 0; level < WAVETABLE_NUMBER_OF_LEVELS; level++) {
+        float* const samples = bank[level][table];
+        const unsigned int numberOfHarmonics = MAX(MAXIMUM_NUMBER_OF_HARMONICS >> level, 1);
+        unsigned int index;
+        for (index = 0; index < WAVETABLE_LENGTH; index++) {
+            float sum = 0.0f;
+            unsigned int phase = index;
+            unsigned int harmonic;
+            for (harmonic = 1; harmonic <= numberOfHarmonics; harmonic++) {
+                sum += (cosineCoefficients[harmonic] * sineTable[(phase + (WAVETABLE_LENGTH / 4)) & (WAVETABLE_LENGTH - 1)]) + (sineCoefficients[harmonic] * sineTable[phase]);
+                phase = (phase + index) & (WAVETABLE_LENGTH - 1);
+            }
+            samples[index] = sum;
+        }
+        samples[WAVETABLE_LENGTH] = samples[0];
+    }
+
+    // Normalise
+    float peak = 0.0f;
+    unsigned int index;
+    for (index = 0; index < WAVETABLE_LENGTH; index++) {
+        peak = MAX(peak, fabsf(bank[0][table][index]));
+    }
+    if (peak == 0.0f) {
+        return;
+    }
+    const float gain = 1.0f / peak;
+    for (level = 0; level < WAVETABLE_NUMBER_OF_LEVELS; level++) {
+        for (index = 0; index <= WAVETABLE_LENGTH; index++) {
+            bank[level][table][index] *= gain;
+        }
+    }
+}
+
+/**
+ * @brief Returns the wavetable amplitude for a normalised period.
+ * @param normalisedPeriod 0.0 to 1.0 corresponding to 0 to 2 pi.
+ * @param frequency Frequency in Hz.  Selects the level.
+ * @param position Table position.  0.0 to 1.0 corresponding to the first to
+ * the last table.
+ * @return Wavetable amplitude.
+ */
+float WavetableGetAmplitude(const float normalisedPeriod, const float frequency, const float position) {
+    const unsigned int currentNumberOfTables = numberOfTables;
+    if (currentNumberOfTables == 0) {
+        return WaveformsSine(normalisedPeriod);
+    }
+
+    // Select adjacent tables
+    const float scaledPosition = CLAMP(position, 0.0f, 1.0f) * (float) (currentNumberOfTables - 1);
+    const unsigned int lastFirstTable = currentNumberOfTables > 1 ? currentNumberOfTables - 2 : 0;
+    const unsigned int firstTable = MIN((unsigned int) scaledPosition, lastFirstTable); // truncation is floor because position is not negative
+    const float tableFraction = scaledPosition - (float) firstTable; // 1.0 for last table
+    const float* const table = bank[GetLevel(frequency)][firstTable];
+
+    // Interpolate within and between tables
+    const float index = normalisedPeriod * (float) WAVETABLE_LENGTH;
+    const unsigned int indexFloor = MIN((unsigned int) index, WAVETABLE_LENGTH - 1); // truncation is floor because index is not negative
+    const float indexFraction = index - (float) indexFloor;
+    const float amplitude = InterpolateTable(table, indexFloor, indexFraction);
+    return amplitude + tableFraction * (InterpolateTable(&table[WAVETABLE_LENGTH + 1], indexFloor, indexFraction) - amplitude);
+}
+
+/**
+ * @brief Returns the level with the most harmonics that are all below the
+ * maximum harmonic frequency.
+ * @param frequency Frequency in Hz.
+ * @return Level.
+ */
+static inline __attribute__((always_inline)) unsigned int GetLevel(const float frequency) {
+    if (frequency <= (MAXIMUM_HARMONIC_FREQUENCY / (float) MAXIMUM_NUMBER_OF_HARMONICS)) {
+        return 0;
+    }
+    const unsigned int harmonic = (unsigned int) (MAXIMUM_HARMONIC_FREQUENCY / frequency); // intentionally rounded down
+    if (harmonic == 0) {
+        return WAVETABLE_NUMBER_OF_LEVELS - 1;
+    }
+    const unsigned int harmonicOctave = 31 - __builtin_clz(harmonic);
+    const unsigned int maximumOctave = 31 - __builtin_clz(MAXIMUM_NUMBER_OF_HARMONICS);
+    return MIN(maximumOctave - harmonicOctave, WAVETABLE_NUMBER_OF_LEVELS - 1);
+}
+
+/**
+ * @brief Returns the interpolated table amplitude.
+ * @param table Table.
+ * @param index Index.
+ * @param fraction Fraction between the index and the next index.
+ * @return Interpolated table amplitude.
+ */
+static inline __attribute__((always_inline)) float InterpolateTable(const float* const table, const unsigned int index, const float fraction) {
+    const float amplitudeFloor = table[index];
+    return amplitudeFloor + fraction * (table[index + 1] - amplitudeFloor);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
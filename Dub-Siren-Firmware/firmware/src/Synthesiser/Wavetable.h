@@ -0,0 +1,67 @@
+/**
+ * @file Wavetable.h
+ * @author Seb Madgwick
+ * @brief Morphing wavetable oscillator with a RAM table bank.
+ */
+
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Uncomment this definition to enable the wavetable VCO waveform.  The
+ * synthesiser delay buffer is reduced by WAVETABLE_RAM_SIZE to make room for
+ * the table bank.  VcoWaveformWavetable is a sine wave if not defined.
+ */
+//#define WAVETABLE_ENABLED
+
+/**
+ * @brief Maximum number of tables in the bank.  Must be at least 2.
+ */
+#define WAVETABLE_NUMBER_OF_TABLES (8)
+
+/**
+ * @brief Table length in samples.  Must be a power of two.
+ */
+#define WAVETABLE_LENGTH (256)
+
+/**
+ * @brief Number of bandwidth-limited levels of each table.  The first level
+ * contains all WAVETABLE_LENGTH / 2 harmonics and the number of harmonics is
+ * halved for each subsequent level.
+ */
+#define WAVETABLE_NUMBER_OF_LEVELS (8)
+
+/**
+ * @brief RAM used by the table bank and load buffers in bytes.
+ */
+#ifdef WAVETABLE_ENABLED
+#define WAVETABLE_RAM_SIZE (((WAVETABLE_NUMBER_OF_LEVELS * WAVETABLE_NUMBER_OF_TABLES * (WAVETABLE_LENGTH + 1)) + (3 * WAVETABLE_LENGTH) + 2) * 4)
+#else
+#define WAVETABLE_RAM_SIZE (0)
+#endif
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+#ifdef WAVETABLE_ENABLED
+void WavetableInitialise();
+void WavetableLoadDefault();
+bool WavetableLoadBegin(const unsigned int numberOfTables);
+bool WavetableLoadSample(const float sample);
+bool WavetableLoadEnd();
+unsigned int WavetableGetNumberOfTables();
+float WavetableGetAmplitude(const float normalisedPeriod, const float frequency, const float position);
+#endif
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
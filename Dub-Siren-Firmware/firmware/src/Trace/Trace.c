@@ -0,0 +1,121 @@
+/**
+ * @file Trace.c
+ * @author Seb Madgwick
+ * @brief Event trace log for performance debugging.
+ *
+ * Each event is written to a RAM ring buffer as a fixed-size record with a
+ * 32-bit timer timestamp.  The buffer is dumped over UART 1 in the following
+ * binary format, which is decoded by TraceDecoder.m:
+ *
+ * "TRACE", uint32 number of records, uint32 timer ticks per second, records
+ *
+ * Each record is a uint32 timestamp, uint16 event and uint16 argument.  All
+ * values are little-endian.  Tracing is paused while the dump is in progress.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Trace.h"
+
+#ifdef TRACE_ENABLED
+
+#include "MathHelpers.h"
+#include "Scheduler/Scheduler.h"
+#include <stdbool.h>
+#include "system/int/sys_int.h"
+#include "Timer/Timer.h"
+#include "Uart/Uart1.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Trace buffer index mask.
+ */
+#define TRACE_BUFFER_INDEX_BIT_MASK (TRACE_BUFFER_SIZE - 1)
+
+/**
+ * @brief Trace record structure.
+ */
+typedef struct {
+    uint32_t timestamp;
+    uint16_t event;
+    uint16_t argument;
+} TraceRecord;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void DumpTasks();
+
+//------------------------------------------------------------------------------
+// Variables
+
+static TraceRecord traceBuffer[TRACE_BUFFER_SIZE];
+static volatile unsigned int traceBufferIndex; // free-running
+static volatile bool paused;
+static unsigned int dumpIndex;
+static unsigned int dumpEndIndex;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Writes trace record.  This function should be called using the TRACE
+ * macro.
+ * @param event Event.
+ * @param argument Argument.
+ */
+void TraceWrite(const TraceEvent event, const uint16_t argument) {
+    if (paused == true) {
+        return;
+    }
+    const bool interruptState = SYS_INT_Disable();
+    TraceRecord * const traceRecord = &traceBuffer[traceBufferIndex++ & TRACE_BUFFER_INDEX_BIT_MASK];
+    traceRecord->timestamp = TimerGetTicks32();
+    traceRecord->event = (uint16_t) event;
+    traceRecord->argument = argument;
+    SYS_INT_Restore(interruptState);
+}
+
+/**
+ * @brief Starts dump of the trace buffer over UART 1.  The dump is completed by
+ * a one-shot scheduler task so that other tasks are not blocked.
+ */
+void TraceDump() {
+    if (paused == true) {
+        return; // dump already in progress
+    }
+    paused = true;
+    const uint32_t header[] = {MIN(traceBufferIndex, TRACE_BUFFER_SIZE), TIMER_TICKS_PER_SECOND};
+    if (Uart1IsWriteReady() < (5 + sizeof (header))) {
+        paused = false;
+        return;
+    }
+    Uart1WriteCharArray("TRACE", 5);
+    Uart1WriteCharArray((char*) header, sizeof (header));
+    dumpEndIndex = traceBufferIndex;
+    dumpIndex = dumpEndIndex - header[0];
+    DumpTasks();
+}
+
+/**
+ * @brief Writes as many records as the UART write buffer allows and re-arms
+ * itself until all records have been written.
+ */
+static void DumpTasks() {
+    while ((dumpIndex != dumpEndIndex) && (Uart1IsWriteReady() >= sizeof (TraceRecord))) {
+        Uart1WriteCharArray((char*) &traceBuffer[dumpIndex++ & TRACE_BUFFER_INDEX_BIT_MASK], sizeof (TraceRecord));
+    }
+    if (dumpIndex != dumpEndIndex) {
+        SchedulerAddOneShotTask("TraceDump", &DumpTasks, 10000);
+        return;
+    }
+    paused = false;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
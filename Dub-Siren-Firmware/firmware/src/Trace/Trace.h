@@ -0,0 +1,78 @@
+/**
+ * @file Trace.h
+ * @author Seb Madgwick
+ * @brief Event trace log for performance debugging.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Uncomment this definition to enable tracing.  Trace points and the
+ * trace buffer are compiled out if this is not defined.
+ */
+//#define TRACE_ENABLED
+
+/**
+ * @brief Trace buffer size in number of records.  Must be a 2^n number.
+ */
+#define TRACE_BUFFER_SIZE (1024)
+
+/**
+ * @brief RAM used by the trace buffer in bytes.  Each record is 8 bytes.  The
+ * synthesiser delay buffer is reduced by this amount.
+ */
+#ifdef TRACE_ENABLED
+#define TRACE_RAM_SIZE (TRACE_BUFFER_SIZE * 8)
+#else
+#define TRACE_RAM_SIZE (0)
+#endif
+
+/**
+ * @brief Trace events.  Values must match TraceDecoder.m.
+ */
+typedef enum {
+    TraceEventButtonPressed, // argument is port number << 8 | port bit
+    TraceEventButtonReleased, // argument is port number << 8 | port bit
+    TraceEventPresetLoad, // argument is preset index
+    TraceEventPresetSave, // argument is preset index
+    TraceEventEepromReadStart, // argument is address
+    TraceEventEepromReadEnd, // argument is number of bytes
+    TraceEventEepromWriteStart, // argument is address
+    TraceEventEepromWriteEnd, // argument is number of bytes
+    TraceEventParametersPosted, // argument is least-significant 16 bits of sample count
+    TraceEventParametersApplied, // argument is least-significant 16 bits of sample count
+    TraceEventAudioOverrun, // argument is audio update time in core timer ticks
+    TraceEventUartOverrun, // argument is 1 for a hardware overrun, 0 for a software overrun
+} TraceEvent;
+
+/**
+ * @brief Trace point.  Records an event with a 16-bit argument.  Safe to use
+ * within interrupts.
+ */
+#ifdef TRACE_ENABLED
+#define TRACE(event, argument) TraceWrite((event), (uint16_t) (argument))
+#else
+#define TRACE(event, argument)
+#endif
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+#ifdef TRACE_ENABLED
+void TraceWrite(const TraceEvent event, const uint16_t argument);
+void TraceDump();
+#endif
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,82 @@
+clc;
+close all;
+clear all;
+
+fileName = 'trace.bin'; % raw UART capture of the 'trace' command response
+
+eventNames = { % must match TraceEvent enumeration in Trace.h
+    'ButtonPressed', ...
+    'ButtonReleased', ...
+    'PresetLoad', ...
+    'PresetSave', ...
+    'EepromReadStart', ...
+    'EepromReadEnd', ...
+    'EepromWriteStart', ...
+    'EepromWriteEnd', ...
+    'ParametersPosted', ...
+    'ParametersApplied', ...
+    'AudioOverrun', ...
+    'UartOverrun'};
+
+%% Read file and find dump
+
+fileRead = fopen(fileName, 'r');
+bytes = fread(fileRead, inf, 'uint8=>uint8')';
+fclose(fileRead);
+
+headerIndex = strfind(char(bytes), 'TRACE');
+if isempty(headerIndex)
+    error('Trace dump not found in %s', fileName);
+end
+headerIndex = headerIndex(end) + 5; % use most recent dump
+
+numberOfRecords = double(typecast(bytes(headerIndex:(headerIndex + 3)), 'uint32'));
+ticksPerSecond = double(typecast(bytes((headerIndex + 4):(headerIndex + 7)), 'uint32'));
+recordBytes = bytes((headerIndex + 8):end);
+numberOfRecords = min(numberOfRecords, floor(length(recordBytes) / 8)); % truncated capture
+recordBytes = reshape(recordBytes(1:(8 * numberOfRecords)), 8, numberOfRecords);
+
+%% Decode records
+
+timestamps = double(typecast(reshape(recordBytes(1:4, :), 1, []), 'uint32'));
+events = double(typecast(reshape(recordBytes(5:6, :), 1, []), 'uint16'));
+arguments = double(typecast(reshape(recordBytes(7:8, :), 1, []), 'uint16'));
+
+timestamps = timestamps + cumsum([0, diff(timestamps) < 0]) * 2^32; % unwrap 32-bit timer
+times = (timestamps - timestamps(1)) / ticksPerSecond * 1e6; % microseconds
+
+%% Print timeline
+
+fprintf('%12s %12s  %-18s %s\n', 'Time (us)', 'Delta (us)', 'Event', 'Argument');
+for index = 1:numberOfRecords
+    if index > 1
+        delta = times(index) - times(index - 1);
+    else
+        delta = 0;
+    end
+    if events(index) < length(eventNames)
+        eventName = eventNames{events(index) + 1};
+    else
+        eventName = sprintf('Unknown(%i)', events(index));
+    end
+    switch eventName
+        case {'ButtonPressed', 'ButtonReleased'}
+            argument = sprintf('R%c%i', 'A' + bitshift(arguments(index), -8), bitand(arguments(index), 255));
+        case {'EepromReadStart', 'EepromWriteStart'}
+            argument = sprintf('0x%04X', arguments(index));
+        otherwise
+            argument = sprintf('%i', arguments(index));
+    end
+    fprintf('%12.1f %12.1f  %-18s %s\n', times(index), delta, eventName, argument);
+end
+
+%% Plot timeline
+
+figure;
+hold on;
+stem(times / 1e3, events, 'filled');
+set(gca, 'YTick', 0:(length(eventNames) - 1), 'YTickLabel', eventNames);
+ylim([-1, length(eventNames)]);
+xlabel('Time (ms)');
+title(sprintf('Trace (%i records)', numberOfRecords));
+grid on;
@@ -9,6 +9,7 @@
 
 #include <string.h> // strlen
 #include "system/int/sys_int.h"
+#include "Trace/Trace.h"
 #include "Uart1.h"
 #include <xc.h>
 
@@ -124,6 +125,7 @@ size_t Uart1IsReadReady() {
     if (U1STAbits.OERR == 1) {
         U1STAbits.OERR = 0;
         readBufferOverrun = true;
+        TRACE(TraceEventUartOverrun, 1);
     }
 
     // Return number of bytes
@@ -300,6 +302,7 @@ static inline __attribute__((always_inline)) void RXInterruptTasks() {
         const char byte = U1RXREG;
         if (readBufferInIndex == ((readBufferOutIndex & READ_WRITE_BUFFER_INDEX_BIT_MASK) - 1)) {
             readBufferOverrun = true;
+            TRACE(TraceEventUartOverrun, 0);
         } else {
             readBuffer[readBufferInIndex++ & READ_WRITE_BUFFER_INDEX_BIT_MASK] = byte;
         }
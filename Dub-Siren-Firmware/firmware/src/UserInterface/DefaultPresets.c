@@ -24,6 +24,14 @@ const SynthesiserParameters fogHorn = {
     .delayFeedback = 0.284430,
     .delayFilterType = DelayFilterTypeLowPass,
     .delayFilterFrequency = 6879.085938,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005000,
+        .decay = 0.100000,
+        .sustain = 1.000000,
+        .release = 0.010000,
+    },
 };
 
 const SynthesiserParameters levelUp = {
@@ -38,6 +46,14 @@ const SynthesiserParameters levelUp = {
     .delayFeedback = 0.284444,
     .delayFilterType = DelayFilterTypeLowPass,
     .delayFilterFrequency = 6879.655273,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005000,
+        .decay = 0.100000,
+        .sustain = 1.000000,
+        .release = 0.010000,
+    },
 };
 
 const SynthesiserParameters marioCoin = {
@@ -52,6 +68,14 @@ const SynthesiserParameters marioCoin = {
     .delayFeedback = 0.284503,
     .delayFilterType = DelayFilterTypeLowPass,
     .delayFilterFrequency = 6878.091309,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005000,
+        .decay = 0.100000,
+        .sustain = 1.000000,
+        .release = 0.010000,
+    },
 };
 
 const SynthesiserParameters bombFalling = {
@@ -66,6 +90,14 @@ const SynthesiserParameters bombFalling = {
     .delayFeedback = 0.284415,
     .delayFilterType = DelayFilterTypeLowPass,
     .delayFilterFrequency = 6877.664551,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005000,
+        .decay = 0.100000,
+        .sustain = 1.000000,
+        .release = 0.010000,
+    },
 };
 
 const SynthesiserParameters policeSiren = {
@@ -80,6 +112,14 @@ const SynthesiserParameters policeSiren = {
     .delayFeedback = 0.284545,
     .delayFilterType = DelayFilterTypeLowPass,
     .delayFilterFrequency = 6879.085938,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005000,
+        .decay = 0.100000,
+        .sustain = 1.000000,
+        .release = 0.010000,
+    },
 };
 
 const SynthesiserParameters classicDubSirenLow = {
@@ -94,6 +134,14 @@ const SynthesiserParameters classicDubSirenLow = {
     .delayFeedback = 0.284479,
     .delayFilterType = DelayFilterTypeLowPass,
     .delayFilterFrequency = 6876.527832,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005000,
+        .decay = 0.100000,
+        .sustain = 1.000000,
+        .release = 0.010000,
+    },
 };
 
 const SynthesiserParameters highHat = {
@@ -108,6 +156,14 @@ const SynthesiserParameters highHat = {
     .delayFeedback = 0.284454,
     .delayFilterType = DelayFilterTypeLowPass,
     .delayFilterFrequency = 6874.536133,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005000,
+        .decay = 0.100000,
+        .sustain = 1.000000,
+        .release = 0.010000,
+    },
 };
 
 const SynthesiserParameters classicDubSirenHigh = {
@@ -122,6 +178,14 @@ const SynthesiserParameters classicDubSirenHigh = {
     .delayFeedback = 0.284547,
     .delayFilterType = DelayFilterTypeLowPass,
     .delayFilterFrequency = 6876.810547,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005000,
+        .decay = 0.100000,
+        .sustain = 1.000000,
+        .release = 0.010000,
+    },
 };
 
 const SynthesiserParameters bombExploding = {
@@ -136,6 +200,14 @@ const SynthesiserParameters bombExploding = {
     .delayFeedback = 0.284484,
     .delayFilterType = DelayFilterTypeLowPass,
     .delayFilterFrequency = 6876.667969,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005000,
+        .decay = 0.100000,
+        .sustain = 1.000000,
+        .release = 0.010000,
+    },
 };
 
 const SynthesiserParameters airRaidSiren = {
@@ -150,6 +222,14 @@ const SynthesiserParameters airRaidSiren = {
     .delayFeedback = 0.284405,
     .delayFilterType = DelayFilterTypeLowPass,
     .delayFilterFrequency = 6873.684570,
+    .envelope = {
+        .mode = EnvelopeModeAdsr,
+        .retrigger = EnvelopeRetriggerAnalog,
+        .attack = 0.005000,
+        .decay = 0.100000,
+        .sustain = 1.000000,
+        .release = 0.010000,
+    },
 };
 
 //------------------------------------------------------------------------------
@@ -7,20 +7,26 @@
 //------------------------------------------------------------------------------
 // Includes
 
+#include "Boot/Boot.h"
 #include "DebouncedButton/DebouncedButton.h"
 #include "DefaultPresets.h"
 #include "Eeprom/Eeprom.h"
+#include "EffectsChain/EffectsChain.h"
 #include "I2C/I2cBitBang.h"
 #include "IODefinitions.h"
 #include <math.h> // fabs, copysignf
 #include "MathHelpers.h"
 #include "Potentiometers/Potentiometers.h"
+#include "QualityGovernor/QualityGovernor.h"
 #include <stdbool.h>
+#include <stddef.h> // offsetof
 #include <stdint.h>
 #include <stdio.h> // snprintf
-#include <string.h> // strlen
+#include <string.h> // memcpy, strlen
 #include "Synthesiser/Synthesiser.h"
+#include "Synthesiser/Wavetable.h"
 #include "Timer/Timer.h"
+#include "Trace/Trace.h"
 #include "Uart/Uart1.h"
 #include "UserInterface/UserInterface.h"
 
@@ -32,6 +38,17 @@
  */
 #define NUMBER_OF_PRESET_KEYS (10)
 
+/**
+ * @brief Period in timer ticks that all buttons and keys must be held for a
+ * factory reset.
+ */
+#define FACTORY_RESET_HOLD_PERIOD (3 * (uint64_t) TIMER_TICKS_PER_SECOND)
+
+/**
+ * @brief Half period in timer ticks of LED flashing after a factory reset.
+ */
+#define FACTORY_RESET_FLASH_HALF_PERIOD ((uint64_t) (TIMER_TICKS_PER_SECOND / 20))
+
 /**
  * @brief Minimum VCO frequency in Hz.
  */
@@ -42,16 +59,64 @@
  */
 #define MAXIMUM_VCO_FREQUENCY (5000.0f)
 
+/**
+ * @brief Number of VCO waveforms selectable by the potentiometer.  The wavetable
+ * waveform is excluded if WAVETABLE_ENABLED is not defined because it would be
+ * a second sine wave.
+ */
+#ifdef WAVETABLE_ENABLED
+#define NUMBER_OF_POTENTIOMETER_VCO_WAVEFORMS (VcoWaveformNumberOfWaveforms)
+#else
+#define NUMBER_OF_POTENTIOMETER_VCO_WAVEFORMS (VcoWaveformWavetable)
+#endif
+
+/**
+ * @brief Uncomment this definition to add the sample and hold and smooth random
+ * LFO waveforms to the LFO waveform potentiometer.  The potentiometer then has
+ * 8 positions instead of the 6 etched on the back panel.
+ */
+//#define RANDOM_LFO_POTENTIOMETER_ENABLED
+
+/**
+ * @brief Number of LFO waveforms selectable by the potentiometer.
+ */
+#ifdef RANDOM_LFO_POTENTIOMETER_ENABLED
+#define NUMBER_OF_POTENTIOMETER_LFO_WAVEFORMS (LfoWaveformNumberOfWaveforms)
+#else
+#define NUMBER_OF_POTENTIOMETER_LFO_WAVEFORMS (LfoWaveformSampleAndHold)
+#endif
+
+/**
+ * @brief Uncomment this definition to flash the LFO gate control LED while the
+ * quality governor has reduced the synthesiser quality.
+ */
+//#define SHOW_REDUCED_QUALITY_ON_LED
+
 /**
  * @brief Calculates the cube of a value.
  */
 #define CUBE(value) ((value) * (value) * (value))
 
+/**
+ * @brief EEPROM data version.  This value must be incremented if the layout of
+ * EepromData changes, and a conversion from the previous layout added to
+ * ConvertLegacyPresets.
+ */
+#define EEPROM_DATA_VERSION (1)
+
+/**
+ * @brief Size in bytes of each preset stored by the original firmware.  These
+ * presets are the SynthesiserParameters members that precede the envelope.
+ */
+#define LEGACY_PRESET_SIZE (offsetof(SynthesiserParameters, envelope))
+
 /**
  * @brief Preset data structure.
  */
 typedef struct {
+    uint32_t version;
     SynthesiserParameters presets[NUMBER_OF_PRESET_KEYS];
+    EffectsChainLayout effectsChainLayouts[NUMBER_OF_PRESET_KEYS];
     int32_t checksum;
 } EepromData;
 
@@ -62,16 +127,20 @@ static void WaitHalfClockCycle();
 static void WriteScl(const bool state);
 static bool ReadSda();
 static void WriteSda(const bool state);
-static void LoadPresetsFromEeprom();
+static void VerifyPresetsLoadedFromEeprom();
+static bool IsChecksumValid(const unsigned int checksumOffset);
+static bool ConvertLegacyPresets();
 static void RestoreDefaultPresets();
 static void SavePresetsToFromEeprom();
-static void CheckForFactoryReset();
+static bool CheckForFactoryReset();
 static bool AnyOrAllButtonOrKeyIsHeld(const bool isHeldState);
 static void ReadPotentiometers(SynthesiserParameters * const synthesiserParameters);
 static int InterpretDiscretePotentiometer(const float potentiometer, const unsigned int numberOfValues, const bool omitDeadbands);
 static bool ComparePotentiometers(const float potentiometerA, const float potentiometerB);
 static void PrintSynthesiserParameters(const SynthesiserParameters * const synthesiserParameters);
 static char* DelayFilterTypeToString(DelayFilterType delayFilterType);
+static char* EnvelopeModeToString(EnvelopeMode envelopeMode);
+static char* EnvelopeRetriggerToString(EnvelopeRetrigger envelopeRetrigger);
 static char* LfoWaveformToString(LfoWaveform lfoWaveform);
 static char* VcoWaveformToString(VcoWaveform vcoWaveform);
 
@@ -84,19 +153,25 @@ static DebouncedButton gateButton;
 static DebouncedButton presetKeys[NUMBER_OF_PRESET_KEYS];
 static I2cBitBang i2cBitBang;
 static EepromData eepromData;
+static unsigned int eepromReadIndex = sizeof (EepromData); // no read pending
+static unsigned int eepromWriteIndex = sizeof (EepromData); // no write pending
 static bool ignorePotentiometers;
 static bool undoIgnorePotentiometers;
+static EnvelopeParameters pendingEnvelopeParameters;
+static bool envelopeParametersPending;
 
 //------------------------------------------------------------------------------
 // Functions
 
 /**
  * @brief Initialises module.  This function should be called once, on system
- * start up.
+ * start up.  The ADC warm up and the loading of presets from EEPROM are
+ * completed by UserInterfaceTasks and UserInterfaceEepromTasks so that the
+ * synthesiser is already running on default parameters.
  */
 void UserInterfaceInitialise() {
 
-    // Initialise potentiometers to start continuous background ADC conversions
+    // Initialise potentiometers to start ADC warm up
     PotentiometersInitialise();
 
     // Initialise debounced buttons
@@ -114,10 +189,14 @@ void UserInterfaceInitialise() {
     DebouncedButtonInitialise(&presetKeys[8], &PRESET_KEY_9_PORT, PRESET_KEY_9_PORT_BIT);
     DebouncedButtonInitialise(&presetKeys[9], &PRESET_KEY_10_PORT, PRESET_KEY_10_PORT_BIT);
 
+    // Envelope is not controlled by potentiometers so start with default
+    pendingEnvelopeParameters = defaultSynthesiserParameters.envelope;
+    envelopeParametersPending = true;
+
     // Load presets
     I2CBitBangInitialise(&i2cBitBang, &WaitHalfClockCycle, &WriteScl, &ReadSda, &WriteSda);
     I2CBitBangBusClear(&i2cBitBang);
-    LoadPresetsFromEeprom();
+    eepromReadIndex = 0;
 }
 
 /**
@@ -152,28 +231,70 @@ static void WriteSda(const bool state) {
 }
 
 /**
- * @brief Loads presets from EEPROM.
+ * @brief Verifies presets loaded from EEPROM.  Presets stored in a previous
+ * layout are converted and default presets are loaded if the checksum fails.
  */
-static void LoadPresetsFromEeprom() {
-
-    // Read EEPROM data
-    EepromRead(&i2cBitBang, 0, (char*) &eepromData, sizeof (eepromData));
+static void VerifyPresetsLoadedFromEeprom() {
+    BootSetPhase(BootPhasePresetsLoaded);
 
-    // Verify checksum
-    unsigned int index;
-    for (index = 0; index < sizeof (eepromData.presets); index++) {
-        eepromData.checksum += (int32_t) ((uint8_t*) (&eepromData))[index];
-    }
-    if (eepromData.checksum == 0) {
+    // Verify checksum and version
+    if ((IsChecksumValid(offsetof(EepromData, checksum)) == true) && (eepromData.version == EEPROM_DATA_VERSION)) {
         Uart1WriteStringIfReady("\r\nEEPROM checksum OK\r\n");
         return;
     }
+
+    // Convert presets stored in a previous layout
+    if (ConvertLegacyPresets() == true) {
+        Uart1WriteStringIfReady("\r\nEEPROM presets converted\r\n");
+        return;
+    }
     Uart1WriteStringIfReady("\r\nEEPROM checksum FAILED\r\n");
 
     // Load default presets
     RestoreDefaultPresets();
 }
 
+/**
+ * @brief Returns true if the checksum of the EEPROM data is valid for a layout
+ * with the checksum at the specified offset.  The checksum is the negated sum
+ * of all preceding bytes.
+ * @param checksumOffset Offset of the checksum in bytes.
+ * @return True if the checksum is valid.
+ */
+static bool IsChecksumValid(const unsigned int checksumOffset) {
+    const uint8_t* const data = (const uint8_t*) &eepromData;
+    int32_t checksum;
+    memcpy(&checksum, &data[checksumOffset], sizeof (checksum));
+    unsigned int index;
+    for (index = 0; index < checksumOffset; index++) {
+        checksum += (int32_t) data[index];
+    }
+    return checksum == 0;
+}
+
+/**
+ * @brief Converts presets stored by the original firmware, which preceded
+ * EEPROM_DATA_VERSION.  This layout has no version and so is identified by the
+ * offset of a valid checksum.  The presets have no envelopes and there are no
+ * effects chain layouts so these are replaced with defaults.
+ * @return True if the presets were converted.
+ */
+static bool ConvertLegacyPresets() {
+    if (IsChecksumValid(NUMBER_OF_PRESET_KEYS * LEGACY_PRESET_SIZE) == false) {
+        return false;
+    }
+    uint8_t legacyData[NUMBER_OF_PRESET_KEYS * LEGACY_PRESET_SIZE];
+    memcpy(legacyData, &eepromData, sizeof (legacyData));
+    unsigned int index;
+    for (index = 0; index < NUMBER_OF_PRESET_KEYS; index++) {
+        eepromData.presets[index].envelope = defaultSynthesiserParameters.envelope;
+        memcpy(&eepromData.presets[index], &legacyData[index * LEGACY_PRESET_SIZE], LEGACY_PRESET_SIZE);
+        eepromData.effectsChainLayouts[index] = defaultEffectsChainLayout;
+    }
+    SavePresetsToFromEeprom();
+    return true;
+}
+
 /**
  * @brief Loads default presets.
  */
@@ -188,35 +309,96 @@ static void RestoreDefaultPresets() {
     eepromData.presets[7] = classicDubSirenHigh;
     eepromData.presets[8] = bombExploding;
     eepromData.presets[9] = airRaidSiren;
+    unsigned int index;
+    for (index = 0; index < NUMBER_OF_PRESET_KEYS; index++) {
+        eepromData.effectsChainLayouts[index] = defaultEffectsChainLayout;
+    }
     SavePresetsToFromEeprom();
 }
 
 /**
- * @brief Saves presets to EEPROM.
+ * @brief Saves presets to EEPROM.  The data is written by
+ * UserInterfaceEepromTasks.
  */
 static void SavePresetsToFromEeprom() {
 
     // Calculate checksum
+    eepromData.version = EEPROM_DATA_VERSION;
     eepromData.checksum = 0;
     unsigned int index;
-    for (index = 0; index < sizeof (eepromData.presets); index++) {
+    for (index = 0; index < offsetof(EepromData, checksum); index++) {
         eepromData.checksum -= (int32_t) ((uint8_t*) (&eepromData))[index];
     }
 
-    // Write EEPROM data
-    EepromWrite(&i2cBitBang, 0, (char*) &eepromData, sizeof (eepromData));
+    // Start write from first byte, restarting any write in progress
+    eepromWriteIndex = 0;
 }
 
 /**
- * @brief Do module tasks.  This function should be called repeatedly within the
- * main program loop.
+ * @brief Reads presets from EEPROM one page at a time on start up, then writes
+ * pending preset data to EEPROM one page at a time.  Nothing is written while
+ * the EEPROM is engaged in the write cycle of the previous page.  This function
+ * should be called periodically by the scheduler.
+ */
+void UserInterfaceEepromTasks() {
+    if (eepromReadIndex < sizeof (eepromData)) {
+        const unsigned int numberOfBytes = MIN(EEPROM_PAGE_SIZE, sizeof (eepromData) - eepromReadIndex);
+        EepromRead(&i2cBitBang, eepromReadIndex, &((char*) &eepromData)[eepromReadIndex], numberOfBytes);
+        eepromReadIndex += numberOfBytes;
+        if (eepromReadIndex >= sizeof (eepromData)) {
+            VerifyPresetsLoadedFromEeprom();
+        }
+        return;
+    }
+    if (eepromWriteIndex >= sizeof (eepromData)) {
+        return; // no write pending
+    }
+    if (EepromIsReady(&i2cBitBang) == false) {
+        return; // write cycle in progress
+    }
+    const unsigned int numberOfBytes = MIN(EEPROM_PAGE_SIZE - (eepromWriteIndex % EEPROM_PAGE_SIZE), sizeof (eepromData) - eepromWriteIndex);
+    EepromWrite(&i2cBitBang, eepromWriteIndex, &((char*) &eepromData)[eepromWriteIndex], numberOfBytes);
+    eepromWriteIndex += numberOfBytes;
+}
+
+/**
+ * @brief Sets the envelope parameters.  The envelope is not controlled by the
+ * potentiometers and so is only changed by this function or by loading a
+ * preset.  The parameters are applied by the next call of UserInterfaceTasks.
+ * @param envelopeParameters Envelope parameters.
+ */
+void UserInterfaceSetEnvelopeParameters(const EnvelopeParameters * const envelopeParameters) {
+    pendingEnvelopeParameters = *envelopeParameters;
+    envelopeParametersPending = true;
+}
+
+/**
+ * @brief Do module tasks.  This function should be called periodically by the
+ * scheduler.
  */
 void UserInterfaceTasks() {
     static SynthesiserParameters synthesiserParameters;
     static bool nonPresetLfoGateControl;
+    static bool gateButtonPressed;
+    static bool delayModeSelected;
+
+    // Wait for ADC warm up so that default parameters are not overwritten
+    PotentiometersTasks();
+    if (PotentiometersIsReady() == false) {
+        return;
+    }
+    BootSetPhase(BootPhasePotentiometersReady);
 
     // Factory reset
-    CheckForFactoryReset();
+    if (CheckForFactoryReset() == true) {
+        return;
+    }
+
+    // Envelope parameters
+    if (envelopeParametersPending == true) {
+        envelopeParametersPending = false;
+        synthesiserParameters.envelope = pendingEnvelopeParameters;
+    }
 
     // Trigger button
     bool trigger = false;
@@ -240,26 +422,55 @@ void UserInterfaceTasks() {
 
     // Gate button
     if (DebouncedButtonWasPressed(&gateButton) == true) {
-        SynthesiserSetGate(!SynthesiserGetGate()); // toggle state
+        gateButtonPressed = true;
+        delayModeSelected = false;
     }
 
     // Preset keys
     unsigned int presetKeyIndex;
     for (presetKeyIndex = 0; presetKeyIndex < NUMBER_OF_PRESET_KEYS; presetKeyIndex++) {
         if (DebouncedButtonWasPressed(&presetKeys[presetKeyIndex]) == true) {
+            if (DebouncedButtonIsHeld(&gateButton) == true) { // gate button and preset key selects delay mode
+                delayModeSelected = true;
+                if (presetKeyIndex < DelayModeNumberOfModes) {
+                    SynthesiserSetDelayMode(presetKeyIndex);
+                }
+                break;
+            }
+            if (eepromReadIndex < sizeof (eepromData)) {
+                break; // presets not yet loaded
+            }
             if (DebouncedButtonIsHeld(&triggerSaveButton) == true) {
                 eepromData.presets[presetKeyIndex] = synthesiserParameters;
+                EffectsChainGetLayout(&eepromData.effectsChainLayouts[presetKeyIndex]);
                 SavePresetsToFromEeprom();
+                TRACE(TraceEventPresetSave, presetKeyIndex);
             }
+            TRACE(TraceEventPresetLoad, presetKeyIndex);
             synthesiserParameters = eepromData.presets[presetKeyIndex];
+            EffectsChainSetLayout(&eepromData.effectsChainLayouts[presetKeyIndex]);
             ignorePotentiometers = true;
             trigger = true;
             break;
         }
     }
 
+    // Toggle gate when gate button released unless used to select delay mode
+    if ((gateButtonPressed == true) && (DebouncedButtonIsHeld(&gateButton) == false)) {
+        gateButtonPressed = false;
+        if (delayModeSelected == false) {
+            SynthesiserSetGate(!SynthesiserGetGate()); // toggle state
+        }
+    }
+
     // LFO gate control LED
-    if (synthesiserParameters.lfoGateControl == true) {
+    bool lfoGateControlLed = synthesiserParameters.lfoGateControl;
+#ifdef SHOW_REDUCED_QUALITY_ON_LED
+    if (QualityGovernorGetQuality() != SynthesiserQualityHigh) {
+        lfoGateControlLed = ((TimerGetTicks64() / (TIMER_TICKS_PER_SECOND / 8)) & 1) != 0; // flash at 4 Hz
+    }
+#endif
+    if (lfoGateControlLed == true) {
         LFO_GATE_CONTROL_LED_LAT = 1;
     } else {
         LFO_GATE_CONTROL_LED_LAT = 0;
@@ -275,42 +486,55 @@ void UserInterfaceTasks() {
     // Read potentiometers
     ReadPotentiometers(&synthesiserParameters);
 
-    // Trigger
+    // Update synthesiser parameters and trigger on the same sample
     if (trigger == true) {
-        SynthesiserTrigger();
+        SynthesiserLoadPreset(&synthesiserParameters);
         PrintSynthesiserParameters(&synthesiserParameters);
+    } else {
+        SynthesiserSetParameters(&synthesiserParameters);
     }
-
-    // Update synthesiser parameters
-    SynthesiserSetParameters(&synthesiserParameters);
 }
 
 /**
  * @brief Loads default presets if all buttons and keys held for a 3 seconds.
+ * The LEDs then flash until all buttons and keys are released.
+ * @return True while all buttons and keys are held or the LEDs are flashing.
  */
-static void CheckForFactoryReset() {
-    const uint64_t previousTicks = TimerGetTicks64();
-    do {
-        if (AnyOrAllButtonOrKeyIsHeld(false) == true) {
-            return; // return if any buttons or keys not held
-        }
-        const uint64_t currentTicks = TimerGetTicks64();
-        if ((currentTicks - previousTicks) >= (3 * (uint64_t) TIMER_TICKS_PER_SECOND)) {
-
-            // Load default presets
-            RestoreDefaultPresets();
-
-            // Flash LEDs until all buttons and keys released
-            do {
-                LFO_GATE_CONTROL_LED_LAT = 0;
-                GATE_LED_LAT = 0;
-                TimerDelay(50);
-                LFO_GATE_CONTROL_LED_LAT = 1;
-                GATE_LED_LAT = 1;
-                TimerDelay(50);
-            } while (AnyOrAllButtonOrKeyIsHeld(true) == true);
+static bool CheckForFactoryReset() {
+    static bool allHeld;
+    static uint64_t allHeldTicks;
+    static bool flashing;
+    const uint64_t currentTicks = TimerGetTicks64();
+
+    // Flash LEDs until all buttons and keys released
+    if (flashing == true) {
+        if (AnyOrAllButtonOrKeyIsHeld(true) == false) {
+            flashing = false;
+            return false;
         }
-    } while (true);
+        const bool ledState = ((currentTicks / FACTORY_RESET_FLASH_HALF_PERIOD) & 1) != 0;
+        LFO_GATE_CONTROL_LED_LAT = ledState == true ? 1 : 0;
+        GATE_LED_LAT = ledState == true ? 1 : 0;
+        return true;
+    }
+
+    // Return if any buttons or keys not held
+    if (AnyOrAllButtonOrKeyIsHeld(false) == true) {
+        allHeld = false;
+        return false;
+    }
+    if (allHeld == false) {
+        allHeld = true;
+        allHeldTicks = currentTicks;
+    }
+
+    // Load default presets
+    if ((currentTicks - allHeldTicks) >= FACTORY_RESET_HOLD_PERIOD) {
+        RestoreDefaultPresets();
+        allHeld = false;
+        flashing = true;
+    }
+    return true;
 }
 
 /**
@@ -380,7 +604,7 @@ static void ReadPotentiometers(SynthesiserParameters * const synthesiserParamete
     // LFO waveform
     if (potentiometerIgnored[PotentiometerIndexLfoWaveform] == false) {
         static int validValue = -1; // initial value is invalid to force use of discrete potentiometer value even if in deadband
-        const int currentValue = InterpretDiscretePotentiometer(potentiometers[PotentiometerIndexLfoWaveform], LfoWaveformNumberOfWaveforms, validValue != -1);
+        const int currentValue = InterpretDiscretePotentiometer(potentiometers[PotentiometerIndexLfoWaveform], NUMBER_OF_POTENTIOMETER_LFO_WAVEFORMS, validValue != -1);
         if (currentValue != -1) {
             validValue = currentValue;
         }
@@ -418,7 +642,7 @@ static void ReadPotentiometers(SynthesiserParameters * const synthesiserParamete
     // VCO waveform
     if (potentiometerIgnored[PotentiometerIndexVcoWaveform] == false) {
         static int validValue = -1; // initial value is invalid to force use of discrete potentiometer value even if in deadband
-        const int currentValue = InterpretDiscretePotentiometer(potentiometers[PotentiometerIndexVcoWaveform], VcoWaveformNumberOfWaveforms, validValue != -1);
+        const int currentValue = InterpretDiscretePotentiometer(potentiometers[PotentiometerIndexVcoWaveform], NUMBER_OF_POTENTIOMETER_VCO_WAVEFORMS, validValue != -1);
         if (currentValue != -1) {
             validValue = currentValue;
         }
@@ -495,7 +719,7 @@ static int InterpretDiscretePotentiometer(const float potentiometer, const unsig
  * @param synthesiserParameters Synthesiser parameters to be printed.
  */
 static void PrintSynthesiserParameters(const SynthesiserParameters * const synthesiserParameters) {
-    char string[512];
+    char string[768];
     snprintf(string, sizeof (string),
             "\r\n"
             "TRIGGERED:\r\n"
@@ -510,6 +734,14 @@ static void PrintSynthesiserParameters(const SynthesiserParameters * const synth
             ".delayFeedback          = %f,\r\n"
             ".delayFilterType        = %s,\r\n"
             ".delayFilterFrequency   = %f,\r\n"
+            ".envelope = {\r\n"
+            "    .mode               = %s,\r\n"
+            "    .retrigger          = %s,\r\n"
+            "    .attack             = %f,\r\n"
+            "    .decay              = %f,\r\n"
+            "    .sustain            = %f,\r\n"
+            "    .release            = %f,\r\n"
+            "},\r\n"
             ,
             LfoWaveformToString(synthesiserParameters->lfoWaveform),
             (double) synthesiserParameters->lfoShape,
@@ -521,7 +753,13 @@ static void PrintSynthesiserParameters(const SynthesiserParameters * const synth
             (double) synthesiserParameters->delayTime,
             (double) synthesiserParameters->delayFeedback,
             DelayFilterTypeToString(synthesiserParameters->delayFilterType),
-            (double) synthesiserParameters->delayFilterFrequency
+            (double) synthesiserParameters->delayFilterFrequency,
+            EnvelopeModeToString(synthesiserParameters->envelope.mode),
+            EnvelopeRetriggerToString(synthesiserParameters->envelope.retrigger),
+            (double) synthesiserParameters->envelope.attack,
+            (double) synthesiserParameters->envelope.decay,
+            (double) synthesiserParameters->envelope.sustain,
+            (double) synthesiserParameters->envelope.release
             );
     Uart1WriteStringIfReady(string);
 }
@@ -543,6 +781,10 @@ static char* LfoWaveformToString(LfoWaveform lfoWaveform) {
             return (char *) &"LfoWaveformSteppedTriangle";
         case LfoWaveformSteppedSawtooth:
             return (char *) &"LfoWaveformSteppedSawtooth";
+        case LfoWaveformSampleAndHold:
+            return (char *) &"LfoWaveformSampleAndHold";
+        case LfoWaveformSmoothRandom:
+            return (char *) &"LfoWaveformSmoothRandom";
         case LfoWaveformNumberOfWaveforms:
             break;
     }
@@ -566,6 +808,8 @@ static char* VcoWaveformToString(VcoWaveform vcoWaveform) {
             return (char *) &"VcoWaveformOneBitNoise";
         case VcoWaveformPulse:
             return (char *) &"VcoWaveformPulse";
+        case VcoWaveformWavetable:
+            return (char *) &"VcoWaveformWavetable";
         case VcoWaveformNumberOfWaveforms:
             break;
     }
@@ -587,5 +831,31 @@ static char* DelayFilterTypeToString(DelayFilterType delayFilterType) {
     return (char *) &"Invalid";
 }
 
+/**
+ * @brief Returns envelope mode enumeration string.
+ */
+static char* EnvelopeModeToString(EnvelopeMode envelopeMode) {
+    switch (envelopeMode) {
+        case EnvelopeModeAdsr:
+            return (char *) &"EnvelopeModeAdsr";
+        case EnvelopeModeAd:
+            return (char *) &"EnvelopeModeAd";
+    }
+    return (char *) &"Invalid";
+}
+
+/**
+ * @brief Returns envelope retrigger enumeration string.
+ */
+static char* EnvelopeRetriggerToString(EnvelopeRetrigger envelopeRetrigger) {
+    switch (envelopeRetrigger) {
+        case EnvelopeRetriggerAnalog:
+            return (char *) &"EnvelopeRetriggerAnalog";
+        case EnvelopeRetriggerReset:
+            return (char *) &"EnvelopeRetriggerReset";
+    }
+    return (char *) &"Invalid";
+}
+
 //------------------------------------------------------------------------------
 // End of file
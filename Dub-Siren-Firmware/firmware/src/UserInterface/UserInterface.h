@@ -7,11 +7,18 @@
 #ifndef USER_INTERFACE_H
 #define USER_INTERFACE_H
 
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Synthesiser/Synthesiser.h"
+
 //------------------------------------------------------------------------------
 // Function prototypes
 
 void UserInterfaceInitialise();
 void UserInterfaceTasks();
+void UserInterfaceEepromTasks();
+void UserInterfaceSetEnvelopeParameters(const EnvelopeParameters * const envelopeParameters);
 
 #endif
 
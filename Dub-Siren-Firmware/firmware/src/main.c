@@ -13,10 +13,16 @@
 //------------------------------------------------------------------------------
 // Includes
 
+#include "Benchmark/Benchmark.h"
+#include "Boot/Boot.h"
 #include "FirmwareVersion.h"
+#include "Fpu/Fpu.h"
 #include "IODefinitions.h"
 #include <stdbool.h>
 #include <stddef.h> // NULL
+#include "QualityGovernor/QualityGovernor.h"
+#include "Scheduler/Scheduler.h"
+#include "SerialInterface/SerialInterface.h"
 #include "Synthesiser/Synthesiser.h"
 #include "system/common/sys_module.h" // SYS_Initialize
 #include "Timer/Timer.h"
@@ -28,6 +34,7 @@
 // Function prototypes
 
 static void Initialise();
+static void PrintFirmwareVersion();
 
 //------------------------------------------------------------------------------
 // Functions
@@ -43,20 +50,33 @@ int main() {
     TimerInitialise();
 
     Uart1Initialise(&defaultUartSettings);
+
+    // Run benchmarks before audio interrupts are enabled
+#ifdef BENCHMARK_ENABLED
     TimerDelay(1); // wait else first data may be corrupted
-    Uart1WriteStringIfReady(
-            "\r\n"
-            "FIRMWARE VERSION:\r\n"
-            FIRMWARE_VERSION
-            "\r\n");
+    BenchmarkRun();
+#endif
 
+    // Start audio on default parameters as early as possible
     SynthesiserInitialise();
+    BootSetPhase(BootPhaseAudioStarted);
+
+    QualityGovernorInitialise();
 
     UserInterfaceInitialise();
+    BootSetPhase(BootPhaseUserInterfaceStarted);
+
+    // Add tasks
+    SchedulerAddOneShotTask("FirmwareVersion", &PrintFirmwareVersion, 1000); // delay else first data may be corrupted
+    SchedulerAddOneShotTask("Boot", &BootTasks, 0);
+    SchedulerAddPeriodicTask("UserInterface", &UserInterfaceTasks, 1000);
+    SchedulerAddPeriodicTask("Eeprom", &UserInterfaceEepromTasks, 1000);
+    SchedulerAddPeriodicTask("SerialInterface", &SerialInterfaceTasks, 10000);
+    SchedulerAddPeriodicTask("QualityGovernor", &QualityGovernorTasks, 100000);
 
     // Main program loop
     while (true) {
-        UserInterfaceTasks();
+        SchedulerTasks();
     }
 }
 
@@ -68,6 +88,9 @@ static void Initialise() {
     // Configure system clock and enable interrupts using MPLAB Harmony
     SYS_Initialize(NULL);
 
+    // Flush subnormal floats to zero to avoid slow FPU operations
+    FpuSetFlushToZero(true);
+
     // Disable all analogue inputs
     ANSELB = 0x00000000;
     ANSELE = 0x00000000;
@@ -127,5 +150,16 @@ static void Initialise() {
     UART_CTS_MAP();
 }
 
+/**
+ * @brief Prints firmware version.
+ */
+static void PrintFirmwareVersion() {
+    Uart1WriteStringIfReady(
+            "\r\n"
+            "FIRMWARE VERSION:\r\n"
+            FIRMWARE_VERSION
+            "\r\n");
+}
+
 //------------------------------------------------------------------------------
 // End of file